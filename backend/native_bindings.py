@@ -25,11 +25,15 @@ if _lib_path.exists():
         _lib.is_prime.argtypes = [ctypes.c_int]
         _lib.is_prime.restype = ctypes.c_int
         
+        _lib.is_prime_batch.argtypes = [ctypes.POINTER(ctypes.c_longlong), ctypes.c_size_t,
+                                         ctypes.POINTER(ctypes.c_ubyte)]
+        _lib.is_prime_batch.restype = None
+
         _lib.reverse_string.argtypes = [ctypes.c_char_p]
         _lib.reverse_string.restype = ctypes.c_char_p
         
-        _lib.array_sum.argtypes = [ctypes.POINTER(ctypes.c_int), ctypes.c_int]
-        _lib.array_sum.restype = ctypes.c_longlong
+        _lib.sum_array_long.argtypes = [ctypes.POINTER(ctypes.c_int), ctypes.c_size_t]
+        _lib.sum_array_long.restype = ctypes.c_longlong
     except OSError:
         _lib = None
 
@@ -65,6 +69,19 @@ def is_prime(n: int) -> Optional[bool]:
         return None
 
 
+def is_prime_batch(values: list) -> Optional[list]:
+    """Check a list of numbers for primality in one native call"""
+    if _lib is None:
+        return None
+    try:
+        c_values = (ctypes.c_longlong * len(values))(*values)
+        bitmap = (ctypes.c_ubyte * ((len(values) + 7) // 8))()
+        _lib.is_prime_batch(c_values, len(values), bitmap)
+        return [bool(bitmap[i // 8] >> (i % 8) & 1) for i in range(len(values))]
+    except:
+        return None
+
+
 def reverse_string(s: str) -> Optional[str]:
     """Reverse a string using native C function"""
     if _lib is None:
@@ -85,7 +102,7 @@ def array_sum(arr: list) -> Optional[int]:
     try:
         # Convert Python list to C array
         c_arr = (ctypes.c_int * len(arr))(*arr)
-        return _lib.array_sum(c_arr, len(arr))
+        return _lib.sum_array_long(c_arr, len(arr))
     except:
         return None
 
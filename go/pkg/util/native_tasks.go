@@ -0,0 +1,198 @@
+package util
+
+/*
+#cgo CFLAGS: -I${SRCDIR}/../../../native
+#cgo LDFLAGS: -L${SRCDIR}/../../../native -ltaskprocessor
+#include "task_api.h"
+*/
+import "C"
+import (
+	"errors"
+	"unsafe"
+)
+
+// Status and priority values shared with native/task_processor.h
+const (
+	NativePriorityLow      = 0
+	NativePriorityMedium   = 1
+	NativePriorityHigh     = 2
+	NativePriorityCritical = 3
+
+	NativeStatusPending    = 0
+	NativeStatusInProgress = 1
+	NativeStatusCompleted  = 2
+	NativeStatusFailed     = 3
+
+	// NativeMaskAll accepts every status or priority in Query
+	NativeMaskAll = uint32(C.TASK_MASK_ALL)
+)
+
+// NativeTask holds the fixed-width fields of a native task
+type NativeTask struct {
+	ID          int32
+	Priority    int32
+	Status      int32
+	CreatedAt   int64
+	CompletedAt int64
+}
+
+// NativeTaskProcessor wraps a C++ TaskProcessor through the batch C API in
+// native/task_api.h. Each method makes a single cgo call for the whole
+// batch, so per-call overhead is paid once rather than per task.
+// It is not safe for concurrent use.
+type NativeTaskProcessor struct {
+	handle *C.task_processor_handle
+}
+
+// NewNativeTaskProcessor creates a native processor; call Close to free it
+func NewNativeTaskProcessor() (*NativeTaskProcessor, error) {
+	handle := C.task_processor_create()
+	if handle == nil {
+		return nil, errors.New("native task processor could not be created")
+	}
+	return &NativeTaskProcessor{handle: handle}, nil
+}
+
+// Close releases the native processor
+func (p *NativeTaskProcessor) Close() {
+	if p.handle != nil {
+		C.task_processor_destroy(p.handle)
+		p.handle = nil
+	}
+}
+
+// AddTasks adds one task per title, with the matching description and
+// priority (descriptions may be nil; priorities nil means medium). It
+// returns the new ids, 0 for tasks rejected for an invalid priority.
+func (p *NativeTaskProcessor) AddTasks(titles, descriptions []string, priorities []int32) []int32 {
+	count := len(titles)
+	if count == 0 {
+		return nil
+	}
+	if descriptions != nil && len(descriptions) != count {
+		panic("util: AddTasks descriptions length mismatch")
+	}
+	if priorities != nil && len(priorities) != count {
+		panic("util: AddTasks priorities length mismatch")
+	}
+
+	// Pack every string into one buffer so the call copies no Go pointers
+	total := 0
+	for i := 0; i < count; i++ {
+		total += len(titles[i])
+		if descriptions != nil {
+			total += len(descriptions[i])
+		}
+	}
+	packed := make([]byte, 0, total+1)
+	titleLengths := make([]uint32, count)
+	var descriptionLengths []uint32
+	if descriptions != nil {
+		descriptionLengths = make([]uint32, count)
+	}
+	for i := 0; i < count; i++ {
+		packed = append(packed, titles[i]...)
+		titleLengths[i] = uint32(len(titles[i]))
+		if descriptions != nil {
+			packed = append(packed, descriptions[i]...)
+			descriptionLengths[i] = uint32(len(descriptions[i]))
+		}
+	}
+	packed = append(packed, 0) // keeps &packed[0] valid when every string is empty
+
+	ids := make([]int32, count)
+	var descriptionPtr *C.uint32_t
+	if descriptionLengths != nil {
+		descriptionPtr = (*C.uint32_t)(unsafe.Pointer(&descriptionLengths[0]))
+	}
+	var priorityPtr *C.int32_t
+	if priorities != nil {
+		priorityPtr = (*C.int32_t)(unsafe.Pointer(&priorities[0]))
+	}
+	C.task_processor_add_tasks(p.handle, C.size_t(count),
+		(*C.char)(unsafe.Pointer(&packed[0])),
+		(*C.uint32_t)(unsafe.Pointer(&titleLengths[0])),
+		descriptionPtr, priorityPtr,
+		(*C.int32_t)(unsafe.Pointer(&ids[0])))
+	return ids
+}
+
+// UpdateStatuses sets statuses[i] on ids[i] and returns how many were updated
+func (p *NativeTaskProcessor) UpdateStatuses(ids, statuses []int32) int {
+	if len(ids) != len(statuses) {
+		panic("util: UpdateStatuses length mismatch")
+	}
+	if len(ids) == 0 {
+		return 0
+	}
+	return int(C.task_processor_update_statuses(p.handle,
+		(*C.int32_t)(unsafe.Pointer(&ids[0])),
+		(*C.int32_t)(unsafe.Pointer(&statuses[0])),
+		C.size_t(len(ids))))
+}
+
+// RemoveTasks removes tasks by id and returns how many existed
+func (p *NativeTaskProcessor) RemoveTasks(ids []int32) int {
+	if len(ids) == 0 {
+		return 0
+	}
+	return int(C.task_processor_remove_tasks(p.handle,
+		(*C.int32_t)(unsafe.Pointer(&ids[0])), C.size_t(len(ids))))
+}
+
+// ProcessAll runs every pending task
+func (p *NativeTaskProcessor) ProcessAll() {
+	C.task_processor_process_all(p.handle)
+}
+
+// Query returns the ids of tasks whose status and priority bits are set in
+// the masks (bit N accepts value N), in ascending order
+func (p *NativeTaskProcessor) Query(statusMask, priorityMask uint32) []int32 {
+	ids := make([]int32, 256)
+	for {
+		total := int(C.task_processor_query(p.handle, C.uint32_t(statusMask), C.uint32_t(priorityMask),
+			(*C.int32_t)(unsafe.Pointer(&ids[0])), C.size_t(len(ids))))
+		if total <= len(ids) {
+			return ids[:total]
+		}
+		ids = make([]int32, total)
+	}
+}
+
+// Serialize encodes the tasks matching the masks as one binary batch in the
+// native/task_wire.h format, ready to hand to another process or language
+func (p *NativeTaskProcessor) Serialize(statusMask, priorityMask uint32) ([]byte, error) {
+	size := C.task_processor_serialize(p.handle, C.uint32_t(statusMask), C.uint32_t(priorityMask), nil, 0)
+	for size != 0 {
+		buffer := make([]byte, int(size))
+		written := C.task_processor_serialize(p.handle, C.uint32_t(statusMask), C.uint32_t(priorityMask),
+			(*C.char)(unsafe.Pointer(&buffer[0])), size)
+		if written <= size {
+			return buffer[:int(written)], nil
+		}
+		size = written
+	}
+	return nil, errors.New("task batch exceeds the wire format size limit")
+}
+
+// Records returns the fields of each id; missing tasks have ID 0
+func (p *NativeTaskProcessor) Records(ids []int32) []NativeTask {
+	if len(ids) == 0 {
+		return nil
+	}
+	records := make([]C.task_record, len(ids))
+	C.task_processor_get_records(p.handle, (*C.int32_t)(unsafe.Pointer(&ids[0])),
+		C.size_t(len(ids)), &records[0])
+
+	tasks := make([]NativeTask, len(ids))
+	for i, record := range records {
+		tasks[i] = NativeTask{
+			ID:          int32(record.id),
+			Priority:    int32(record.priority),
+			Status:      int32(record.status),
+			CreatedAt:   int64(record.created_at),
+			CompletedAt: int64(record.completed_at),
+		}
+	}
+	return tasks
+}
@@ -1,9 +1,9 @@
 package util
 
 /*
-#cgo CFLAGS: -I../../native
-#cgo LDFLAGS: -L../../native/build -lutils
-#include "../../native/utils.h"
+#cgo CFLAGS: -I${SRCDIR}/../../../native
+#cgo LDFLAGS: -L${SRCDIR}/../../../native -ltaskprocessor
+#include "utils.h"
 #include <stdlib.h>
 */
 import "C"
@@ -50,6 +50,43 @@ func (n *NativeUtils) IsPrime(num int) bool {
 	return isPrimeFallback(num)
 }
 
+// IsPrimeBatch reports for each value whether it is prime, in one native call
+// References: native/utils.h is_prime_batch()
+func (n *NativeUtils) IsPrimeBatch(values []int64) []bool {
+	if len(values) == 0 {
+		return nil
+	}
+	bitmap := make([]byte, (len(values)+7)/8)
+	C.is_prime_batch((*C.longlong)(unsafe.Pointer(&values[0])), C.size_t(len(values)),
+		(*C.uchar)(unsafe.Pointer(&bitmap[0])))
+
+	primes := make([]bool, len(values))
+	for i := range values {
+		primes[i] = bitmap[i/8]>>(i%8)&1 != 0
+	}
+	return primes
+}
+
+// PrimesInRange returns the primes in [low, high) in ascending order
+// References: native/utils.h prime_sieve_range()
+func (n *NativeUtils) PrimesInRange(low, high uint64) []uint64 {
+	if high <= low {
+		return nil
+	}
+	width := high - low
+	bitmap := make([]byte, (width+7)/8)
+	count := int(C.prime_sieve_range(C.ulonglong(low), C.ulonglong(high),
+		(*C.uchar)(unsafe.Pointer(&bitmap[0]))))
+
+	primes := make([]uint64, 0, count)
+	for i := uint64(0); i < width; i++ {
+		if bitmap[i/8]>>(i%8)&1 != 0 {
+			primes = append(primes, low+i)
+		}
+	}
+	return primes
+}
+
 // ReverseString reverses a string using native C function
 // References: native/utils.h reverse_string()
 func (n *NativeUtils) ReverseString(str string) string {
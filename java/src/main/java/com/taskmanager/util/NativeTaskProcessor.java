@@ -0,0 +1,173 @@
+package com.taskmanager.util;
+
+import java.nio.charset.StandardCharsets;
+
+/**
+ * NativeTaskProcessor - Batch bindings to the native C++ TaskProcessor
+ * References: native/task_api.h (C API)
+ *            native/task_api_jni.cpp (JNI glue, built by `make jni`)
+ *
+ * Every method crosses into native code once per batch: strings are packed
+ * into a single byte array and ids/priorities/statuses travel as primitive
+ * arrays, which the glue reads with Get&lt;Type&gt;ArrayElements (the JVM may
+ * pin or copy them). Array sizes are checked on the native side too; a
+ * mismatch throws IllegalArgumentException. Instances are not thread-safe
+ * and must be closed to free the native processor.
+ */
+public class NativeTaskProcessor implements AutoCloseable {
+
+    // Values shared with native/task_processor.h
+    public static final int PRIORITY_LOW = 0;
+    public static final int PRIORITY_MEDIUM = 1;
+    public static final int PRIORITY_HIGH = 2;
+    public static final int PRIORITY_CRITICAL = 3;
+
+    public static final int STATUS_PENDING = 0;
+    public static final int STATUS_IN_PROGRESS = 1;
+    public static final int STATUS_COMPLETED = 2;
+    public static final int STATUS_FAILED = 3;
+
+    /** Query mask accepting every status or priority */
+    public static final int MASK_ALL = 0x0F;
+
+    private static final boolean AVAILABLE;
+
+    static {
+        boolean loaded;
+        try {
+            System.loadLibrary("taskprocessor_jni");
+            loaded = true;
+        } catch (UnsatisfiedLinkError e) {
+            System.err.println("Warning: Native library 'taskprocessor_jni' not found.");
+            loaded = false;
+        }
+        AVAILABLE = loaded;
+    }
+
+    // Native method declarations (native/task_api_jni.cpp)
+    private static native long createNative();
+    private static native void destroyNative(long handle);
+    private static native int addTasksNative(long handle, byte[] strings, int[] titleLengths,
+                                             int[] descriptionLengths, int[] priorities, int[] idsOut);
+    private static native int updateStatusesNative(long handle, int[] ids, int[] statuses);
+    private static native int removeTasksNative(long handle, int[] ids);
+    private static native void processAllNative(long handle);
+    private static native int queryNative(long handle, int statusMask, int priorityMask, int[] idsOut);
+
+    private long handle;
+
+    /**
+     * Whether the JNI library was loaded
+     */
+    public static boolean isAvailable() {
+        return AVAILABLE;
+    }
+
+    public NativeTaskProcessor() {
+        if (!AVAILABLE) {
+            throw new IllegalStateException("Native library 'taskprocessor_jni' is not loaded");
+        }
+        handle = createNative();
+        if (handle == 0) {
+            throw new IllegalStateException("Native task processor could not be created");
+        }
+    }
+
+    /**
+     * Add one task per title (descriptions and priorities may be null).
+     * Returns the new ids; 0 marks a task rejected for an invalid priority.
+     * References: native/task_api.h task_processor_add_tasks()
+     */
+    public int[] addTasks(String[] titles, String[] descriptions, int[] priorities) {
+        int count = titles.length;
+        if (descriptions != null && descriptions.length != count) {
+            throw new IllegalArgumentException("descriptions length mismatch");
+        }
+        if (priorities != null && priorities.length != count) {
+            throw new IllegalArgumentException("priorities length mismatch");
+        }
+
+        byte[][] encoded = new byte[count * 2][];
+        int[] titleLengths = new int[count];
+        int[] descriptionLengths = descriptions != null ? new int[count] : null;
+        int total = 0;
+        for (int i = 0; i < count; i++) {
+            encoded[2 * i] = titles[i].getBytes(StandardCharsets.UTF_8);
+            titleLengths[i] = encoded[2 * i].length;
+            total += titleLengths[i];
+            if (descriptions != null) {
+                encoded[2 * i + 1] = descriptions[i].getBytes(StandardCharsets.UTF_8);
+                descriptionLengths[i] = encoded[2 * i + 1].length;
+                total += descriptionLengths[i];
+            }
+        }
+        byte[] packed = new byte[total];
+        int offset = 0;
+        for (byte[] bytes : encoded) {
+            if (bytes == null) continue;
+            System.arraycopy(bytes, 0, packed, offset, bytes.length);
+            offset += bytes.length;
+        }
+
+        int[] ids = new int[count];
+        addTasksNative(checkedHandle(), packed, titleLengths, descriptionLengths, priorities, ids);
+        return ids;
+    }
+
+    /**
+     * Set statuses[i] on ids[i]; returns how many tasks were updated
+     * References: native/task_api.h task_processor_update_statuses()
+     */
+    public int updateStatuses(int[] ids, int[] statuses) {
+        if (ids.length != statuses.length) {
+            throw new IllegalArgumentException("ids and statuses length mismatch");
+        }
+        return updateStatusesNative(checkedHandle(), ids, statuses);
+    }
+
+    /**
+     * Remove tasks by id; returns how many existed
+     * References: native/task_api.h task_processor_remove_tasks()
+     */
+    public int removeTasks(int[] ids) {
+        return removeTasksNative(checkedHandle(), ids);
+    }
+
+    /**
+     * Run every pending task
+     */
+    public void processAll() {
+        processAllNative(checkedHandle());
+    }
+
+    /**
+     * Ids of tasks whose status and priority bits are set in the masks
+     * (bit N accepts value N), ascending
+     * References: native/task_api.h task_processor_query()
+     */
+    public int[] query(int statusMask, int priorityMask) {
+        int[] ids = new int[256];
+        while (true) {
+            int total = queryNative(checkedHandle(), statusMask, priorityMask, ids);
+            if (total <= ids.length) {
+                return total == ids.length ? ids : java.util.Arrays.copyOf(ids, total);
+            }
+            ids = new int[total];
+        }
+    }
+
+    @Override
+    public void close() {
+        if (handle != 0) {
+            destroyNative(handle);
+            handle = 0;
+        }
+    }
+
+    private long checkedHandle() {
+        if (handle == 0) {
+            throw new IllegalStateException("NativeTaskProcessor is closed");
+        }
+        return handle;
+    }
+}
@@ -1,5 +1,7 @@
 package com.taskmanager.util;
 
+import java.math.BigInteger;
+
 /**
  * NativeUtils - Wrapper for native C/C++ functions
  * References: native/utils.h (C header file)
@@ -25,6 +27,7 @@ public class NativeUtils {
     private native long factorialNative(int n);
     private native long fibonacciNative(int n);
     private native boolean isPrimeNative(int n);
+    private native void isPrimeBatchNative(long[] values, byte[] bitmap);
     private native String reverseStringNative(String str);
     private native long arraySumNative(int[] arr);
 
@@ -65,6 +68,26 @@ public class NativeUtils {
         }
     }
 
+    /**
+     * Check many numbers for primality in one native call
+     * References: native/utils.h is_prime_batch()
+     */
+    public boolean[] isPrimeBatch(long[] values) {
+        boolean[] primes = new boolean[values.length];
+        try {
+            byte[] bitmap = new byte[(values.length + 7) / 8];
+            isPrimeBatchNative(values, bitmap);
+            for (int i = 0; i < values.length; i++) {
+                primes[i] = ((bitmap[i >> 3] >> (i & 7)) & 1) != 0;
+            }
+        } catch (UnsatisfiedLinkError e) {
+            for (int i = 0; i < values.length; i++) {
+                primes[i] = values[i] >= 2 && BigInteger.valueOf(values[i]).isProbablePrime(64);
+            }
+        }
+        return primes;
+    }
+
     /**
      * Reverse string using native C function
      * References: native/utils.h reverse_string()
@@ -0,0 +1,135 @@
+#include "concurrent_task_processor.h"
+#include "task_ingest.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Contention benchmark for ConcurrentTaskProcessor: a single global mutex
+// (one shard) versus sharded locking, at 1-16 caller threads. Every thread
+// runs the same mix against its own recently added tasks: 40% addTask, 30%
+// updateTaskStatus, 20% getTask, 10% lock-free getPendingCount.
+//
+// A second table times pure ingest: producers calling addTask on a
+// one-shard processor directly, versus submitting to a TaskIngestQueue that
+// one consumer thread drains into a plain TaskProcessor.
+//
+// Usage: bench_concurrent [ops-per-thread] [shards]
+
+static volatile int sink;
+
+// Only errors; per-task log lines would dominate the measurement
+static std::shared_ptr<Logger> quietLogger = std::make_shared<StreamLogger>(LogLevel::ERROR);
+
+static void mixedWorkload(ConcurrentTaskProcessor& processor, int ops, unsigned seed) {
+    std::vector<int> mine;
+    mine.reserve(static_cast<size_t>(ops));
+    unsigned state = seed * 2654435761u + 1;
+    for (int i = 0; i < ops; i++) {
+        state = state * 1103515245u + 12345u;
+        unsigned roll = (state >> 16) % 10;
+        if (roll < 4 || mine.empty()) {
+            mine.push_back(processor.addTask("bench", "", static_cast<TaskPriority>(i % 4)));
+        } else if (roll < 7) {
+            int id = mine[(state >> 8) % mine.size()];
+            processor.updateTaskStatus(id, static_cast<TaskStatus>(i % 4));
+        } else if (roll < 9) {
+            int id = mine[(state >> 8) % mine.size()];
+            auto task = processor.getTask(id);
+            sink = task ? task->id : 0;
+        } else {
+            sink = processor.getPendingCount();
+        }
+    }
+}
+
+static double runOnce(size_t shards, size_t threads, int ops) {
+    ConcurrentTaskProcessor processor(shards, quietLogger);
+    std::vector<std::thread> callers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; t++) {
+        callers.emplace_back([&processor, ops, t] {
+            mixedWorkload(processor, ops, static_cast<unsigned>(t));
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    return static_cast<double>(ops) * threads / elapsed.count();
+}
+
+static double ingestDirect(size_t threads, int ops) {
+    ConcurrentTaskProcessor processor(1, quietLogger);
+    std::vector<std::thread> producers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; t++) {
+        producers.emplace_back([&processor, ops] {
+            for (int i = 0; i < ops; i++) {
+                processor.addTask("bench", "", static_cast<TaskPriority>(i % 4));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    return static_cast<double>(ops) * threads / elapsed.count();
+}
+
+// Timed until the consumer has inserted every task, not just until the
+// producers return
+static double ingestQueued(size_t threads, int ops) {
+    TaskProcessor processor(quietLogger);
+    TaskIngestQueue queue(4096);
+    std::atomic<size_t> finished{0};
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&] {
+        while (finished.load() < threads || queue.size() > 0) {
+            if (queue.drainInto(processor) == 0) std::this_thread::yield();
+        }
+    });
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < threads; t++) {
+        producers.emplace_back([&queue, &finished, ops] {
+            for (int i = 0; i < ops; i++) {
+                while (!queue.submitFor(std::chrono::milliseconds(10), "bench", "",
+                                        static_cast<TaskPriority>(i % 4))) {
+                }
+            }
+            finished++;
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    consumer.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    return static_cast<double>(ops) * threads / elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    int ops = argc > 1 ? std::atoi(argv[1]) : 100000;
+    size_t shards = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 16;
+    const size_t threadCounts[] = {1, 2, 4, 8, 16};
+
+    printf("Concurrent processor benchmark: %d ops per thread, %zu shards, %u hardware threads\n",
+           ops, shards, std::thread::hardware_concurrency());
+    printf("%8s %18s %18s %8s\n", "threads", "1 shard (ops/s)", "sharded (ops/s)", "ratio");
+    for (size_t threads : threadCounts) {
+        double global = runOnce(1, threads, ops);
+        double sharded = runOnce(shards, threads, ops);
+        printf("%8zu %18.0f %18.0f %8.2f\n", threads, global, sharded, sharded / global);
+    }
+
+    printf("\nIngest: %d adds per producer\n", ops);
+    printf("%8s %18s %18s %8s\n", "threads", "locked (adds/s)", "ring (adds/s)", "ratio");
+    for (size_t threads : threadCounts) {
+        double direct = ingestDirect(threads, ops);
+        double queued = ingestQueued(threads, ops);
+        printf("%8zu %18.0f %18.0f %8.2f\n", threads, direct, queued, queued / direct);
+    }
+    return 0;
+}
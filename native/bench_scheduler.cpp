@@ -0,0 +1,53 @@
+#include "task_processor.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Throughput of TaskProcessor::processAll with the shared-queue worker pool
+// versus the work-stealing scheduler, at 1-64 worker threads.
+//
+// Usage: bench_scheduler [tasks] [spin-iterations-per-task]
+
+static volatile unsigned long long sink;
+
+static bool spinWork(const Task& task, int iterations) {
+    unsigned long long acc = static_cast<unsigned long long>(task.id);
+    for (int i = 0; i < iterations; i++) {
+        acc = acc * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    sink = acc;
+    return true;
+}
+
+// Only errors; per-task log lines would dominate the measurement
+static std::shared_ptr<Logger> quietLogger = std::make_shared<StreamLogger>(LogLevel::ERROR);
+
+static double runOnce(SchedulingMode mode, size_t threads, int tasks, int spin) {
+    TaskProcessor processor(quietLogger);
+    processor.setSchedulingMode(mode);
+    processor.setWorkerCount(threads);
+    processor.setWorkFunction([spin](const Task& task) { return spinWork(task, spin); });
+    for (int i = 0; i < tasks; i++) {
+        processor.addTask("bench", "", static_cast<TaskPriority>(i % 4));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    processor.processAll();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    return tasks / elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    int tasks = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int spin = argc > 2 ? std::atoi(argv[2]) : 2000;
+    const size_t threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    printf("Scheduler benchmark: %d tasks, %d spin iterations per task\n", tasks, spin);
+    printf("%8s %18s %18s %8s\n", "threads", "shared (tasks/s)", "stealing (tasks/s)", "ratio");
+    for (size_t threads : threadCounts) {
+        double shared = runOnce(SchedulingMode::SHARED_QUEUE, threads, tasks, spin);
+        double stealing = runOnce(SchedulingMode::WORK_STEALING, threads, tasks, spin);
+        printf("%8zu %18.0f %18.0f %8.2f\n", threads, shared, stealing, stealing / shared);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// sort_array and sort_array_parallel against the C library's qsort on
+// sorted, reversed, random and many-duplicate inputs at three sizes.
+//
+// Usage: bench_sort [threads]   (0 = one per CPU)
+
+typedef enum { SORTED, REVERSED, RANDOM, DUPLICATES } input_shape;
+
+static const char* shape_names[] = {"sorted", "reversed", "random", "duplicates"};
+
+static unsigned int rng_state = 12345;
+
+static int next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int)rng_state;
+}
+
+static void fill(int* arr, size_t size, input_shape shape) {
+    for (size_t i = 0; i < size; i++) {
+        switch (shape) {
+            case SORTED:     arr[i] = (int)i - (int)(size / 2); break;
+            case REVERSED:   arr[i] = (int)(size / 2) - (int)i; break;
+            case RANDOM:     arr[i] = next_random(); break;
+            case DUPLICATES: arr[i] = next_random() & 15; break;
+        }
+    }
+}
+
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static double now_nanos(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int threads_arg = 0;
+
+// 0 = sort_array, 1 = sort_array_parallel, 2 = qsort; returns ns/element
+static double time_sort(int which, const int* input, int* work, size_t size, int repetitions) {
+    double total = 0;
+    for (int r = 0; r < repetitions; r++) {
+        memcpy(work, input, size * sizeof(int));
+        double start = now_nanos();
+        if (which == 0) sort_array(work, size);
+        else if (which == 1) sort_array_parallel(work, size, threads_arg);
+        else qsort(work, size, sizeof(int), compare_ints);
+        total += now_nanos() - start;
+        for (size_t i = 1; i < size; i++) {
+            if (work[i - 1] > work[i]) {
+                fprintf(stderr, "unsorted output at %zu\n", i);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    return total / ((double)size * repetitions);
+}
+
+int main(int argc, char** argv) {
+    threads_arg = argc > 1 ? atoi(argv[1]) : 0;
+    size_t sizes[] = {1000, 100000, 4000000};
+
+    printf("Sort benchmark (ns/element, lower is better)\n");
+    printf("%10s %-11s %12s %12s %12s %9s\n", "size", "input", "sort_array", "parallel", "qsort",
+           "speedup");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t size = sizes[s];
+        int repetitions = size <= 1000 ? 2000 : size <= 100000 ? 20 : 3;
+        int* input = (int*)safe_malloc(size * sizeof(int));
+        int* work = (int*)safe_malloc(size * sizeof(int));
+        for (int shape = SORTED; shape <= DUPLICATES; shape++) {
+            fill(input, size, (input_shape)shape);
+            double engine = time_sort(0, input, work, size, repetitions);
+            double parallel = time_sort(1, input, work, size, repetitions);
+            double libc = time_sort(2, input, work, size, repetitions);
+            printf("%10zu %-11s %12.2f %12.2f %12.2f %8.1fx\n", size, shape_names[shape],
+                   engine, parallel, libc, libc / engine);
+        }
+        free(input);
+        free(work);
+    }
+    return 0;
+}
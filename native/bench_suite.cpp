@@ -0,0 +1,592 @@
+#include "task_processor.h"
+#include "task_json.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Regression benchmarks for TaskProcessor (addTask, addTasks, getTask,
+// processAll, getTasksByStatus at 1e3-1e7 tasks) and every utils.h kernel.
+// Each case is warmed up, then sampled until its time budget runs out; the
+// median, p99 and minimum time per operation are reported, optionally as
+// JSON, and two JSON files can be diffed.
+//
+// Usage: bench_suite [--json FILE] [--filter TEXT] [--max-tasks N] [--budget SECONDS]
+//        bench_suite --compare BASELINE.json CURRENT.json [--threshold PERCENT]
+
+static volatile long long sink;
+
+struct BenchOptions {
+    std::string jsonPath;
+    std::string filter;
+    size_t maxTasks = 10000000;
+    double budgetSeconds = 0.25;
+};
+
+struct BenchResult {
+    std::string name;
+    size_t n;
+    size_t samples;
+    double medianNs;   // per operation
+    double p99Ns;
+    double minNs;
+    double opsPerSec;
+};
+
+static double nowNanos() {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+class BenchHarness {
+public:
+    explicit BenchHarness(const BenchOptions& options) : options(options) {}
+
+    bool enabled(const std::string& name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    // Times `run`, which performs `ops` operations. Without `prepare` the
+    // run is repeated in batches of at least kMinSampleNs so cheap kernels
+    // are not swamped by the clock; with it, `prepare` resets state
+    // untimed before every single run.
+    void measure(const std::string& name, size_t n, size_t ops,
+                 const std::function<void()>& run,
+                 const std::function<void()>& prepare = nullptr) {
+        if (!enabled(name)) return;
+        double budget = options.budgetSeconds * 1e9;
+        double started = nowNanos();
+
+        // Warmup: one run, then more until a tenth of the budget is spent;
+        // the batch size doubles until a batch fills kMinSampleNs
+        size_t batch = 1;
+        for (;;) {
+            double elapsed = timeBatch(run, prepare, batch);
+            if (!prepare && elapsed < kMinSampleNs && batch < (size_t(1) << 30)) {
+                batch *= 2;
+                continue;
+            }
+            if (nowNanos() - started >= budget / 10) break;
+        }
+
+        std::vector<double> samples;
+        double sampling = nowNanos();
+        while (samples.size() < kMinSamples ||
+               (nowNanos() - sampling < budget && samples.size() < kMaxSamples)) {
+            double elapsed = timeBatch(run, prepare, batch);
+            samples.push_back(elapsed / (static_cast<double>(batch) * static_cast<double>(ops)));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult result{name, n, samples.size(), percentile(samples, 0.5),
+                           percentile(samples, 0.99), samples.front(), 0};
+        result.opsPerSec = result.medianNs > 0 ? 1e9 / result.medianNs : 0;
+        std::printf("%-34s %10zu %12.2f %12.2f %14.0f %8zu\n", name.c_str(), n,
+                    result.medianNs, result.p99Ns, result.opsPerSec, result.samples);
+        std::fflush(stdout);
+        results.push_back(result);
+    }
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+
+private:
+    static constexpr double kMinSampleNs = 50000;
+    static constexpr size_t kMinSamples = 5;
+    static constexpr size_t kMaxSamples = 2000;
+
+    double timeBatch(const std::function<void()>& run, const std::function<void()>& prepare,
+                     size_t batch) {
+        if (prepare) prepare();
+        double start = nowNanos();
+        for (size_t i = 0; i < batch; i++) run();
+        return nowNanos() - start;
+    }
+
+    const BenchOptions& options;
+    std::vector<BenchResult> results;
+};
+
+// ============ TaskProcessor ============
+
+// Only errors; per-task log lines would dominate the measurement
+static std::shared_ptr<Logger> quietLogger = std::make_shared<StreamLogger>(LogLevel::ERROR);
+
+static void fillProcessor(TaskProcessor& processor, size_t tasks) {
+    for (size_t i = 0; i < tasks; i++) {
+        processor.addTask("Task " + std::to_string(i), "", static_cast<TaskPriority>(i % 4));
+    }
+}
+
+static void benchTasks(BenchHarness& bench, size_t tasks) {
+    const size_t lookups = 1000;
+    std::string prefix = "tasks/";
+    std::unique_ptr<TaskProcessor> processor;
+
+    // Read-only cases share one processor: a quarter of the tasks in each status
+    if (bench.enabled(prefix + "getTask") || bench.enabled(prefix + "getTasksByStatus") ||
+        bench.enabled(prefix + "findByStatus")) {
+        processor = std::make_unique<TaskProcessor>(quietLogger);
+        fillProcessor(*processor, tasks);
+        for (size_t i = 0; i < tasks; i++) {
+            auto status = static_cast<TaskStatus>(i % 4);
+            if (status != TaskStatus::PENDING) {
+                processor->updateTaskStatus(static_cast<int>(i + 1), status);
+            }
+        }
+        size_t cursor = 0;
+        bench.measure(prefix + "getTask", tasks, lookups, [&] {
+            long long total = 0;
+            for (size_t i = 0; i < lookups; i++) {
+                cursor = (cursor + 2654435761u) % tasks;
+                total += processor->getTask(static_cast<int>(cursor + 1))->id;
+            }
+            sink = total;
+        });
+        bench.measure(prefix + "getTasksByStatus", tasks, tasks, [&] {
+            sink = static_cast<long long>(processor->getTasksByStatus(TaskStatus::PENDING).size());
+        });
+        bench.measure(prefix + "findByStatus", tasks, tasks, [&] {
+            sink = static_cast<long long>(processor->findByStatus(TaskStatus::PENDING).size());
+        });
+        processor.reset();
+    }
+
+    // Mutating cases rebuild the processor, untimed, before every run
+    bench.measure(prefix + "addTask", tasks, tasks,
+        [&] { fillProcessor(*processor, tasks); },
+        [&] {
+            processor.reset();
+            processor = std::make_unique<TaskProcessor>(quietLogger);
+        });
+    // Same titles as addTask, built inside the timed run too, so the two
+    // differ only in per-call versus per-batch bookkeeping
+    std::vector<std::string> titles;
+    std::vector<TaskSpec> specs;
+    bench.measure(prefix + "addTasks", tasks, tasks,
+        [&] {
+            titles.resize(tasks);
+            specs.resize(tasks);
+            for (size_t i = 0; i < tasks; i++) {
+                titles[i] = "Task " + std::to_string(i);
+                specs[i] = {titles[i], "", static_cast<TaskPriority>(i % 4)};
+            }
+            processor->addTasks(specs.data(), specs.size());
+        },
+        [&] {
+            processor.reset();
+            processor = std::make_unique<TaskProcessor>(quietLogger);
+        });
+    titles = std::vector<std::string>();
+    specs = std::vector<TaskSpec>();
+    bench.measure(prefix + "processAll", tasks, tasks,
+        [&] { processor->processAll(); },
+        [&] {
+            processor.reset();
+            processor = std::make_unique<TaskProcessor>(quietLogger);
+            fillProcessor(*processor, tasks);
+        });
+    processor.reset();
+}
+
+// ============ utils.h ============
+
+static unsigned int rngState = 12345;
+
+static unsigned int nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static void benchMath(BenchHarness& bench) {
+    const size_t calls = 1000;
+    bench.measure("math/factorial", 12, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += factorial(static_cast<int>(i % 13));
+        sink = total;
+    });
+    bench.measure("math/factorial_long", 20, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += factorial_long(static_cast<int>(i % 21));
+        sink = total;
+    });
+    bench.measure("math/fibonacci", 46, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += fibonacci(static_cast<int>(i % 47));
+        sink = total;
+    });
+    bench.measure("math/fibonacci_long", 92, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += fibonacci_long(static_cast<int>(i % 93));
+        sink = total;
+    });
+    bench.measure("math/factorial_mod", 100000, 1, [] {
+        sink = static_cast<long long>(factorial_mod(100000, 1000000007ULL));
+    });
+    bench.measure("math/fibonacci_mod", 1000000000, calls, [] {
+        unsigned long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += fibonacci_mod(1000000000ULL + i, 1000000007ULL);
+        sink = static_cast<long long>(total);
+    });
+
+    std::vector<uint32_t> limbs(factorial_big_limbs(5000));
+    bench.measure("math/factorial_big", 5000, 1, [&] {
+        sink = static_cast<long long>(factorial_big(5000, limbs.data(), limbs.size()));
+    });
+    std::vector<uint32_t> fib(fibonacci_big_limbs(100000));
+    bench.measure("math/fibonacci_big", 100000, 1, [&] {
+        sink = static_cast<long long>(fibonacci_big(100000, fib.data(), fib.size()));
+    });
+    size_t count = factorial_big(1000, limbs.data(), limbs.size());
+    std::vector<char> digits(big_to_decimal(limbs.data(), count, nullptr, 0) + 1);
+    bench.measure("math/big_to_decimal", digits.size() - 1, 1, [&] {
+        sink = static_cast<long long>(big_to_decimal(limbs.data(), count, digits.data(), digits.size()));
+    });
+
+    bench.measure("math/is_prime", calls, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += is_prime(1000001 + 2 * static_cast<int>(i));
+        sink = total;
+    });
+    bench.measure("math/is_prime_u64", calls, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += is_prime_u64(0xFFFFFFFFFFFFFFC5ULL - 2 * i);
+        sink = total;
+    });
+    const size_t batchSize = 100000;
+    std::vector<long long> values(batchSize);
+    for (size_t i = 0; i < batchSize; i++) values[i] = 1000000 + static_cast<long long>(i);
+    std::vector<unsigned char> bitmap((batchSize + 7) / 8);
+    bench.measure("math/is_prime_batch", batchSize, batchSize, [&] {
+        is_prime_batch(values.data(), batchSize, bitmap.data());
+        sink = bitmap[0];
+    });
+    const size_t span = 1000000;
+    std::vector<unsigned char> sieve((span + 7) / 8);
+    bench.measure("math/prime_sieve_range", span, span, [&] {
+        sink = static_cast<long long>(prime_sieve_range(1000000000ULL, 1000000000ULL + span, sieve.data()));
+    });
+
+    bench.measure("math/gcd", calls, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += gcd(static_cast<int>(i * 7919 % 999983) + 1, 65536);
+        sink = total;
+    });
+    bench.measure("math/lcm", calls, calls, [] {
+        long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += lcm(static_cast<int>(i % 1000) + 1, 360);
+        sink = total;
+    });
+    bench.measure("math/power", calls, calls, [] {
+        double total = 0;
+        for (size_t i = 0; i < calls; i++) total += power(1.0001, static_cast<int>(i % 512) - 256);
+        sink = static_cast<long long>(total);
+    });
+    std::vector<double> bases(batchSize);
+    std::vector<double> powers(batchSize);
+    for (size_t i = 0; i < batchSize; i++) bases[i] = 0.5 + static_cast<double>(i) / batchSize;
+    bench.measure("math/power_array", batchSize, batchSize, [&] {
+        power_array(bases.data(), powers.data(), batchSize, 37);
+        sink = static_cast<long long>(powers[batchSize - 1]);
+    });
+    bench.measure("math/pow_mod", calls, calls, [] {
+        unsigned long long total = 0;
+        for (size_t i = 0; i < calls; i++) total += pow_mod(i + 2, 0xFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFC5ULL);
+        sink = static_cast<long long>(total);
+    });
+}
+
+static void benchStrings(BenchHarness& bench) {
+    const size_t length = 1 << 20;
+    static const char words[] = "The quick brown fox jumps over the lazy dog; "
+                                "Pack my box with five dozen liquor jugs. ";
+    std::string text(length, ' ');
+    for (size_t i = 0; i < length; i++) text[i] = words[i % (sizeof(words) - 1)];
+    char* data = &text[0];
+
+    bench.measure("strings/string_length", length, length, [&] { sink = string_length(data); });
+    std::string copy = text;
+    bench.measure("strings/string_equals", length, length, [&] {
+        sink = string_equals(data, copy.c_str());
+    });
+    bench.measure("strings/reverse_string", length, length, [&] { reverse_string(data); });
+    bench.measure("strings/reverse_string_n", length, length, [&] { reverse_string_n(data, length); });
+    bench.measure("strings/string_to_upper", length, length, [&] { sink = *string_to_upper(data); });
+    bench.measure("strings/string_to_upper_n", length, length, [&] { string_to_upper_n(data, length); });
+    bench.measure("strings/string_to_lower", length, length, [&] { sink = *string_to_lower(data); });
+    bench.measure("strings/string_to_lower_n", length, length, [&] { string_to_lower_n(data, length); });
+    bench.measure("strings/count_vowels", length, length, [&] { sink = count_vowels(data); });
+    bench.measure("strings/count_vowels_n", length, length, [&] {
+        sink = static_cast<long long>(count_vowels_n(data, length));
+    });
+    bench.measure("strings/count_words", length, length, [&] { sink = count_words(data); });
+    bench.measure("strings/count_words_n", length, length, [&] {
+        sink = static_cast<long long>(count_words_n(data, length));
+    });
+
+    const size_t calls = 1000;
+    std::string left(32, 'a');
+    std::string right(32, 'b');
+    bench.measure("strings/string_concat", 64, calls, [&] {
+        for (size_t i = 0; i < calls; i++) {
+            char* joined = string_concat(left.c_str(), right.c_str());
+            sink = joined[63];
+            free(joined);
+        }
+    });
+}
+
+static void benchArrays(BenchHarness& bench) {
+    const size_t size = 1000000;
+    std::vector<int> random(size);
+    for (size_t i = 0; i < size; i++) random[i] = static_cast<int>(nextRandom());
+    std::vector<int> work = random;
+    std::vector<int> sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    const int* data = random.data();
+
+    bench.measure("arrays/sum_array", size, size, [&] { sink = sum_array(data, size); });
+    bench.measure("arrays/sum_array_long", size, size, [&] { sink = sum_array_long(data, size); });
+    bench.measure("arrays/average_array", size, size, [&] {
+        sink = static_cast<long long>(average_array(data, size));
+    });
+    bench.measure("arrays/find_max", size, size, [&] { sink = find_max(data, size); });
+    bench.measure("arrays/find_min", size, size, [&] { sink = find_min(data, size); });
+    bench.measure("arrays/array_stats", size, size, [&] { sink = array_stats(data, size).sum; });
+    bench.measure("arrays/reverse_array", size, size, [&] { reverse_array(work.data(), size); });
+
+    const size_t lookups = 1000;
+    bench.measure("arrays/binary_search", size, lookups, [&] {
+        long long total = 0;
+        for (size_t i = 0; i < lookups; i++) {
+            total += binary_search(sorted.data(), size, sorted[(i * 7919) % size]);
+        }
+        sink = total;
+    });
+
+    auto reload = [&] { std::copy(random.begin(), random.end(), work.begin()); };
+    bench.measure("arrays/sort_array", size, size, [&] { sort_array(work.data(), size); }, reload);
+    bench.measure("arrays/sort_array_parallel", size, size,
+                  [&] { sort_array_parallel(work.data(), size, 0); }, reload);
+}
+
+static void benchMemory(BenchHarness& bench) {
+    const size_t calls = 1000;
+    bench.measure("memory/safe_malloc", 64, calls, [] {
+        for (size_t i = 0; i < calls; i++) {
+            void* ptr = safe_malloc(64);
+            sink = ptr != nullptr;
+            safe_free(&ptr);
+        }
+    });
+    bench.measure("memory/safe_calloc", 64, calls, [] {
+        for (size_t i = 0; i < calls; i++) {
+            void* ptr = safe_calloc(16, 4);
+            sink = ptr != nullptr;
+            safe_free(&ptr);
+        }
+    });
+    arena_t arena;
+    arena_init(&arena, 0);
+    bench.measure("memory/arena_alloc", 64, calls, [&] {
+        for (size_t i = 0; i < calls; i++) {
+            sink = arena_alloc(&arena, 64) != nullptr;
+        }
+        arena_reset(&arena);
+    });
+    arena_destroy(&arena);
+    pool_t pool;
+    pool_init(&pool, 64, 0);
+    std::vector<void*> objects(calls);
+    bench.measure("memory/pool_alloc_free", 64, calls, [&] {
+        for (size_t i = 0; i < calls; i++) objects[i] = pool_alloc(&pool);
+        for (size_t i = 0; i < calls; i++) pool_free(&pool, objects[i]);
+    });
+    pool_destroy(&pool);
+}
+
+// ============ JSON output and comparison ============
+
+static bool writeJson(const std::string& path, const BenchOptions& options,
+                      const std::vector<BenchResult>& results) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok;
+    {
+        JsonWriter out(fd);
+        out.beginObject();
+        out.key("timestamp").value(static_cast<long long>(std::time(nullptr)));
+        out.key("simd").value(array_simd_name(array_simd_detect()));
+        out.key("threads").value(static_cast<size_t>(std::thread::hardware_concurrency()));
+        out.key("budget_seconds").value(options.budgetSeconds);
+        out.key("results").beginArray();
+        for (const BenchResult& result : results) {
+            out.beginObject()
+               .key("name").value(result.name)
+               .key("n").value(result.n)
+               .key("samples").value(result.samples)
+               .key("median_ns").value(result.medianNs)
+               .key("p99_ns").value(result.p99Ns)
+               .key("min_ns").value(result.minNs)
+               .key("ops_per_sec").value(result.opsPerSec)
+               .endObject();
+        }
+        out.endArray().endObject();
+        ok = out.flush() && out.ok();
+    }
+    return ::close(fd) == 0 && ok;
+}
+
+// Reads back the result objects writeJson produces: a flat scan for the
+// "name", "n" and "median_ns" members, not a general JSON parser
+static bool readResults(const std::string& path, std::map<std::string, double>& medians,
+                        std::vector<std::string>& order) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::string text;
+    char chunk[65536];
+    size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) text.append(chunk, got);
+    std::fclose(file);
+
+    size_t at = 0;
+    while ((at = text.find("{\"name\":\"", at)) != std::string::npos) {
+        at += 9;
+        size_t end = text.find('"', at);
+        size_t close = text.find('}', at);
+        size_t n = text.find("\"n\":", at);
+        size_t median = text.find("\"median_ns\":", at);
+        if (end == std::string::npos || close == std::string::npos ||
+            n > close || median > close) {
+            return false;
+        }
+        std::string key = text.substr(at, end - at) + " @" +
+                          std::to_string(std::strtoull(text.c_str() + n + 4, nullptr, 10));
+        if (!medians.count(key)) order.push_back(key);
+        medians[key] = std::strtod(text.c_str() + median + 12, nullptr);
+        at = close;
+    }
+    return true;
+}
+
+// Returns 1 when any case got slower than `threshold` percent
+static int compareResults(const std::string& basePath, const std::string& currentPath,
+                          double threshold) {
+    std::map<std::string, double> base, current;
+    std::vector<std::string> baseOrder, currentOrder;
+    if (!readResults(basePath, base, baseOrder) || !readResults(currentPath, current, currentOrder)) {
+        std::fprintf(stderr, "cannot read %s or %s\n", basePath.c_str(), currentPath.c_str());
+        return 2;
+    }
+
+    size_t regressions = 0;
+    std::printf("%-46s %12s %12s %9s\n", "case", "base ns/op", "new ns/op", "change");
+    for (const std::string& key : currentOrder) {
+        auto match = base.find(key);
+        if (match == base.end()) {
+            std::printf("%-46s %12s %12.2f %9s\n", key.c_str(), "-", current[key], "new");
+            continue;
+        }
+        double change = match->second > 0 ? (current[key] / match->second - 1) * 100 : 0;
+        const char* verdict = "";
+        if (change > threshold) {
+            verdict = "  REGRESSION";
+            regressions++;
+        } else if (change < -threshold) {
+            verdict = "  faster";
+        }
+        std::printf("%-46s %12.2f %12.2f %+8.1f%%%s\n", key.c_str(), match->second,
+                    current[key], change, verdict);
+    }
+    for (const std::string& key : baseOrder) {
+        if (!current.count(key)) {
+            std::printf("%-46s %12.2f %12s %9s\n", key.c_str(), base[key], "-", "missing");
+        }
+    }
+    std::printf("\n%zu regression%s beyond %.0f%%\n", regressions, regressions == 1 ? "" : "s",
+                threshold);
+    return regressions ? 1 : 0;
+}
+
+static void usage() {
+    std::fprintf(stderr,
+        "usage: bench_suite [--json FILE] [--filter TEXT] [--max-tasks N] [--budget SECONDS]\n"
+        "       bench_suite --compare BASELINE.json CURRENT.json [--threshold PERCENT]\n");
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    std::string compareBase, compareCurrent;
+    double threshold = 10;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--max-tasks" && hasValue) {
+            options.maxTasks = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--budget" && hasValue) {
+            options.budgetSeconds = std::atof(argv[++i]);
+        } else if (arg == "--threshold" && hasValue) {
+            threshold = std::atof(argv[++i]);
+        } else if (arg == "--compare" && i + 2 < argc) {
+            compareBase = argv[++i];
+            compareCurrent = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!compareBase.empty()) {
+        return compareResults(compareBase, compareCurrent, threshold);
+    }
+
+    BenchHarness bench(options);
+    std::printf("Benchmark suite (simd: %s, budget %.2fs per case)\n",
+                array_simd_name(array_simd_detect()), options.budgetSeconds);
+    std::printf("%-34s %10s %12s %12s %14s %8s\n", "case", "n", "median ns", "p99 ns",
+                "ops/sec", "samples");
+    for (size_t tasks = 1000; tasks <= options.maxTasks && tasks <= 10000000; tasks *= 10) {
+        benchTasks(bench, tasks);
+    }
+    benchMath(bench);
+    benchStrings(bench);
+    benchArrays(bench);
+    benchMemory(bench);
+
+    if (!options.jsonPath.empty()) {
+        if (!writeJson(options.jsonPath, options, bench.getResults())) {
+            std::fprintf(stderr, "cannot write %s\n", options.jsonPath.c_str());
+            return 1;
+        }
+        std::printf("\nWrote %zu results to %s\n", bench.getResults().size(),
+                    options.jsonPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "task_processor.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define NULL_DEVICE "NUL"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Cost of exporting a JSON task listing with JsonWriter, into a caller
+// buffer and streamed to a descriptor (the null device).
+// bench_task_json.py compares the same listing built with Python's json
+// module.
+//
+// Usage: bench_task_json [tasks] [repetitions]
+
+template <typename Run>
+static double nanosPerTask(size_t tasks, int repetitions, Run run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++) {
+        run();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / (static_cast<double>(tasks) * repetitions);
+}
+
+int main(int argc, char** argv) {
+    size_t tasks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    TaskProcessor processor(std::make_shared<StreamLogger>(LogLevel::WARN));
+    for (size_t i = 0; i < tasks; i++) {
+        processor.addTask("Task " + std::to_string(i), i % 3 ? "Quarterly \"report\" draft\n" : "",
+                          static_cast<TaskPriority>(i % 4));
+    }
+    processor.processByPriority(TaskPriority::HIGH);
+
+    JsonWriter sizing(nullptr, 0);
+    processor.writeTasksJson(sizing);
+    std::vector<char> buffer(sizing.size());
+    int devnull = ::open(NULL_DEVICE, O_WRONLY);
+    if (devnull < 0) {
+        std::perror(NULL_DEVICE);
+        return 1;
+    }
+
+    double toBuffer = nanosPerTask(tasks, repetitions, [&] {
+        JsonWriter out(buffer.data(), buffer.size());
+        processor.writeTasksJson(out);
+    });
+    double toFd = nanosPerTask(tasks, repetitions, [&] {
+        JsonWriter out(devnull);
+        processor.writeTasksJson(out);
+    });
+    ::close(devnull);
+
+    double mbPerNano = static_cast<double>(buffer.size()) / tasks / 1e6 * 1e9;
+    printf("JSON listing benchmark: %zu tasks, %d repetitions, %zu bytes of JSON\n",
+           tasks, repetitions, buffer.size());
+    printf("%-28s %10s %10s\n", "", "ns/task", "MB/s");
+    printf("%-28s %10.1f %10.0f\n", "JsonWriter -> buffer", toBuffer, mbPerNano / toBuffer);
+    printf("%-28s %10.1f %10.0f\n", "JsonWriter -> " NULL_DEVICE, toFd, mbPerNano / toFd);
+    return 0;
+}
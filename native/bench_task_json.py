@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Native JSON task listing vs the same listing built in Python.
+
+Loads libtaskprocessor through ctypes, fills it with tasks and times
+task_processor_write_json against json.dumps over equivalent dicts (what
+the backend does today). Both outputs are parsed and compared first.
+
+Usage: python3 bench_task_json.py [tasks] [repetitions]
+"""
+import ctypes
+import json
+import platform
+import sys
+import time
+from pathlib import Path
+
+_ext = {"Darwin": "dylib", "Windows": "dll"}.get(platform.system(), "so")
+_lib = ctypes.CDLL(str(Path(__file__).parent / f"libtaskprocessor.{_ext}"))
+
+_lib.task_processor_create.restype = ctypes.c_void_p
+_lib.task_processor_destroy.argtypes = [ctypes.c_void_p]
+_lib.task_processor_add_tasks.argtypes = [
+    ctypes.c_void_p, ctypes.c_size_t, ctypes.c_char_p,
+    ctypes.POINTER(ctypes.c_uint32), ctypes.POINTER(ctypes.c_uint32),
+    ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32),
+]
+_lib.task_processor_add_tasks.restype = ctypes.c_size_t
+_lib.task_processor_write_json.argtypes = [
+    ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_size_t,
+    ctypes.c_size_t, ctypes.c_char_p, ctypes.c_size_t,
+]
+_lib.task_processor_write_json.restype = ctypes.c_size_t
+
+PRIORITIES = ["low", "medium", "high", "critical"]
+MASK_ALL = 0x0F
+
+
+def build(count):
+    """Adds `count` tasks natively and returns matching Python dicts"""
+    titles = [f"Task {i}" for i in range(count)]
+    descriptions = ["" if i % 3 == 0 else 'Quarterly "report" draft\n' for i in range(count)]
+    priorities = [i % 4 for i in range(count)]
+
+    packed = b"".join(t.encode() + d.encode() for t, d in zip(titles, descriptions))
+    title_lengths = (ctypes.c_uint32 * count)(*[len(t.encode()) for t in titles])
+    description_lengths = (ctypes.c_uint32 * count)(*[len(d.encode()) for d in descriptions])
+    priority_array = (ctypes.c_int32 * count)(*priorities)
+    ids = (ctypes.c_int32 * count)()
+
+    handle = _lib.task_processor_create()
+    _lib.task_processor_add_tasks(handle, count, packed, title_lengths,
+                                  description_lengths, priority_array, ids)
+    return handle
+
+
+def python_listing(tasks):
+    return json.dumps({
+        "total": len(tasks), "offset": 0, "limit": None,
+        "tasks": tasks, "next_offset": None,
+    }, separators=(",", ":"), ensure_ascii=False)
+
+
+def timed(repetitions, run):
+    start = time.perf_counter()
+    for _ in range(repetitions):
+        run()
+    return (time.perf_counter() - start) / repetitions
+
+
+def main():
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+    repetitions = int(sys.argv[2]) if len(sys.argv) > 2 else 10
+
+    handle = build(count)
+    size = _lib.task_processor_write_json(handle, MASK_ALL, MASK_ALL, 0, 0, None, 0)
+    buffer = ctypes.create_string_buffer(size)
+
+    def native():
+        _lib.task_processor_write_json(handle, MASK_ALL, MASK_ALL, 0, 0, buffer, size)
+        return buffer.raw[:size]
+
+    # The Python side starts from dicts already in memory, as the backend does
+    tasks = json.loads(native())["tasks"]
+    assert json.loads(python_listing(tasks)) == json.loads(native())
+
+    native_seconds = timed(repetitions, native)
+    python_seconds = timed(repetitions, lambda: python_listing(tasks))
+    _lib.task_processor_destroy(handle)
+
+    print(f"JSON listing: {count} tasks, {size} bytes, {repetitions} repetitions")
+    print(f"{'':28} {'ns/task':>10} {'MB/s':>10}")
+    for name, seconds in (("native (ctypes, to bytes)", native_seconds),
+                          ("python json.dumps", python_seconds)):
+        print(f"{name:28} {seconds / count * 1e9:10.1f} {size / seconds / 1e6:10.0f}")
+    print(f"speedup: {python_seconds / native_seconds:.2f}x")
+
+
+if __name__ == "__main__":
+    main()
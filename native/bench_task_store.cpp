@@ -0,0 +1,74 @@
+#include "task_processor.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// Status/priority filtering over an array of shared_ptr<Task> (the old
+// layout) versus the TaskStore's one-byte columns, scanned by a plain loop
+// and by the dispatched SIMD query kernel, at 1e5 and 1e6 tasks.
+//
+// Usage: bench_task_store [repetitions]
+
+static volatile size_t sink;
+
+template <typename Scan>
+static double nanosPerTask(size_t tasks, int repetitions, Scan scan) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++) {
+        sink = scan();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / (static_cast<double>(tasks) * repetitions);
+}
+
+static void runSize(size_t tasks, int repetitions) {
+    std::vector<std::shared_ptr<Task>> pointers;
+    TaskStore store;
+    for (size_t i = 0; i < tasks; i++) {
+        auto priority = static_cast<TaskPriority>(i % 4);
+        auto status = static_cast<TaskStatus>((i / 4) % 4);
+        auto task = std::make_shared<Task>(static_cast<int>(i), "bench task", "description", priority);
+        task->status = status;
+        pointers.push_back(task);
+        store.append(task->id, task->title, task->description, priority, status, 0);
+    }
+
+    double aos = nanosPerTask(tasks, repetitions, [&pointers] {
+        size_t hits = 0;
+        for (const auto& task : pointers) {
+            hits += task->status == TaskStatus::COMPLETED && task->priority == TaskPriority::HIGH;
+        }
+        return hits;
+    });
+    double soa = nanosPerTask(tasks, repetitions, [&store] {
+        const uint8_t* statuses = store.statusColumn();
+        const uint8_t* priorities = store.priorityColumn();
+        const uint8_t completed = static_cast<uint8_t>(TaskStatus::COMPLETED);
+        const uint8_t high = static_cast<uint8_t>(TaskPriority::HIGH);
+        size_t hits = 0;
+        for (size_t row = 0; row < store.rowCount(); row++) {
+            hits += (statuses[row] == completed) & (priorities[row] == high);
+        }
+        return hits;
+    });
+    TaskQuery query = TaskQuery::withStatus(TaskStatus::COMPLETED).priority(TaskPriority::HIGH);
+    double simd = nanosPerTask(tasks, repetitions, [&store, query] {
+        return queryKernels().count(store.statusColumn(), store.priorityColumn(),
+                                    store.rowCount(), query);
+    });
+    printf("%10zu %16.3f %16.3f %16.3f %8.2f\n", tasks, aos, soa, simd, aos / simd);
+}
+
+int main(int argc, char** argv) {
+    int repetitions = argc > 1 ? std::atoi(argv[1]) : 20;
+
+    printf("Task store scan benchmark: %d repetitions, kernels: %s\n", repetitions,
+           simdLevelToString(detectSimdLevel()));
+    printf("%10s %16s %16s %16s %8s\n", "tasks", "pointers (ns/t)", "columns (ns/t)", "kernel (ns/t)",
+           "speedup");
+    runSize(100000, repetitions);
+    runSize(1000000, repetitions);
+    return 0;
+}
@@ -0,0 +1,340 @@
+#include "concurrent_task_processor.h"
+#include <functional>
+#include <queue>
+#include <thread>
+#include <utility>
+
+ConcurrentTaskProcessor::ConcurrentTaskProcessor(size_t count, std::shared_ptr<Logger> sink)
+    : nextShard(0) {
+    if (count == 0) {
+        count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    if (!sink) {
+        sink = defaultLogger();
+    }
+    shards.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        shards.push_back(std::make_unique<Shard>(sink));
+    }
+}
+
+// ============ Id Mapping ============
+
+bool ConcurrentTaskProcessor::locate(int taskId, size_t& shard, int& localId) const {
+    if (taskId < 1) return false;
+    size_t index = static_cast<size_t>(taskId - 1);
+    shard = index % shards.size();
+    localId = static_cast<int>(index / shards.size()) + 1;
+    return true;
+}
+
+int ConcurrentTaskProcessor::globalId(size_t shard, int localId) const {
+    return (localId - 1) * static_cast<int>(shards.size()) + static_cast<int>(shard) + 1;
+}
+
+// Copies the shard's counters where lock-free readers can see them. Called
+// with the shard locked after every mutation.
+void ConcurrentTaskProcessor::publish(Shard& shard) {
+    for (size_t i = 0; i < kStatusLevels; i++) {
+        shard.statusCounts[i].store(shard.processor.getStatusCount(static_cast<TaskStatus>(i)),
+                                    std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kPriorityLevels; i++) {
+        shard.priorityCounts[i].store(shard.processor.getPriorityCount(static_cast<TaskPriority>(i)),
+                                      std::memory_order_relaxed);
+    }
+    shard.processed.store(shard.processor.getProcessedCount(), std::memory_order_relaxed);
+    shard.failed.store(shard.processor.getFailedCount(), std::memory_order_relaxed);
+}
+
+// K-way merge of per-shard lists that are each sorted by key
+template <typename Item, typename Key>
+std::vector<Item> ConcurrentTaskProcessor::mergeById(std::vector<std::vector<Item>>& perShard, Key key) {
+    using Cursor = std::pair<int, size_t>;   // (key of the list's head, shard)
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heads;
+    std::vector<size_t> positions(perShard.size(), 0);
+    size_t total = 0;
+    for (size_t shard = 0; shard < perShard.size(); shard++) {
+        total += perShard[shard].size();
+        if (!perShard[shard].empty()) heads.emplace(key(perShard[shard][0]), shard);
+    }
+
+    std::vector<Item> merged;
+    merged.reserve(total);
+    while (!heads.empty()) {
+        size_t shard = heads.top().second;
+        heads.pop();
+        merged.push_back(std::move(perShard[shard][positions[shard]++]));
+        if (positions[shard] < perShard[shard].size()) {
+            heads.emplace(key(perShard[shard][positions[shard]]), shard);
+        }
+    }
+    return merged;
+}
+
+// ============ Task Management ============
+
+int ConcurrentTaskProcessor::addTask(const std::string& title, const std::string& description,
+                                     TaskPriority priority) {
+    size_t index = nextShard.fetch_add(1, std::memory_order_relaxed) % shards.size();
+    Shard& shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    int localId = shard.processor.addTask(title, description, priority);
+    publish(shard);
+    return globalId(index, localId);
+}
+
+size_t ConcurrentTaskProcessor::addTasks(const TaskSpec* specs, size_t count, int* idsOut) {
+    if (count == 0) {
+        return 0;
+    }
+    // Claim `count` round-robin turns at once, then group the specs by the
+    // shard each turn lands on
+    size_t first = nextShard.fetch_add(count, std::memory_order_relaxed);
+    std::vector<std::vector<size_t>> positions(shards.size());
+    for (size_t i = 0; i < count; i++) {
+        positions[(first + i) % shards.size()].push_back(i);
+    }
+
+    std::vector<TaskSpec> group;
+    std::vector<int> localIds;
+    for (size_t index = 0; index < shards.size(); index++) {
+        const std::vector<size_t>& mine = positions[index];
+        if (mine.empty()) continue;
+        group.clear();
+        for (size_t position : mine) {
+            group.push_back(specs[position]);
+        }
+        localIds.assign(mine.size(), 0);
+        // Also run on a throw, for the tasks the shard added before it
+        auto settle = [&] {
+            if (!idsOut) return;
+            for (size_t k = 0; k < mine.size() && localIds[k] != 0; k++) {
+                idsOut[mine[k]] = globalId(index, localIds[k]);
+            }
+        };
+        Shard& shard = *shards[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        try {
+            shard.processor.addTasks(group.data(), group.size(), localIds.data());
+        } catch (...) {
+            publish(shard);
+            settle();
+            throw;
+        }
+        publish(shard);
+        settle();
+    }
+    return count;
+}
+
+bool ConcurrentTaskProcessor::removeTask(int taskId) {
+    size_t index;
+    int localId;
+    if (!locate(taskId, index, localId)) return false;
+    Shard& shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    bool removed = shard.processor.removeTask(localId);
+    publish(shard);
+    return removed;
+}
+
+bool ConcurrentTaskProcessor::updateTaskStatus(int taskId, TaskStatus status) {
+    size_t index;
+    int localId;
+    if (!locate(taskId, index, localId)) return false;
+    Shard& shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    bool updated = shard.processor.updateTaskStatus(localId, status);
+    publish(shard);
+    return updated;
+}
+
+bool ConcurrentTaskProcessor::updateTaskPriority(int taskId, TaskPriority priority) {
+    size_t index;
+    int localId;
+    if (!locate(taskId, index, localId)) return false;
+    Shard& shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    bool updated = shard.processor.updateTaskPriority(localId, priority);
+    publish(shard);
+    return updated;
+}
+
+// ============ Processing ============
+
+void ConcurrentTaskProcessor::processTask(int taskId) {
+    size_t index;
+    int localId;
+    if (!locate(taskId, index, localId)) return;
+    Shard& shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.processor.processTask(localId);
+    publish(shard);
+}
+
+void ConcurrentTaskProcessor::processAll() {
+    for (TaskPriority priority : {TaskPriority::CRITICAL, TaskPriority::HIGH,
+                                  TaskPriority::MEDIUM, TaskPriority::LOW}) {
+        processByPriority(priority);
+    }
+}
+
+void ConcurrentTaskProcessor::processByPriority(TaskPriority priority) {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->processor.processByPriority(priority);
+        publish(*shard);
+    }
+}
+
+// Each shard gets a wrapper that hands the work function a copy of the task
+// carrying its global id
+void ConcurrentTaskProcessor::setWorkFunction(TaskWorkFunction work) {
+    for (size_t index = 0; index < shards.size(); index++) {
+        Shard& shard = *shards[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!work) {
+            shard.processor.setWorkFunction(nullptr);
+            continue;
+        }
+        shard.processor.setWorkFunction([this, index, work](const Task& task) {
+            Task global = task;
+            global.id = globalId(index, task.id);
+            return work(global);
+        });
+    }
+}
+
+// ============ Queries ============
+
+std::optional<Task> ConcurrentTaskProcessor::getTask(int taskId) const {
+    size_t index;
+    int localId;
+    if (!locate(taskId, index, localId)) return std::nullopt;
+    const Shard& shard = *shards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto task = shard.processor.getTask(localId);
+    if (!task) return std::nullopt;
+    Task copy = *task;
+    copy.id = taskId;
+    copy.readyPrev = nullptr;
+    copy.readyNext = nullptr;
+    return copy;
+}
+
+std::vector<Task> ConcurrentTaskProcessor::collectTasks(const TaskQuery& predicate) const {
+    std::vector<std::vector<Task>> perShard(shards.size());
+    for (size_t index = 0; index < shards.size(); index++) {
+        const Shard& shard = *shards[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (int localId : shard.processor.query(predicate)) {
+            Task copy = *shard.processor.getTask(localId);
+            copy.id = globalId(index, localId);
+            copy.readyPrev = nullptr;
+            copy.readyNext = nullptr;
+            perShard[index].push_back(std::move(copy));
+        }
+    }
+    return mergeById(perShard, [](const Task& task) { return task.id; });
+}
+
+std::vector<Task> ConcurrentTaskProcessor::getTasksByStatus(TaskStatus status) const {
+    return collectTasks(TaskQuery::withStatus(status));
+}
+
+std::vector<Task> ConcurrentTaskProcessor::getTasksByPriority(TaskPriority priority) const {
+    return collectTasks(TaskQuery::withPriority(priority));
+}
+
+std::vector<int> ConcurrentTaskProcessor::query(const TaskQuery& predicate) const {
+    std::vector<std::vector<int>> perShard(shards.size());
+    for (size_t index = 0; index < shards.size(); index++) {
+        const Shard& shard = *shards[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        perShard[index] = shard.processor.query(predicate);
+        for (int& id : perShard[index]) {
+            id = globalId(index, id);
+        }
+    }
+    return mergeById(perShard, [](int id) { return id; });
+}
+
+size_t ConcurrentTaskProcessor::countMatching(const TaskQuery& predicate) const {
+    size_t count = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        count += shard->processor.countMatching(predicate);
+    }
+    return count;
+}
+
+// ============ Statistics ============
+
+int ConcurrentTaskProcessor::getTotalCount() const {
+    int total = 0;
+    for (const auto& shard : shards) {
+        for (const auto& count : shard->statusCounts) {
+            total += count.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+int ConcurrentTaskProcessor::getPendingCount() const {
+    int pending = 0;
+    for (const auto& shard : shards) {
+        pending += shard->statusCounts[static_cast<size_t>(TaskStatus::PENDING)].load(
+            std::memory_order_relaxed);
+    }
+    return pending;
+}
+
+int ConcurrentTaskProcessor::getProcessedCount() const {
+    int processed = 0;
+    for (const auto& shard : shards) {
+        processed += shard->processed.load(std::memory_order_relaxed);
+    }
+    return processed;
+}
+
+int ConcurrentTaskProcessor::getFailedCount() const {
+    int failed = 0;
+    for (const auto& shard : shards) {
+        failed += shard->failed.load(std::memory_order_relaxed);
+    }
+    return failed;
+}
+
+// Only levels with at least one task are reported, as in TaskProcessor
+std::map<TaskPriority, int> ConcurrentTaskProcessor::getPriorityStats() const {
+    std::map<TaskPriority, int> stats;
+    for (size_t i = 0; i < kPriorityLevels; i++) {
+        int count = 0;
+        for (const auto& shard : shards) {
+            count += shard->priorityCounts[i].load(std::memory_order_relaxed);
+        }
+        if (count > 0) stats.emplace_hint(stats.end(), static_cast<TaskPriority>(i), count);
+    }
+    return stats;
+}
+
+std::map<TaskStatus, int> ConcurrentTaskProcessor::getStatusStats() const {
+    std::map<TaskStatus, int> stats;
+    for (size_t i = 0; i < kStatusLevels; i++) {
+        int count = 0;
+        for (const auto& shard : shards) {
+            count += shard->statusCounts[i].load(std::memory_order_relaxed);
+        }
+        if (count > 0) stats.emplace_hint(stats.end(), static_cast<TaskStatus>(i), count);
+    }
+    return stats;
+}
+
+void ConcurrentTaskProcessor::clearTasks() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->processor.clearTasks();
+        publish(*shard);
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef CONCURRENT_TASK_PROCESSOR_H
+#define CONCURRENT_TASK_PROCESSOR_H
+
+#include "task_processor.h"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Thread-safe task processor for callers on many threads. Tasks are spread
+// over N shards, each a TaskProcessor behind its own mutex, so operations on
+// different shards never contend. A task's id names its shard:
+//
+//   shard = (id - 1) % N,  shard-local id = (id - 1) / N + 1
+//
+// which keeps every shard's ids dense (its slot table stays O(1)). New tasks
+// go to the shards round-robin. Counters are republished after each
+// mutation and read without taking any lock; queries lock one shard at a
+// time and merge the per-shard results in id order, so they see each shard
+// at a consistent point but not all shards at the same instant.
+//
+// Reads return copies: a Task handed out under a shard lock could change
+// under the caller once the lock is released. Shard log lines carry the
+// shard-local id.
+class ConcurrentTaskProcessor {
+public:
+    // shards = 0 picks one per hardware thread; 1 is a single global mutex
+    explicit ConcurrentTaskProcessor(size_t shards = 0, std::shared_ptr<Logger> sink = nullptr);
+
+    ConcurrentTaskProcessor(const ConcurrentTaskProcessor&) = delete;
+    ConcurrentTaskProcessor& operator=(const ConcurrentTaskProcessor&) = delete;
+
+    // Task management
+    int addTask(const std::string& title, const std::string& description = "",
+                TaskPriority priority = TaskPriority::MEDIUM);
+    bool removeTask(int taskId);
+    bool updateTaskStatus(int taskId, TaskStatus status);
+    bool updateTaskPriority(int taskId, TaskPriority priority);
+    // Spreads the specs over the shards exactly as `count` addTask calls
+    // would, then adds each shard's share with one TaskProcessor::addTasks
+    // under one lock. Ids go to idsOut in spec order (may be null); returns
+    // count. If a shard throws, the tasks added so far stay and have their
+    // idsOut entries set, the others are left as they were (zero-fill
+    // idsOut to tell them apart), and the exception propagates.
+    size_t addTasks(const TaskSpec* specs, size_t count, int* idsOut = nullptr);
+
+    // Processing. processAll drains one priority level across every shard
+    // before the next, so CRITICAL tasks still go first overall. A shard is
+    // locked while its tasks run, so a slow work function only blocks
+    // callers that need the same shard.
+    void processTask(int taskId);
+    void processAll();
+    void processByPriority(TaskPriority priority);
+    // Called with the task's global id; runs under the shard lock, so it
+    // must not call back into this processor
+    void setWorkFunction(TaskWorkFunction work);
+
+    // Queries (copies, ascending id order)
+    std::optional<Task> getTask(int taskId) const;
+    std::vector<Task> getTasksByStatus(TaskStatus status) const;
+    std::vector<Task> getTasksByPriority(TaskPriority priority) const;
+    std::vector<int> query(const TaskQuery& predicate) const;
+    size_t countMatching(const TaskQuery& predicate) const;
+
+    // Statistics, lock-free
+    int getTotalCount() const;
+    int getPendingCount() const;
+    int getProcessedCount() const;
+    int getFailedCount() const;
+    std::map<TaskPriority, int> getPriorityStats() const;
+    std::map<TaskStatus, int> getStatusStats() const;
+
+    void clearTasks();
+    size_t getShardCount() const { return shards.size(); }
+
+private:
+    // One cache line apiece so publishing a shard's counters does not
+    // invalidate its neighbours'
+    struct alignas(64) Shard {
+        explicit Shard(std::shared_ptr<Logger> sink) : processor(std::move(sink)) {}
+
+        mutable std::mutex mutex;
+        TaskProcessor processor;
+        std::array<std::atomic<int>, kStatusLevels> statusCounts{};
+        std::array<std::atomic<int>, kPriorityLevels> priorityCounts{};
+        std::atomic<int> processed{0};
+        std::atomic<int> failed{0};
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<size_t> nextShard;
+
+    bool locate(int taskId, size_t& shard, int& localId) const;
+    int globalId(size_t shard, int localId) const;
+    void publish(Shard& shard);
+    std::vector<Task> collectTasks(const TaskQuery& predicate) const;
+    template <typename Item, typename Key>
+    static std::vector<Item> mergeById(std::vector<std::vector<Item>>& perShard, Key key);
+};
+
+#endif // CONCURRENT_TASK_PROCESSOR_H
@@ -0,0 +1,131 @@
+#include "logger.h"
+#include <chrono>
+
+// ============ StreamLogger Implementation ============
+
+void StreamLogger::write(LogLevel level, const char* message, size_t length) {
+    // One fwrite per line so concurrent writers never interleave mid-line
+    char line[kMaxLogLine + 1];
+    if (length > kMaxLogLine) length = kMaxLogLine;
+    std::memcpy(line, message, length);
+    line[length] = '\n';
+
+    FILE* stream = level >= LogLevel::WARN ? stderr : stdout;
+    std::fwrite(line, 1, length + 1, stream);
+}
+
+void StreamLogger::flush() {
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+// ============ AsyncLogger Implementation ============
+
+AsyncLogger::AsyncLogger(FILE* out, size_t capacity, LogLevel level)
+    : Logger(level), out(out), enqueuePos(0), dequeuePos(0), writtenPos(0),
+      dropped(0), stopping(false) {
+    size_t rounded = 2;
+    while (rounded < capacity) rounded <<= 1;
+    ring.reset(new Record[rounded]);
+    mask = rounded - 1;
+    for (size_t i = 0; i < rounded; i++) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer = std::thread(&AsyncLogger::writerLoop, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+// Bounded MPSC ring in the style of Vyukov's queue: each record's sequence
+// number says whether it is free for the producer claiming `pos` or holds a
+// line ready for the writer.
+void AsyncLogger::write(LogLevel, const char* message, size_t length) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Record* record;
+    while (true) {
+        record = &ring[pos & mask];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    if (length > kMaxLogLine) length = kMaxLogLine;
+    std::memcpy(record->text, message, length);
+    record->text[length] = '\n';
+    record->length = static_cast<uint16_t>(length + 1);
+    record->sequence.store(pos + 1, std::memory_order_release);
+}
+
+size_t AsyncLogger::drainBatch(std::string& batch) {
+    size_t drained = 0;
+    while (true) {
+        Record& record = ring[dequeuePos & mask];
+        if (record.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            break;
+        }
+        batch.append(record.text, record.length);
+        record.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        dequeuePos++;
+        drained++;
+    }
+    return drained;
+}
+
+void AsyncLogger::writerLoop() {
+    std::string batch;
+    batch.reserve((mask + 1) * 64);
+
+    while (true) {
+        batch.clear();
+        if (drainBatch(batch) > 0) {
+            std::fwrite(batch.data(), 1, batch.size(), out);
+            std::fflush(out);
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            writtenPos.store(dequeuePos, std::memory_order_release);
+            written.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (stopping) {
+            return;
+        }
+        wake.wait_for(lock, std::chrono::milliseconds(2));
+    }
+}
+
+void AsyncLogger::flush() {
+    size_t target = enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wake.notify_one();
+    written.wait(lock, [this, target] {
+        return writtenPos.load(std::memory_order_acquire) >= target;
+    });
+}
+
+size_t AsyncLogger::getDroppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// ============ Default Logger ============
+
+std::shared_ptr<Logger> defaultLogger() {
+    static std::shared_ptr<Logger> instance = std::make_shared<StreamLogger>();
+    return instance;
+}
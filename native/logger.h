@@ -0,0 +1,183 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Log severity, lowest first. VERBOSE is the debug level (the name DEBUG is
+// taken by the macro debug builds define).
+enum class LogLevel {
+    VERBOSE,
+    INFO,
+    WARN,
+    ERROR
+};
+
+// Levels below this are compiled out of the TP_LOG_* macros entirely.
+// Debug builds (make debug defines DEBUG) keep everything; release builds
+// drop VERBOSE. Override with -DTASK_LOG_COMPILED_LEVEL=<0..3>.
+#ifndef TASK_LOG_COMPILED_LEVEL
+#ifdef DEBUG
+#define TASK_LOG_COMPILED_LEVEL 0
+#else
+#define TASK_LOG_COMPILED_LEVEL 1
+#endif
+#endif
+
+// Longest message a single log call carries; longer lines are truncated
+constexpr size_t kMaxLogLine = 240;
+
+// Fixed-capacity line builder; formats without touching the heap
+class LogLine {
+public:
+    LogLine() : length(0) {}
+
+    LogLine& operator<<(const char* text) { return append(text, std::strlen(text)); }
+    LogLine& operator<<(std::string_view text) { return append(text.data(), text.size()); }
+    LogLine& operator<<(char c) { return append(&c, 1); }
+    LogLine& operator<<(int value) { return number(value); }
+    LogLine& operator<<(long value) { return number(value); }
+    LogLine& operator<<(long long value) { return number(value); }
+    LogLine& operator<<(unsigned value) { return number(value); }
+    LogLine& operator<<(unsigned long value) { return number(value); }
+    LogLine& operator<<(unsigned long long value) { return number(value); }
+
+    const char* data() const { return buffer; }
+    size_t size() const { return length; }
+
+private:
+    LogLine& append(const char* text, size_t count) {
+        size_t room = kMaxLogLine - length;
+        if (count > room) count = room;
+        std::memcpy(buffer + length, text, count);
+        length += count;
+        return *this;
+    }
+
+    template <typename T>
+    LogLine& number(T value) {
+        auto result = std::to_chars(buffer + length, buffer + kMaxLogLine, value);
+        if (result.ec == std::errc()) {
+            length = static_cast<size_t>(result.ptr - buffer);
+        }
+        return *this;
+    }
+
+    char buffer[kMaxLogLine];
+    size_t length;
+};
+
+// Pluggable log sink. Implementations must accept calls from any thread.
+class Logger {
+public:
+    explicit Logger(LogLevel level = LogLevel::VERBOSE) : minLevel(level) {}
+    virtual ~Logger() = default;
+
+    bool enabled(LogLevel level) const {
+        return level >= minLevel.load(std::memory_order_relaxed);
+    }
+    void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+
+    virtual void write(LogLevel level, const char* message, size_t length) = 0;
+    virtual void flush() {}
+
+private:
+    std::atomic<LogLevel> minLevel;
+};
+
+// Writes each line straight to stdout (WARN and above to stderr) without
+// flushing per line. This is the default sink.
+class StreamLogger : public Logger {
+public:
+    explicit StreamLogger(LogLevel level = LogLevel::VERBOSE) : Logger(level) {}
+
+    void write(LogLevel level, const char* message, size_t length) override;
+    void flush() override;
+};
+
+// Producers copy each line into a bounded lock-free ring and return; a
+// background thread drains the ring and writes lines in batches. When the
+// ring is full the line is dropped and counted rather than blocking.
+class AsyncLogger : public Logger {
+public:
+    explicit AsyncLogger(FILE* out = stdout, size_t capacity = 4096,
+                         LogLevel level = LogLevel::VERBOSE);
+    ~AsyncLogger() override;
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    void write(LogLevel level, const char* message, size_t length) override;
+
+    // Blocks until every line accepted so far has been written
+    void flush() override;
+
+    size_t getDroppedCount() const;
+
+private:
+    struct Record {
+        std::atomic<size_t> sequence;
+        uint16_t length;
+        char text[kMaxLogLine + 1];
+    };
+
+    void writerLoop();
+    size_t drainBatch(std::string& batch);
+
+    FILE* out;
+    std::unique_ptr<Record[]> ring;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos;
+    alignas(64) std::atomic<size_t> writtenPos;
+    std::atomic<size_t> dropped;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::condition_variable written;
+    bool stopping;
+    std::thread writer;
+};
+
+// Process-wide default sink shared by every TaskProcessor
+std::shared_ptr<Logger> defaultLogger();
+
+#define TP_LOG_AT(logger, level, expr)                                   \
+    do {                                                                 \
+        if ((logger).enabled(level)) {                                   \
+            LogLine tpLogLine;                                           \
+            tpLogLine << expr;                                           \
+            (logger).write(level, tpLogLine.data(), tpLogLine.size());   \
+        }                                                                \
+    } while (0)
+
+#if TASK_LOG_COMPILED_LEVEL <= 0
+#define TP_LOG_DEBUG(logger, expr) TP_LOG_AT(logger, LogLevel::VERBOSE, expr)
+#else
+#define TP_LOG_DEBUG(logger, expr) do { } while (0)
+#endif
+
+#if TASK_LOG_COMPILED_LEVEL <= 1
+#define TP_LOG_INFO(logger, expr) TP_LOG_AT(logger, LogLevel::INFO, expr)
+#else
+#define TP_LOG_INFO(logger, expr) do { } while (0)
+#endif
+
+#if TASK_LOG_COMPILED_LEVEL <= 2
+#define TP_LOG_WARN(logger, expr) TP_LOG_AT(logger, LogLevel::WARN, expr)
+#else
+#define TP_LOG_WARN(logger, expr) do { } while (0)
+#endif
+
+#define TP_LOG_ERROR(logger, expr) TP_LOG_AT(logger, LogLevel::ERROR, expr)
+
+#endif // LOGGER_H
@@ -0,0 +1,253 @@
+#include "task_api.h"
+#include "task_processor.h"
+#include <algorithm>
+#include <cstring>
+
+// The handle is the processor itself; C callers only see it opaquely
+struct task_processor_handle {
+    TaskProcessor processor;
+
+    task_processor_handle()
+        : processor(std::make_shared<StreamLogger>(LogLevel::WARN)) {}
+};
+
+namespace {
+
+bool validEnum(int32_t value) {
+    return value >= 0 && value < 4;
+}
+
+TaskQuery maskQuery(uint32_t statusMask, uint32_t priorityMask) {
+    TaskQuery query;
+    query.statusMask = static_cast<uint8_t>(statusMask & TASK_MASK_ALL);
+    query.priorityMask = static_cast<uint8_t>(priorityMask & TASK_MASK_ALL);
+    return query;
+}
+
+} // namespace
+
+// Nothing may unwind into C: every entry point that can allocate catches
+// everything and reports failure through its return value.
+
+// ============ Lifecycle ============
+
+task_processor_handle* task_processor_create(void) {
+    try {
+        return new task_processor_handle();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void task_processor_destroy(task_processor_handle* handle) {
+    delete handle;
+}
+
+void task_processor_set_log_level(task_processor_handle* handle, int level) {
+    if (level < 0) level = 0;
+    if (level > 3) level = 3;
+    handle->processor.getLogger()->setLevel(static_cast<LogLevel>(level));
+}
+
+// ============ Bulk Mutations ============
+
+size_t task_processor_add_tasks(task_processor_handle* handle, size_t count,
+                                const char* strings,
+                                const uint32_t* title_lengths,
+                                const uint32_t* description_lengths,
+                                const int32_t* priorities,
+                                int32_t* ids_out) {
+    for (size_t i = 0; i < count; i++) {
+        ids_out[i] = 0;
+    }
+    // Valid tasks go in as one batch; positions maps them back to ids_out
+    std::vector<TaskSpec> specs;
+    std::vector<size_t> positions;
+    std::vector<int> ids;
+    size_t added = 0;
+    try {
+        specs.reserve(count);
+        positions.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            std::string_view title(strings, title_lengths[i]);
+            strings += title_lengths[i];
+            uint32_t descriptionLength = description_lengths ? description_lengths[i] : 0;
+            std::string_view description(strings, descriptionLength);
+            strings += descriptionLength;
+
+            int32_t priority = priorities ? priorities[i] : static_cast<int32_t>(TaskPriority::MEDIUM);
+            if (validEnum(priority)) {
+                specs.push_back({title, description, static_cast<TaskPriority>(priority)});
+                positions.push_back(i);
+            }
+        }
+
+        ids.assign(specs.size(), 0);
+        added = handle->processor.addTasks(specs.data(), specs.size(), ids.data());
+    } catch (...) {
+        // addTasks writes each id as its task goes in, so the non-zero
+        // prefix names the tasks that were added before the failure
+        added = 0;
+        while (added < ids.size() && ids[added] != 0) {
+            added++;
+        }
+    }
+    for (size_t k = 0; k < added; k++) {
+        ids_out[positions[k]] = ids[k];
+    }
+    return added;
+}
+
+size_t task_processor_update_statuses(task_processor_handle* handle, const int32_t* ids,
+                                      const int32_t* statuses, size_t count) {
+    try {
+        std::vector<TaskStatusUpdate> updates;
+        updates.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            if (validEnum(statuses[i])) {
+                updates.push_back({ids[i], static_cast<TaskStatus>(statuses[i])});
+            }
+        }
+        return handle->processor.updateStatuses(updates.data(), updates.size());
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t task_processor_update_priorities(task_processor_handle* handle, const int32_t* ids,
+                                        const int32_t* priorities, size_t count) {
+    // A throw (allocation, or a failed write-ahead log commit) stops the
+    // batch; the updates applied before it are still counted
+    size_t updated = 0;
+    try {
+        for (size_t i = 0; i < count; i++) {
+            if (validEnum(priorities[i]) &&
+                handle->processor.updateTaskPriority(ids[i], static_cast<TaskPriority>(priorities[i]))) {
+                updated++;
+            }
+        }
+    } catch (...) {
+    }
+    return updated;
+}
+
+size_t task_processor_remove_tasks(task_processor_handle* handle, const int32_t* ids, size_t count) {
+    try {
+        return handle->processor.removeTasks(ids, count);
+    } catch (...) {
+        return 0;
+    }
+}
+
+void task_processor_process_all(task_processor_handle* handle) {
+    try {
+        handle->processor.processAll();
+    } catch (...) {
+    }
+}
+
+// ============ Bulk Queries ============
+
+size_t task_processor_query(task_processor_handle* handle, uint32_t status_mask,
+                            uint32_t priority_mask, int32_t* ids_out, size_t capacity) {
+    try {
+        std::vector<int> ids = handle->processor.query(maskQuery(status_mask, priority_mask));
+        size_t copied = ids.size() < capacity ? ids.size() : capacity;
+        for (size_t i = 0; i < copied; i++) {
+            ids_out[i] = ids[i];
+        }
+        return ids.size();
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t task_processor_get_records(task_processor_handle* handle, const int32_t* ids,
+                                  size_t count, task_record* records_out) {
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        task_record& record = records_out[i];
+        std::memset(&record, 0, sizeof(record));
+        auto view = handle->processor.getTaskView(ids[i]);
+        if (!view) continue;
+        record.id = view->id;
+        record.priority = static_cast<int32_t>(view->priority);
+        record.status = static_cast<int32_t>(view->status);
+        record.created_at = view->createdAt;
+        record.completed_at = view->completedAt;
+        found++;
+    }
+    return found;
+}
+
+size_t task_processor_get_strings(task_processor_handle* handle, const int32_t* ids,
+                                  size_t count, char* buffer, size_t capacity,
+                                  uint32_t* title_lengths, uint32_t* description_lengths) {
+    size_t needed = 0;
+    for (size_t i = 0; i < count; i++) {
+        auto view = handle->processor.getTaskView(ids[i]);
+        title_lengths[i] = view ? static_cast<uint32_t>(view->title.size()) : 0;
+        description_lengths[i] = view ? static_cast<uint32_t>(view->description.size()) : 0;
+        needed += title_lengths[i] + description_lengths[i];
+    }
+    if (needed > capacity) {
+        return needed;
+    }
+    for (size_t i = 0; i < count; i++) {
+        auto view = handle->processor.getTaskView(ids[i]);
+        if (!view) continue;
+        buffer = std::copy(view->title.begin(), view->title.end(), buffer);
+        buffer = std::copy(view->description.begin(), view->description.end(), buffer);
+    }
+    return needed;
+}
+
+size_t task_processor_serialize(task_processor_handle* handle, uint32_t status_mask,
+                                uint32_t priority_mask, char* buffer, size_t capacity) {
+    try {
+        return handle->processor.serializeTasks(buffer, capacity,
+                                                maskQuery(status_mask, priority_mask));
+    } catch (...) {
+        return 0;
+    }
+}
+
+// The JSON writer does not allocate, so neither of these can throw
+size_t task_processor_write_json(task_processor_handle* handle, uint32_t status_mask,
+                                 uint32_t priority_mask, size_t offset, size_t limit,
+                                 char* buffer, size_t capacity) {
+    JsonWriter out(buffer, capacity);
+    handle->processor.writeTasksJson(out, maskQuery(status_mask, priority_mask), offset,
+                                     limit ? limit : SIZE_MAX);
+    return out.size();
+}
+
+int task_processor_write_json_fd(task_processor_handle* handle, uint32_t status_mask,
+                                 uint32_t priority_mask, size_t offset, size_t limit, int fd) {
+    JsonWriter out(fd);
+    handle->processor.writeTasksJson(out, maskQuery(status_mask, priority_mask), offset,
+                                     limit ? limit : SIZE_MAX);
+    return out.flush() ? 0 : -1;
+}
+
+void task_processor_get_counts(task_processor_handle* handle, int32_t* priority_counts,
+                               int32_t* status_counts, int64_t* totals) {
+    const TaskProcessor& processor = handle->processor;
+    // Straight from the maintained counters: nothing allocates, so nothing
+    // can throw
+    if (priority_counts) {
+        for (size_t i = 0; i < kPriorityLevels; i++) {
+            priority_counts[i] = processor.getPriorityCount(static_cast<TaskPriority>(i));
+        }
+    }
+    if (status_counts) {
+        for (size_t i = 0; i < kStatusLevels; i++) {
+            status_counts[i] = processor.getStatusCount(static_cast<TaskStatus>(i));
+        }
+    }
+    if (totals) {
+        totals[0] = processor.getProcessedCount();
+        totals[1] = processor.getFailedCount();
+        totals[2] = processor.getTotalCount();
+    }
+}
@@ -0,0 +1,159 @@
+#ifndef TASK_API_H
+#define TASK_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C interface to TaskProcessor for FFI callers (cgo, JNI, ctypes). Every
+// call works on whole batches held in caller-owned arrays, so one crossing
+// can carry thousands of tasks. A handle is not thread-safe; callers
+// serialize access to it. Priorities and statuses use the C++ enum values:
+// LOW=0 MEDIUM=1 HIGH=2 CRITICAL=3, PENDING=0 IN_PROGRESS=1 COMPLETED=2 FAILED=3.
+
+// ============ Types ============
+
+/**
+ * Opaque processor handle
+ */
+typedef struct task_processor_handle task_processor_handle;
+
+/**
+ * Fixed-width task fields (strings are fetched separately)
+ */
+typedef struct {
+    int32_t id;
+    int32_t priority;
+    int32_t status;
+    int32_t reserved;
+    int64_t created_at;
+    int64_t completed_at;
+} task_record;
+
+/**
+ * Query masks: bit N accepts enum value N
+ */
+#define TASK_MASK_ALL 0x0Fu
+
+// ============ Lifecycle ============
+
+/**
+ * Create a processor that logs warnings and errors only (NULL on failure)
+ */
+task_processor_handle* task_processor_create(void);
+
+/**
+ * Destroy a processor (NULL is ignored)
+ */
+void task_processor_destroy(task_processor_handle* handle);
+
+/**
+ * Set the minimum log level: 0=debug, 1=info, 2=warn, 3=error
+ */
+void task_processor_set_log_level(task_processor_handle* handle, int level);
+
+// ============ Bulk Mutations ============
+
+/**
+ * Add `count` tasks. `strings` holds each task's title followed by its
+ * description, back to back; the length arrays give their sizes in bytes.
+ * `description_lengths` and `priorities` may be NULL (no descriptions,
+ * MEDIUM priority). Writes the new ids to `ids_out` (0 for a task skipped
+ * because of an invalid priority) and returns how many were added.
+ */
+size_t task_processor_add_tasks(task_processor_handle* handle, size_t count,
+                                const char* strings,
+                                const uint32_t* title_lengths,
+                                const uint32_t* description_lengths,
+                                const int32_t* priorities,
+                                int32_t* ids_out);
+
+/**
+ * Set statuses[i] on ids[i]; returns how many tasks were found and updated
+ */
+size_t task_processor_update_statuses(task_processor_handle* handle, const int32_t* ids,
+                                      const int32_t* statuses, size_t count);
+
+/**
+ * Set priorities[i] on ids[i]; returns how many tasks were found and updated
+ */
+size_t task_processor_update_priorities(task_processor_handle* handle, const int32_t* ids,
+                                        const int32_t* priorities, size_t count);
+
+/**
+ * Remove tasks by id; returns how many existed
+ */
+size_t task_processor_remove_tasks(task_processor_handle* handle, const int32_t* ids, size_t count);
+
+/**
+ * Run every pending task (no work function: all succeed)
+ */
+void task_processor_process_all(task_processor_handle* handle);
+
+// ============ Bulk Queries ============
+
+/**
+ * Write the ids of tasks whose status and priority are in the masks to
+ * `ids_out`, ascending, up to `capacity`. Returns the total number of
+ * matches, which may exceed `capacity`.
+ */
+size_t task_processor_query(task_processor_handle* handle, uint32_t status_mask,
+                            uint32_t priority_mask, int32_t* ids_out, size_t capacity);
+
+/**
+ * Fill records_out[i] for ids[i] (id 0 when the task does not exist);
+ * returns how many were found
+ */
+size_t task_processor_get_records(task_processor_handle* handle, const int32_t* ids,
+                                  size_t count, task_record* records_out);
+
+/**
+ * Copy the titles and descriptions of ids[i] into `buffer` in the same
+ * packed layout task_processor_add_tasks takes, and their lengths into the
+ * length arrays (0 for missing tasks). Returns the bytes needed; nothing is
+ * copied into `buffer` when that exceeds `capacity`.
+ */
+size_t task_processor_get_strings(task_processor_handle* handle, const int32_t* ids,
+                                  size_t count, char* buffer, size_t capacity,
+                                  uint32_t* title_lengths, uint32_t* description_lengths);
+
+/**
+ * Encode the tasks matching the masks as one task_wire.h batch (see
+ * native/task_wire.h for the layout). Returns the batch size, writing it
+ * only if it fits in `capacity`; 0 if it exceeds the format's 4 GiB limit.
+ */
+size_t task_processor_serialize(task_processor_handle* handle, uint32_t status_mask,
+                                uint32_t priority_mask, char* buffer, size_t capacity);
+
+/**
+ * Write one page of a JSON task listing (see TaskProcessor::writeTasksJson;
+ * limit 0 means no limit) into `buffer`. Returns the length of the JSON,
+ * which is only complete when it does not exceed `capacity`. No terminator
+ * is written.
+ */
+size_t task_processor_write_json(task_processor_handle* handle, uint32_t status_mask,
+                                 uint32_t priority_mask, size_t offset, size_t limit,
+                                 char* buffer, size_t capacity);
+
+/**
+ * Same listing streamed to a file descriptor; returns 0 on success, -1 if
+ * a write failed
+ */
+int task_processor_write_json_fd(task_processor_handle* handle, uint32_t status_mask,
+                                 uint32_t priority_mask, size_t offset, size_t limit, int fd);
+
+/**
+ * Per-value counts (4 entries each, either may be NULL) and totals
+ * (processed, failed, live tasks; may be NULL)
+ */
+void task_processor_get_counts(task_processor_handle* handle, int32_t* priority_counts,
+                               int32_t* status_counts, int64_t* totals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_API_H
@@ -0,0 +1,176 @@
+// JNI glue for com.taskmanager.util.NativeTaskProcessor over the C API in
+// task_api.h. Arrays are fetched with Get<Type>ArrayElements rather than
+// GetPrimitiveArrayCritical: the processor allocates, logs and, with a
+// write-ahead log that waits for commits, blocks on fsync, none of which is
+// allowed inside a critical region (and all of which would stall the GC).
+// The JVM may pin or copy; either way a batch crosses in one call. When
+// an array cannot be fetched, the JVM has an OutOfMemoryError pending and
+// the entry point returns -1 without touching the processor.
+//
+// The glue trusts nothing about the arrays it is handed: sizes and string
+// lengths are checked against the arrays themselves, and a call that would
+// read past one throws IllegalArgumentException and returns -1.
+
+#include <jni.h>
+#include "task_api.h"
+#include <cstdint>
+
+static_assert(sizeof(jint) == sizeof(int32_t), "jint must be 32 bits");
+
+namespace {
+
+task_processor_handle* fromLong(jlong handle) {
+    return reinterpret_cast<task_processor_handle*>(static_cast<intptr_t>(handle));
+}
+
+// Element count of an array; a null array holds nothing
+jsize lengthOf(JNIEnv* env, jarray array) {
+    return array ? env->GetArrayLength(array) : 0;
+}
+
+jint reject(JNIEnv* env, const char* message) {
+    jclass type = env->FindClass("java/lang/IllegalArgumentException");
+    if (type) env->ThrowNew(type, message);
+    return -1;
+}
+
+jbyte* getElements(JNIEnv* env, jbyteArray array) { return env->GetByteArrayElements(array, nullptr); }
+jint* getElements(JNIEnv* env, jintArray array) { return env->GetIntArrayElements(array, nullptr); }
+
+void releaseElements(JNIEnv* env, jbyteArray array, jbyte* data, jint mode) {
+    env->ReleaseByteArrayElements(array, data, mode);
+}
+void releaseElements(JNIEnv* env, jintArray array, jint* data, jint mode) {
+    env->ReleaseIntArrayElements(array, data, mode);
+}
+
+// A primitive array's elements for the lifetime of the scope (null stays
+// null). Modified arrays are copied back on release; others are not.
+template <typename Array, typename Element>
+class Elements {
+public:
+    Elements(JNIEnv* env, Array array, bool modified = false)
+        : env(env), array(array), data(nullptr), mode(modified ? 0 : JNI_ABORT) {
+        if (array) data = getElements(env, array);
+    }
+    ~Elements() {
+        if (data) releaseElements(env, array, data, mode);
+    }
+    Elements(const Elements&) = delete;
+    Elements& operator=(const Elements&) = delete;
+
+    // False if a non-null array could not be fetched
+    bool ok() const { return !array || data; }
+
+    template <typename T>
+    T* as() const { return reinterpret_cast<T*>(data); }
+
+private:
+    JNIEnv* env;
+    Array array;
+    Element* data;
+    jint mode;
+};
+
+using IntElements = Elements<jintArray, jint>;
+using ByteElements = Elements<jbyteArray, jbyte>;
+
+} // namespace
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_taskmanager_util_NativeTaskProcessor_createNative(JNIEnv*, jclass) {
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(task_processor_create()));
+}
+
+JNIEXPORT void JNICALL
+Java_com_taskmanager_util_NativeTaskProcessor_destroyNative(JNIEnv*, jclass, jlong handle) {
+    task_processor_destroy(fromLong(handle));
+}
+
+JNIEXPORT jint JNICALL
+Java_com_taskmanager_util_NativeTaskProcessor_addTasksNative(
+        JNIEnv* env, jclass, jlong handle, jbyteArray strings, jintArray titleLengths,
+        jintArray descriptionLengths, jintArray priorities, jintArray idsOut) {
+    // Descriptions and priorities are optional (null), titles are not
+    jsize count = lengthOf(env, idsOut);
+    if (lengthOf(env, titleLengths) < count ||
+        (descriptionLengths && lengthOf(env, descriptionLengths) < count) ||
+        (priorities && lengthOf(env, priorities) < count)) {
+        return reject(env, "length and priority arrays are shorter than idsOut");
+    }
+    ByteElements packed(env, strings);
+    IntElements titles(env, titleLengths);
+    IntElements descriptions(env, descriptionLengths);
+    IntElements prios(env, priorities);
+    IntElements ids(env, idsOut, true);
+    if (!packed.ok() || !titles.ok() || !descriptions.ok() || !prios.ok() || !ids.ok()) {
+        return -1;
+    }
+    int64_t total = 0;
+    for (jsize i = 0; i < count; i++) {
+        jint title = titles.as<jint>()[i];
+        jint description = descriptionLengths ? descriptions.as<jint>()[i] : 0;
+        if (title < 0 || description < 0) {
+            return reject(env, "negative string length");
+        }
+        total += static_cast<int64_t>(title) + description;
+    }
+    if (total > lengthOf(env, strings)) {
+        return reject(env, "string lengths exceed the packed strings");
+    }
+    return static_cast<jint>(task_processor_add_tasks(
+        fromLong(handle), static_cast<size_t>(count), packed.as<const char>(),
+        titles.as<const uint32_t>(), descriptions.as<const uint32_t>(),
+        prios.as<const int32_t>(), ids.as<int32_t>()));
+}
+
+JNIEXPORT jint JNICALL
+Java_com_taskmanager_util_NativeTaskProcessor_updateStatusesNative(
+        JNIEnv* env, jclass, jlong handle, jintArray idArray, jintArray statusArray) {
+    jsize count = lengthOf(env, idArray);
+    if (lengthOf(env, statusArray) < count) {
+        return reject(env, "statuses is shorter than ids");
+    }
+    IntElements ids(env, idArray);
+    IntElements statuses(env, statusArray);
+    if (!ids.ok() || !statuses.ok()) {
+        return -1;
+    }
+    return static_cast<jint>(task_processor_update_statuses(
+        fromLong(handle), ids.as<const int32_t>(), statuses.as<const int32_t>(),
+        static_cast<size_t>(count)));
+}
+
+JNIEXPORT jint JNICALL
+Java_com_taskmanager_util_NativeTaskProcessor_removeTasksNative(
+        JNIEnv* env, jclass, jlong handle, jintArray idArray) {
+    jsize count = lengthOf(env, idArray);
+    IntElements ids(env, idArray);
+    if (!ids.ok()) {
+        return -1;
+    }
+    return static_cast<jint>(task_processor_remove_tasks(
+        fromLong(handle), ids.as<const int32_t>(), static_cast<size_t>(count)));
+}
+
+JNIEXPORT void JNICALL
+Java_com_taskmanager_util_NativeTaskProcessor_processAllNative(JNIEnv*, jclass, jlong handle) {
+    task_processor_process_all(fromLong(handle));
+}
+
+JNIEXPORT jint JNICALL
+Java_com_taskmanager_util_NativeTaskProcessor_queryNative(
+        JNIEnv* env, jclass, jlong handle, jint statusMask, jint priorityMask, jintArray idsOut) {
+    jsize capacity = lengthOf(env, idsOut);
+    IntElements ids(env, idsOut, true);
+    if (!ids.ok()) {
+        return -1;
+    }
+    return static_cast<jint>(task_processor_query(
+        fromLong(handle), static_cast<uint32_t>(statusMask), static_cast<uint32_t>(priorityMask),
+        ids.as<int32_t>(), static_cast<size_t>(capacity)));
+}
+
+} // extern "C"
@@ -0,0 +1,92 @@
+#include "task_ingest.h"
+#include "concurrent_task_processor.h"
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Tasks popped from the ring per round before they are handed to the
+// processor, so the ring frees its cells for producers early
+constexpr size_t kDrainChunk = 256;
+
+// Pops up to maxBatch submissions in chunks and adds each chunk with one
+// addTasks call. If that throws, the chunk's submissions it did not add
+// (id still 0) are counted in `dropped` before the exception propagates.
+template <typename Processor>
+size_t drainChunks(MpmcRing<TaskSubmission>& ring, size_t maxBatch, Processor& processor,
+                   std::atomic<uint64_t>& dropped) {
+    std::vector<TaskSubmission> chunk;
+    std::vector<TaskSpec> specs;
+    std::vector<int> ids;
+    chunk.reserve(std::min(maxBatch, kDrainChunk));
+    size_t drained = 0;
+    while (drained < maxBatch) {
+        chunk.clear();
+        TaskSubmission submission;
+        while (chunk.size() < kDrainChunk && drained + chunk.size() < maxBatch &&
+               ring.tryPop(submission)) {
+            chunk.push_back(std::move(submission));
+        }
+        if (chunk.empty()) break;
+        specs.clear();
+        for (const TaskSubmission& queued : chunk) {
+            specs.push_back({queued.title, queued.description, queued.priority});
+        }
+        ids.assign(chunk.size(), 0);
+        try {
+            processor.addTasks(specs.data(), specs.size(), ids.data());
+        } catch (...) {
+            dropped.fetch_add(static_cast<uint64_t>(std::count(ids.begin(), ids.end(), 0)),
+                              std::memory_order_relaxed);
+            throw;
+        }
+        drained += chunk.size();
+    }
+    return drained;
+}
+
+} // namespace
+
+TaskIngestQueue::TaskIngestQueue(size_t capacity)
+    : ring(capacity), rejected(0), dropped(0) {}
+
+bool TaskIngestQueue::trySubmit(std::string title, std::string description, TaskPriority priority) {
+    TaskSubmission submission{std::move(title), std::move(description), priority};
+    if (ring.tryPush(std::move(submission))) return true;
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Spins briefly, then yields, then sleeps with doubling waits (capped at
+// 1 ms) so a producer stuck behind a slow consumer does not burn its core
+bool TaskIngestQueue::submitFor(std::chrono::nanoseconds timeout, std::string title,
+                                std::string description, TaskPriority priority) {
+    TaskSubmission submission{std::move(title), std::move(description), priority};
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::microseconds pause(1);
+    for (int attempt = 0;; attempt++) {
+        if (ring.tryPush(std::move(submission))) return true;
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) break;
+        if (attempt < 16) {
+            continue;
+        } else if (attempt < 32) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(pause, deadline - now));
+            if (pause < std::chrono::milliseconds(1)) pause *= 2;
+        }
+    }
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+size_t TaskIngestQueue::drainInto(TaskProcessor& processor, size_t maxBatch) {
+    return drainChunks(ring, maxBatch, processor, dropped);
+}
+
+size_t TaskIngestQueue::drainInto(ConcurrentTaskProcessor& processor, size_t maxBatch) {
+    return drainChunks(ring, maxBatch, processor, dropped);
+}
@@ -0,0 +1,160 @@
+#ifndef TASK_INGEST_H
+#define TASK_INGEST_H
+
+#include "task_processor.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class ConcurrentTaskProcessor;
+
+// Bounded multi-producer/multi-consumer ring (Vyukov's bounded MPMC queue).
+// Each cell carries a sequence number that tells producers and consumers
+// whose turn it is, so a push or pop is one CAS on the shared position plus
+// a release store on the cell; nobody ever waits on a lock. Capacity is
+// rounded up to a power of two. T must be default-constructible and movable.
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(size_t capacity = 1024)
+        : enqueuePos(0), dequeuePos(0) {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded <<= 1;
+        mask = rounded - 1;
+        cells.reset(new Cell[rounded]);
+        for (size_t i = 0; i < rounded; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    // False when the ring is full; `item` is left untouched in that case
+    bool tryPush(T&& item) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // False when the ring is empty
+    bool tryPop(T& out) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->value);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Approximate when other threads are active
+    size_t size() const {
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+};
+
+// A task waiting in the ingest ring
+struct TaskSubmission {
+    std::string title;
+    std::string description;
+    TaskPriority priority = TaskPriority::MEDIUM;
+};
+
+// Front door for bursty ingest from many threads. Producers hand task
+// descriptors to a bounded lock-free ring and return at once; a consumer
+// later drains the ring into a processor in batches, so producers never
+// queue up behind the processor. Ids are assigned when a task is drained.
+//
+// When the ring is full, trySubmit fails straight away and submitFor backs
+// off until space appears or its timeout expires; either way the caller
+// learns it is outrunning the consumer and can shed or slow down.
+// Both directions are safe from any number of threads.
+class TaskIngestQueue {
+public:
+    explicit TaskIngestQueue(size_t capacity = 4096);
+
+    TaskIngestQueue(const TaskIngestQueue&) = delete;
+    TaskIngestQueue& operator=(const TaskIngestQueue&) = delete;
+
+    // Producers
+    bool trySubmit(std::string title, std::string description = "",
+                   TaskPriority priority = TaskPriority::MEDIUM);
+    bool submitFor(std::chrono::nanoseconds timeout, std::string title,
+                   std::string description = "", TaskPriority priority = TaskPriority::MEDIUM);
+
+    // Consumers. Move up to maxBatch queued tasks into the processor in
+    // submission order (per producer) and return how many were added. Tasks
+    // are popped in chunks and each chunk goes in with one addTasks call
+    // (one lock per shard for a ConcurrentTaskProcessor).
+    // TaskProcessor is single-threaded, so one consumer at a time may drain
+    // into it; any number may drain into a ConcurrentTaskProcessor.
+    //
+    // If the processor throws (allocation failure, or a failed write-ahead
+    // log commit), the exception propagates. Tasks added before it stay;
+    // the rest of the popped chunk has already left the ring and is counted
+    // in getDroppedCount(). Submissions still in the ring are untouched.
+    size_t drainInto(TaskProcessor& processor, size_t maxBatch = SIZE_MAX);
+    size_t drainInto(ConcurrentTaskProcessor& processor, size_t maxBatch = SIZE_MAX);
+
+    size_t capacity() const { return ring.capacity(); }
+    size_t size() const { return ring.size(); }   // approximate
+    // Submissions turned away because the ring was full (submitFor counts
+    // once per call that timed out)
+    uint64_t getRejectedCount() const { return rejected.load(std::memory_order_relaxed); }
+    // Submissions lost because a drain threw before adding them
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    MpmcRing<TaskSubmission> ring;
+    std::atomic<uint64_t> rejected;
+    std::atomic<uint64_t> dropped;
+};
+
+#endif // TASK_INGEST_H
@@ -0,0 +1,304 @@
+#include "task_json.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr const char* kPriorityNames[] = {"low", "medium", "high", "critical"};
+constexpr const char* kStatusNames[] = {"pending", "in_progress", "completed", "failed"};
+
+// Escape class per byte: 0 = copy as is, 'u' = \u00XX, else the letter
+// after the backslash
+struct EscapeTable {
+    char code[256];
+
+    constexpr EscapeTable() : code() {
+        for (int c = 0; c < 0x20; c++) code[c] = 'u';
+        code[static_cast<unsigned char>('"')] = '"';
+        code[static_cast<unsigned char>('\\')] = '\\';
+        code[static_cast<unsigned char>('\b')] = 'b';
+        code[static_cast<unsigned char>('\f')] = 'f';
+        code[static_cast<unsigned char>('\n')] = 'n';
+        code[static_cast<unsigned char>('\r')] = 'r';
+        code[static_cast<unsigned char>('\t')] = 't';
+    }
+};
+
+constexpr EscapeTable kEscapes;
+
+} // namespace
+
+JsonWriter::JsonWriter(int fd)
+    : fd(fd), out(scratch), capacity(sizeof(scratch)), used(0), produced(0),
+      failed(false), hasElement(), depth(0), afterKey(false) {
+}
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity)
+    : fd(-1), out(buffer), capacity(capacity), used(0), produced(0),
+      failed(false), hasElement(), depth(0), afterKey(false) {
+}
+
+JsonWriter::~JsonWriter() {
+    flush();
+}
+
+// ============ Output ============
+
+void JsonWriter::drain() {
+#ifdef _WIN32
+    const char* data = out;
+    size_t left = used;
+    while (left > 0 && !failed) {
+        int written = _write(fd, data, static_cast<unsigned>(std::min<size_t>(left, INT_MAX)));
+        if (written <= 0) failed = true;
+        else { data += written; left -= static_cast<size_t>(written); }
+    }
+#else
+    const char* data = out;
+    size_t left = used;
+    while (left > 0 && !failed) {
+        ssize_t written = ::write(fd, data, left);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) failed = true;
+        else { data += written; left -= static_cast<size_t>(written); }
+    }
+#endif
+    used = 0;
+}
+
+bool JsonWriter::flush() {
+    if (fd >= 0 && used > 0) {
+        drain();
+    }
+    return !failed;
+}
+
+void JsonWriter::put(char c) {
+    produced++;
+    if (used == capacity) {
+        if (fd < 0) {
+            failed = true;
+            return;
+        }
+        drain();
+    }
+    out[used++] = c;
+}
+
+void JsonWriter::put(const char* data, size_t length) {
+    produced += length;
+    while (length > 0) {
+        if (used == capacity) {
+            if (fd < 0) {
+                failed = true;
+                return;
+            }
+            drain();
+        }
+        size_t chunk = std::min(length, capacity - used);
+        std::memcpy(out + used, data, chunk);
+        used += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+// Copies runs of plain bytes in one go and escapes the rest. When the
+// worst case (every byte as \u00XX) fits, it writes straight into the
+// buffer without per-piece capacity checks.
+void JsonWriter::putEscaped(std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    size_t worst = text.size() * 6 + 2;
+    if (capacity - used < worst && fd >= 0 && used > 0) {
+        drain();
+    }
+    if (capacity - used >= worst) {
+        char* start = out + used;
+        char* dst = start;
+        *dst++ = '"';
+        const char* p = text.data();
+        const char* end = p + text.size();
+        while (p < end) {
+            const char* run = p;
+            while (p < end && kEscapes.code[static_cast<unsigned char>(*p)] == 0) p++;
+            std::memcpy(dst, run, static_cast<size_t>(p - run));
+            dst += p - run;
+            if (p == end) break;
+            char code = kEscapes.code[static_cast<unsigned char>(*p)];
+            if (code == 'u') {
+                unsigned char byte = static_cast<unsigned char>(*p);
+                dst[0] = '\\';
+                dst[1] = 'u';
+                dst[2] = '0';
+                dst[3] = '0';
+                dst[4] = hex[byte >> 4];
+                dst[5] = hex[byte & 0xF];
+                dst += 6;
+            } else {
+                dst[0] = '\\';
+                dst[1] = code;
+                dst += 2;
+            }
+            p++;
+        }
+        *dst++ = '"';
+        used += static_cast<size_t>(dst - start);
+        produced += static_cast<size_t>(dst - start);
+        return;
+    }
+
+    put('"');
+    const char* run = text.data();
+    const char* end = text.data() + text.size();
+    for (const char* p = run; p < end; p++) {
+        char code = kEscapes.code[static_cast<unsigned char>(*p)];
+        if (code == 0) continue;
+        put(run, static_cast<size_t>(p - run));
+        if (code == 'u') {
+            unsigned char c = static_cast<unsigned char>(*p);
+            char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+            put(escape, sizeof(escape));
+        } else {
+            char escape[2] = {'\\', code};
+            put(escape, sizeof(escape));
+        }
+        run = p + 1;
+    }
+    put(run, static_cast<size_t>(end - run));
+    put('"');
+}
+
+// ============ Structure ============
+
+void JsonWriter::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (depth > 0 && depth <= kMaxDepth) {
+        if (hasElement[depth - 1]) put(',');
+        hasElement[depth - 1] = true;
+    }
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    put('{');
+    if (depth < kMaxDepth) hasElement[depth] = false;
+    else failed = true;
+    depth++;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    put('}');
+    if (depth > 0) depth--;
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    put('[');
+    if (depth < kMaxDepth) hasElement[depth] = false;
+    else failed = true;
+    depth++;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    put(']');
+    if (depth > 0) depth--;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    putEscaped(name);
+    put(':');
+    afterKey = true;
+    return *this;
+}
+
+// For names known not to need escaping: `quoted` is the key already in
+// quotes with its colon
+JsonWriter& JsonWriter::rawKey(std::string_view quoted) {
+    separate();
+    put(quoted.data(), quoted.size());
+    afterKey = true;
+    return *this;
+}
+
+// ============ Values ============
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    separate();
+    putEscaped(text);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(long long number) {
+    separate();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    put(digits, static_cast<size_t>(result.ptr - digits));
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(size_t number) {
+    separate();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    put(digits, static_cast<size_t>(result.ptr - digits));
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    if (!std::isfinite(number)) {
+        return null();
+    }
+    separate();
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    put(digits, static_cast<size_t>(result.ptr - digits));
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    if (flag) put("true", 4);
+    else put("false", 5);
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    put("null", 4);
+    return *this;
+}
+
+JsonWriter& JsonWriter::task(const TaskView& view) {
+    size_t priority = static_cast<size_t>(view.priority);
+    size_t status = static_cast<size_t>(view.status);
+    beginObject();
+    rawKey("\"id\":").value(view.id);
+    rawKey("\"title\":").value(view.title);
+    rawKey("\"description\":").value(view.description);
+    rawKey("\"priority\":").value(priority < 4 ? kPriorityNames[priority] : "unknown");
+    rawKey("\"status\":").value(status < 4 ? kStatusNames[status] : "unknown");
+    rawKey("\"completed\":").value(status == 2);
+    rawKey("\"created_at\":").value(view.createdAt);
+    rawKey("\"completed_at\":");
+    if (view.completedAt != 0) value(view.completedAt);
+    else null();
+    return endObject();
+}
@@ -0,0 +1,84 @@
+#ifndef TASK_JSON_H
+#define TASK_JSON_H
+
+#include "task_store.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Streaming JSON writer. Output goes through a fixed internal buffer to a
+// file descriptor, or straight into a caller buffer; nothing is allocated,
+// and numbers are formatted with std::to_chars. Commas between members and
+// elements are inserted automatically.
+//
+//   JsonWriter out(STDOUT_FILENO);
+//   out.beginObject().key("count").value(3).endObject();
+//
+// Strings are escaped per RFC 8259; bytes >= 0x80 pass through, so UTF-8
+// input stays UTF-8.
+class JsonWriter {
+public:
+    static constexpr size_t kMaxDepth = 32;
+
+    // Flushes to `fd` whenever the internal buffer fills and on destruction
+    explicit JsonWriter(int fd);
+    // Writes into [buffer, buffer + capacity). Output past the end is
+    // dropped but still counted, so size() is the capacity a retry needs.
+    JsonWriter(char* buffer, size_t capacity);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(long long number);
+    JsonWriter& value(int number) { return value(static_cast<long long>(number)); }
+    JsonWriter& value(size_t number);
+    // Shortest round-trip form; NaN and infinities become null
+    JsonWriter& value(double number);
+    JsonWriter& value(bool flag);
+    JsonWriter& null();
+
+    // One task object:
+    // {"id":1,"title":"...","description":"...","priority":"high",
+    //  "status":"pending","completed":false,"created_at":...,"completed_at":null}
+    // Enum names are lower case to match the Python backend's models.
+    JsonWriter& task(const TaskView& view);
+
+    // Pushes buffered output to the descriptor (no-op in buffer mode)
+    bool flush();
+
+    // Bytes produced so far, including any dropped for lack of room
+    size_t size() const { return produced; }
+    // False once a descriptor write failed or a caller buffer overflowed
+    bool ok() const { return !failed; }
+
+private:
+    void separate();
+    JsonWriter& rawKey(std::string_view quoted);
+    void put(char c);
+    void put(const char* data, size_t length);
+    void putEscaped(std::string_view text);
+    void drain();
+
+    int fd;
+    char* out;
+    size_t capacity;
+    size_t used;
+    size_t produced;
+    bool failed;
+    // Per nesting level: has the container emitted an element yet
+    bool hasElement[kMaxDepth];
+    size_t depth;
+    bool afterKey;
+    char scratch[8192];
+};
+
+#endif // TASK_JSON_H
@@ -0,0 +1,264 @@
+#include "task_metrics.h"
+#include "task_processor.h"
+#include "task_json.h"
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
+static_assert(kPriorityLevels == 4, "metrics counters are sized for four priorities");
+
+namespace {
+
+constexpr const char* kPriorityLabels[] = {"low", "medium", "high", "critical"};
+constexpr const char* kMetricNames[] = {"add", "update", "process", "query", "queue_wait", "service"};
+constexpr double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void appendNumber(std::string& out, double value) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, static_cast<size_t>(result.ptr - digits));
+}
+
+void appendNumber(std::string& out, uint64_t value) {
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, static_cast<size_t>(result.ptr - digits));
+}
+
+} // namespace
+
+// ============ LatencyHistogram Implementation ============
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+    if (count == 0) return 0;
+    double wanted = std::ceil(q * static_cast<double>(count));
+    uint64_t rank = wanted < 1 ? 1 : static_cast<uint64_t>(wanted);
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            uint64_t highest = LatencyHistogram::bucketHighest(bucket);
+            return highest < max ? highest : max;
+        }
+    }
+    return max;
+}
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+// Values below 64 get a bucket each; above that, the top kSubBucketBits + 1
+// significant bits pick the bucket within the value's power of two
+size_t LatencyHistogram::bucketFor(uint64_t value) {
+    const uint64_t limit = (uint64_t(1) << kMaxValueBits) - 1;
+    if (value > limit) value = limit;
+    if (value < (uint64_t(1) << kSubBucketBits)) return static_cast<size_t>(value);
+    unsigned magnitude = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = magnitude - kSubBucketBits;
+    return (static_cast<size_t>(shift + 1) << kSubBucketBits) +
+           static_cast<size_t>((value >> shift) - (uint64_t(1) << kSubBucketBits));
+}
+
+uint64_t LatencyHistogram::bucketLowest(size_t bucket) {
+    size_t block = bucket >> kSubBucketBits;
+    uint64_t sub = bucket & ((size_t(1) << kSubBucketBits) - 1);
+    if (block == 0) return sub;
+    return ((uint64_t(1) << kSubBucketBits) + sub) << (block - 1);
+}
+
+uint64_t LatencyHistogram::bucketHighest(size_t bucket) {
+    size_t block = bucket >> kSubBucketBits;
+    uint64_t width = block == 0 ? 1 : uint64_t(1) << (block - 1);
+    return bucketLowest(bucket) + width - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanos, std::memory_order_relaxed);
+    uint64_t seen = min.load(std::memory_order_relaxed);
+    while (nanos < seen && !min.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {
+    }
+    seen = max.load(std::memory_order_relaxed);
+    while (nanos > seen && !max.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+    min.store(UINT64_MAX, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+// The count is the sum of the copied buckets, so percentiles stay
+// consistent even while other threads record
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot copy;
+    copy.buckets.resize(kBucketCount);
+    for (size_t i = 0; i < kBucketCount; i++) {
+        copy.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        copy.count += copy.buckets[i];
+    }
+    copy.sum = sum.load(std::memory_order_relaxed);
+    copy.max = max.load(std::memory_order_relaxed);
+    copy.min = copy.count ? min.load(std::memory_order_relaxed) : 0;
+    return copy;
+}
+
+// ============ TaskMetrics Implementation ============
+
+const char* latencyMetricName(LatencyMetric metric) {
+    size_t index = static_cast<size_t>(metric);
+    return index < kLatencyMetrics ? kMetricNames[index] : "unknown";
+}
+
+TaskMetrics::TaskMetrics() : latencyOn(false) {
+    reset();
+}
+
+void TaskMetrics::countAdded(TaskPriority priority, uint64_t count) {
+    added[static_cast<size_t>(priority)].fetch_add(count, std::memory_order_relaxed);
+}
+
+void TaskMetrics::countOutcome(TaskPriority priority, bool success) {
+    auto& counters = success ? completed : failed;
+    counters[static_cast<size_t>(priority)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void TaskMetrics::reset() {
+    for (auto& histogram : histograms) {
+        histogram.reset();
+    }
+    for (size_t i = 0; i < kPriorityLevels; i++) {
+        added[i].store(0, std::memory_order_relaxed);
+        completed[i].store(0, std::memory_order_relaxed);
+        failed[i].store(0, std::memory_order_relaxed);
+    }
+    startedAt.store(steadyNanos(), std::memory_order_relaxed);
+}
+
+TaskMetricsSnapshot TaskMetrics::snapshot() const {
+    TaskMetricsSnapshot copy;
+    copy.uptimeSeconds = static_cast<double>(steadyNanos() - startedAt.load(std::memory_order_relaxed)) / 1e9;
+    copy.latencyEnabled = latencyEnabled();
+    for (size_t i = 0; i < kLatencyMetrics; i++) {
+        copy.latency[i] = histograms[i].snapshot();
+    }
+    for (size_t i = 0; i < kPriorityLevels; i++) {
+        copy.added[i] = added[i].load(std::memory_order_relaxed);
+        copy.completed[i] = completed[i].load(std::memory_order_relaxed);
+        copy.failed[i] = failed[i].load(std::memory_order_relaxed);
+    }
+    return copy;
+}
+
+// ============ Export ============
+
+std::string TaskMetricsSnapshot::toPrometheus(std::string_view prefix) const {
+    std::string out;
+    std::string base(prefix);
+
+    out += "# HELP " + base + "_uptime_seconds Time since the metrics were started or reset\n";
+    out += "# TYPE " + base + "_uptime_seconds gauge\n";
+    out += base + "_uptime_seconds ";
+    appendNumber(out, uptimeSeconds);
+    out += '\n';
+
+    struct Counter {
+        const char* name;
+        const char* help;
+        const std::array<uint64_t, 4>& values;
+    };
+    const Counter counters[] = {
+        {"_tasks_added_total", "Tasks added", added},
+        {"_tasks_completed_total", "Tasks processed successfully", completed},
+        {"_tasks_failed_total", "Tasks whose processing failed", failed},
+    };
+    for (const Counter& counter : counters) {
+        out += "# HELP " + base + counter.name + " " + counter.help + ", by priority\n";
+        out += "# TYPE " + base + counter.name + " counter\n";
+        for (size_t i = 0; i < kPriorityLevels; i++) {
+            out += base + counter.name + "{priority=\"" + kPriorityLabels[i] + "\"} ";
+            appendNumber(out, counter.values[i]);
+            out += '\n';
+        }
+    }
+
+    // Operations share one family with an operation label; queue wait and
+    // service time get their own
+    auto summary = [&](const std::string& family, const std::string& labels,
+                       const HistogramSnapshot& histogram) {
+        for (double q : kQuantiles) {
+            out += family + "{" + labels + (labels.empty() ? "" : ",") + "quantile=\"";
+            appendNumber(out, q);
+            out += "\"} ";
+            appendNumber(out, static_cast<double>(histogram.percentile(q)) / 1e9);
+            out += '\n';
+        }
+        std::string selector = labels.empty() ? "" : "{" + labels + "}";
+        out += family + "_sum" + selector + " ";
+        appendNumber(out, static_cast<double>(histogram.sum) / 1e9);
+        out += '\n';
+        out += family + "_count" + selector + " ";
+        appendNumber(out, histogram.count);
+        out += '\n';
+    };
+    std::string operations = base + "_operation_seconds";
+    out += "# HELP " + operations + " TaskProcessor call latency\n";
+    out += "# TYPE " + operations + " summary\n";
+    for (LatencyMetric metric : {LatencyMetric::ADD, LatencyMetric::UPDATE,
+                                 LatencyMetric::PROCESS, LatencyMetric::QUERY}) {
+        summary(operations, std::string("operation=\"") + latencyMetricName(metric) + "\"",
+                latency[static_cast<size_t>(metric)]);
+    }
+    std::string wait = base + "_queue_wait_seconds";
+    out += "# HELP " + wait + " Time from task creation to the start of its run\n";
+    out += "# TYPE " + wait + " summary\n";
+    summary(wait, "", latency[static_cast<size_t>(LatencyMetric::QUEUE_WAIT)]);
+    std::string service = base + "_service_seconds";
+    out += "# HELP " + service + " Time from the start of a run to its completion\n";
+    out += "# TYPE " + service + " summary\n";
+    summary(service, "", latency[static_cast<size_t>(LatencyMetric::SERVICE)]);
+    return out;
+}
+
+void TaskMetricsSnapshot::writeJson(JsonWriter& out) const {
+    out.beginObject();
+    out.key("uptime_seconds").value(uptimeSeconds);
+    out.key("latency_enabled").value(latencyEnabled);
+    out.key("counters").beginObject();
+    const std::pair<const char*, const std::array<uint64_t, 4>*> counters[] = {
+        {"added", &added}, {"completed", &completed}, {"failed", &failed}};
+    for (const auto& [name, values] : counters) {
+        out.key(name).beginObject();
+        for (size_t i = 0; i < kPriorityLevels; i++) {
+            out.key(kPriorityLabels[i]).value(static_cast<size_t>((*values)[i]));
+        }
+        out.endObject();
+    }
+    out.endObject();
+    out.key("latency").beginObject();
+    for (size_t i = 0; i < kLatencyMetrics; i++) {
+        const HistogramSnapshot& histogram = latency[i];
+        out.key(kMetricNames[i]).beginObject();
+        out.key("count").value(static_cast<size_t>(histogram.count));
+        out.key("mean_ns").value(histogram.mean());
+        out.key("min_ns").value(static_cast<size_t>(histogram.min));
+        out.key("p50_ns").value(static_cast<size_t>(histogram.percentile(0.5)));
+        out.key("p90_ns").value(static_cast<size_t>(histogram.percentile(0.9)));
+        out.key("p99_ns").value(static_cast<size_t>(histogram.percentile(0.99)));
+        out.key("p999_ns").value(static_cast<size_t>(histogram.percentile(0.999)));
+        out.key("max_ns").value(static_cast<size_t>(histogram.max));
+        out.endObject();
+    }
+    out.endObject();
+    out.endObject();
+}
@@ -0,0 +1,117 @@
+#ifndef TASK_METRICS_H
+#define TASK_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class TaskPriority;
+class JsonWriter;
+
+// Point-in-time copy of a LatencyHistogram. Values are nanoseconds.
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    std::vector<uint64_t> buckets;
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0; }
+    // Highest value equivalent to the q-quantile's bucket (within 1/32 of
+    // the true value), capped at max; 0 when empty
+    uint64_t percentile(double q) const;
+};
+
+// Log-linear histogram in the HdrHistogram layout: every power of two is
+// split into 32 equal buckets, so a recorded value is kept to within ~3%.
+// Values from 0 ns to ~3.2 days are covered; larger ones land in the last
+// bucket. Recording is a few relaxed atomic adds, safe from any thread
+// and never blocked by a concurrent snapshot().
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr unsigned kMaxValueBits = 48;
+    static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) << kSubBucketBits;
+
+    LatencyHistogram();
+
+    void record(uint64_t nanos);
+    void reset();
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucketFor(uint64_t value);
+    static uint64_t bucketLowest(size_t bucket);
+    static uint64_t bucketHighest(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+};
+
+// Latencies TaskProcessor records when metrics are enabled
+enum class LatencyMetric {
+    ADD,          // addTask / one addTasks batch
+    UPDATE,       // updateTaskStatus / updateTaskPriority / one updateStatuses batch
+    PROCESS,      // one processTask / processAll / processByPriority call
+    QUERY,        // status/priority scans (point lookups are not timed)
+    QUEUE_WAIT,   // createdAt (millisecond resolution) to the start of a run
+    SERVICE       // start of a run to its completion
+};
+
+constexpr size_t kLatencyMetrics = 6;
+
+const char* latencyMetricName(LatencyMetric metric);
+
+struct TaskMetricsSnapshot {
+    double uptimeSeconds = 0;   // since the processor was created or metrics reset
+    bool latencyEnabled = false;
+    std::array<HistogramSnapshot, kLatencyMetrics> latency;
+    // Indexed by priority
+    std::array<uint64_t, 4> added{};
+    std::array<uint64_t, 4> completed{};
+    std::array<uint64_t, 4> failed{};
+
+    // Prometheus text exposition format: counters per priority, and each
+    // latency as a summary (quantiles 0.5-0.999, _sum and _count, seconds)
+    std::string toPrometheus(std::string_view prefix = "taskprocessor") const;
+    // {"uptime_seconds":..,"latency_enabled":..,"counters":{...},
+    //  "latency":{"add":{"count":..,"mean_ns":..,"p50_ns":..,...},...}}
+    void writeJson(JsonWriter& out) const;
+};
+
+// Counters and histograms owned by a TaskProcessor. The throughput counters
+// are always kept; latencies cost two clock reads per operation and are
+// only recorded once enabled. Everything is atomic, so snapshot() can run
+// on any thread while the processor keeps working.
+class TaskMetrics {
+public:
+    TaskMetrics();
+
+    void setLatencyEnabled(bool enabled) { latencyOn.store(enabled, std::memory_order_relaxed); }
+    bool latencyEnabled() const { return latencyOn.load(std::memory_order_relaxed); }
+
+    void record(LatencyMetric metric, uint64_t nanos) {
+        histograms[static_cast<size_t>(metric)].record(nanos);
+    }
+    void countAdded(TaskPriority priority, uint64_t count = 1);
+    void countOutcome(TaskPriority priority, bool success);
+
+    void reset();
+    TaskMetricsSnapshot snapshot() const;
+
+private:
+    std::atomic<bool> latencyOn;
+    std::atomic<int64_t> startedAt;   // steady clock, ns
+    std::array<LatencyHistogram, kLatencyMetrics> histograms;
+    std::array<std::atomic<uint64_t>, 4> added;
+    std::array<std::atomic<uint64_t>, 4> completed;
+    std::array<std::atomic<uint64_t>, 4> failed;
+};
+
+#endif // TASK_METRICS_H
@@ -1,15 +1,52 @@
 #include "task_processor.h"
-#include <iostream>
+#include "work_stealing.h"
 #include <algorithm>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <cassert>
+#include <cstring>
+#include <system_error>
+
+namespace {
+
+long long steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long wallNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Records how long the enclosing scope took; reads no clock while latency
+// metrics are off
+class LatencyTimer {
+public:
+    LatencyTimer(TaskMetrics& metrics, LatencyMetric metric)
+        : metrics(metrics), metric(metric), start(metrics.latencyEnabled() ? steadyNanos() : -1) {}
+    ~LatencyTimer() {
+        if (start >= 0) {
+            metrics.record(metric, static_cast<uint64_t>(steadyNanos() - start));
+        }
+    }
+
+private:
+    TaskMetrics& metrics;
+    LatencyMetric metric;
+    long long start;
+};
+
+} // namespace
 
 // ============ Task Implementation ============
 
-Task::Task(int id, const std::string& title, const std::string& desc, TaskPriority prio)
-    : id(id), title(title), description(desc), priority(prio), 
-      status(TaskStatus::PENDING), createdAt(0), completedAt(0) {
+Task::Task(int id, std::string_view title, std::string_view desc, TaskPriority prio,
+           std::pmr::memory_resource* resource)
+    : id(id), title(title, resource), description(desc, resource), priority(prio), 
+      status(TaskStatus::PENDING), createdAt(0), completedAt(0),
+      readyPrev(nullptr), readyNext(nullptr) {
     auto now = std::chrono::system_clock::now();
     createdAt = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
@@ -18,15 +55,33 @@ Task::Task(int id, const std::string& title, const std::string& desc, TaskPriori
 // ============ TaskProcessor Implementation ============
 
 TaskProcessor::TaskProcessor() 
-    : nextId(1), processedCount(0), failedCount(0) {
-    std::cout << "[TaskProcessor] Initialized" << std::endl;
+    : TaskProcessor(defaultLogger()) {
+}
+
+TaskProcessor::TaskProcessor(std::shared_ptr<Logger> sink) 
+    : TaskProcessor(std::move(sink), nullptr) {
+}
+
+TaskProcessor::TaskProcessor(std::shared_ptr<Logger> sink, std::pmr::memory_resource* resource)
+    : logger(sink ? std::move(sink) : defaultLogger()),
+      memory(resource ? resource : std::pmr::get_default_resource()), firstSlotId(1), liveCount(0), leadingTombstones(0),
+      nextId(1), processedCount(0), failedCount(0),
+      inFlight(0), stopWorkers(false),
+      schedulingMode(SchedulingMode::SHARED_QUEUE), workerCount(0), starvationLimit(64),
+      walCheckpointBytes(0), metrics(std::make_unique<TaskMetrics>()) {
+    priorityCount.fill(0);
+    statusCount.fill(0);
+    drainBudget.fill(0);
+    TP_LOG_INFO(*logger, "[TaskProcessor] Initialized");
 }
 
 TaskProcessor::~TaskProcessor() {
-    std::cout << "[TaskProcessor] Destroyed. Stats: " 
-              << processedCount << " processed, "
-              << failedCount << " failed, "
-              << getTotalCount() << " total" << std::endl;
+    stopPool();
+    wal.reset();
+    TP_LOG_INFO(*logger, "[TaskProcessor] Destroyed. Stats: " 
+        << getProcessedCount() << " processed, "
+        << getFailedCount() << " failed, "
+        << getTotalCount() << " total");
 }
 
 long long TaskProcessor::getCurrentTimestamp() const {
@@ -35,71 +90,418 @@ long long TaskProcessor::getCurrentTimestamp() const {
         now.time_since_epoch()).count();
 }
 
-void TaskProcessor::updateCounts() {
-    priorityCount.clear();
-    statusCount.clear();
+void TaskProcessor::countTask(const Task& task, int delta) {
+    priorityCount[static_cast<size_t>(task.priority)] += delta;
+    statusCount[static_cast<size_t>(task.status)] += delta;
+}
+
+// Debug builds cross-check the incremental counters against a full recount
+void TaskProcessor::verifyCounts() const {
+#ifdef DEBUG
+    std::array<int, kPriorityLevels> priorities{};
+    std::array<int, kStatusLevels> statuses{};
+    assert(store.rowCount() == slots.size());
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        const auto& task = slots[slot];
+        if (!store.isLive(slot)) {
+            assert(!task);
+            continue;
+        }
+        assert(store.idColumn()[slot] == firstSlotId + static_cast<int>(slot));
+        priorities[store.priorityColumn()[slot]]++;
+        statuses[store.statusColumn()[slot]]++;
+        if (!task) {
+            // Not built yet; only settled tasks may stay lazy
+            assert(store.statusColumn()[slot] != static_cast<uint8_t>(TaskStatus::PENDING));
+            continue;
+        }
+        assert(store.idColumn()[slot] == task->id);
+        assert(store.statusColumn()[slot] == static_cast<uint8_t>(task->status));
+        assert(store.priorityColumn()[slot] == static_cast<uint8_t>(task->priority));
+    }
+    assert(priorities == priorityCount);
+    assert(statuses == statusCount);
+    
+    for (size_t i = 0; i < kPriorityLevels; i++) {
+        size_t queued = 0;
+        for (const Task* t = readyLists[i].head; t; t = t->readyNext) {
+            assert(t->status == TaskStatus::PENDING);
+            assert(static_cast<size_t>(t->priority) == i);
+            queued++;
+        }
+        assert(queued == readyLists[i].size);
+    }
+#endif
+}
+
+// ============ Slot Table ============
+
+bool TaskProcessor::slotFor(int taskId, size_t& slot) const {
+    if (taskId < firstSlotId) return false;
+    slot = static_cast<size_t>(taskId - firstSlotId);
+    return slot < slots.size() && store.isLive(slot);
+}
+
+Task* TaskProcessor::findTask(int taskId) const {
+    size_t slot;
+    return slotFor(taskId, slot) ? taskAt(slot).get() : nullptr;
+}
+
+// Builds a snapshot-loaded task from its store row on first access
+const std::shared_ptr<Task>& TaskProcessor::taskAt(size_t slot) const {
+    if (!slots[slot]) {
+        TaskView view = store.view(slot);
+        auto task = makeTask(view.id, view.title, view.description, view.priority);
+        task->status = view.status;
+        task->createdAt = view.createdAt;
+        task->completedAt = view.completedAt;
+        slots[slot] = std::move(task);
+    }
+    return slots[slot];
+}
+
+// One allocation from the memory resource holds the task and its shared_ptr
+// control block; the strings follow it into the same resource
+std::shared_ptr<Task> TaskProcessor::makeTask(int id, std::string_view title,
+                                              std::string_view description,
+                                              TaskPriority priority) const {
+    return std::allocate_shared<Task>(std::pmr::polymorphic_allocator<Task>(memory),
+                                      id, title, description, priority, memory);
+}
+
+void TaskProcessor::releaseSlot(size_t slot) {
+    // Pending tasks are always built (they sit in the ready lists); others
+    // may still be lazy, so the counts come from the store columns
+    if (slots[slot] && slots[slot]->status == TaskStatus::PENDING) {
+        unlinkReady(*slots[slot]);
+    }
+    priorityCount[store.priorityColumn()[slot]]--;
+    statusCount[store.statusColumn()[slot]]--;
+    slots[slot].reset();
+    store.remove(slot);
+    liveCount--;
+    if (slot == leadingTombstones) {
+        while (leadingTombstones < slots.size() && !store.isLive(leadingTombstones)) {
+            leadingTombstones++;
+        }
+    }
+}
+
+void TaskProcessor::trimTombstones() {
+    if (liveCount == 0) {
+        slots.clear();
+        store.clear();
+        firstSlotId = nextId;
+        leadingTombstones = 0;
+        return;
+    }
     
-    for (const auto& task : tasks) {
-        priorityCount[task->priority]++;
-        statusCount[task->status]++;
+    // Only the leading run can be dropped without renumbering slots; doing it
+    // once the run covers half the table keeps the erase amortized O(1).
+    if (leadingTombstones * 2 >= slots.size()) {
+        slots.erase(slots.begin(), slots.begin() + leadingTombstones);
+        store.eraseFront(leadingTombstones);
+        firstSlotId += static_cast<int>(leadingTombstones);
+        leadingTombstones = 0;
+    }
+}
+
+// ============ Ready Queue ============
+
+void TaskProcessor::enqueueReady(Task& task) {
+    ReadyList& list = readyLists[static_cast<size_t>(task.priority)];
+    task.readyPrev = list.tail;
+    task.readyNext = nullptr;
+    if (list.tail) {
+        list.tail->readyNext = &task;
+    } else {
+        list.head = &task;
+    }
+    list.tail = &task;
+    list.size++;
+}
+
+void TaskProcessor::unlinkReady(Task& task) {
+    ReadyList& list = readyLists[static_cast<size_t>(task.priority)];
+    if (task.readyPrev) {
+        task.readyPrev->readyNext = task.readyNext;
+    } else {
+        list.head = task.readyNext;
     }
+    if (task.readyNext) {
+        task.readyNext->readyPrev = task.readyPrev;
+    } else {
+        list.tail = task.readyPrev;
+    }
+    task.readyPrev = nullptr;
+    task.readyNext = nullptr;
+    list.size--;
 }
 
 // Task management
 int TaskProcessor::addTask(const std::string& title, const std::string& description,
                            TaskPriority priority) {
-    auto task = std::make_shared<Task>(nextId++, title, description, priority);
-    tasks.push_back(task);
-    updateCounts();
+    LatencyTimer timer(*metrics, LatencyMetric::ADD);
+    // nextId only moves once the task exists, so a failed allocation leaves
+    // ids and slots in step
+    auto task = makeTask(nextId, title, description, priority);
+    nextId++;
+    insertTask(task);
+    metrics->countAdded(priority);
     
-    std::cout << "[TaskProcessor] Added task #" << task->id 
-              << ": " << title 
-              << " [" << priorityToString(priority) << "]" << std::endl;
+    TP_LOG_DEBUG(*logger, "[TaskProcessor] Added task #" << task->id 
+        << ": " << title
+        << " [" << priorityToString(priority) << "]");
     
+    if (wal) {
+        WalRecord record{WalRecordType::ADD};
+        record.id = task->id;
+        record.value = static_cast<uint8_t>(priority);
+        record.timestamp = task->createdAt;
+        record.title = title;
+        record.description = description;
+        logMutation(record);
+    }
     return task->id;
 }
 
+void TaskProcessor::insertTask(const std::shared_ptr<Task>& task) {
+    slots.push_back(task);
+    store.appendBorrowed(task->id, task->title, task->description, task->priority,
+                         task->status, task->createdAt, task->completedAt);
+    liveCount++;
+    countTask(*task, +1);
+    enqueueReady(*task);
+    verifyCounts();
+}
+
 bool TaskProcessor::removeTask(int taskId) {
-    auto it = std::find_if(tasks.begin(), tasks.end(),
-                          [taskId](const std::shared_ptr<Task>& t) { 
-                              return t->id == taskId; 
-                          });
-    
-    if (it != tasks.end()) {
-        std::cout << "[TaskProcessor] Removed task #" << taskId << std::endl;
-        tasks.erase(it);
-        updateCounts();
+    size_t slot;
+    if (slotFor(taskId, slot)) {
+        TP_LOG_DEBUG(*logger, "[TaskProcessor] Removed task #" << taskId);
+        releaseSlot(slot);
+        trimTombstones();
+        verifyCounts();
+        if (wal) {
+            WalRecord record{WalRecordType::REMOVE};
+            record.id = taskId;
+            logMutation(record);
+        }
         return true;
     }
     
-    std::cerr << "[TaskProcessor] Task #" << taskId << " not found" << std::endl;
+    TP_LOG_WARN(*logger, "[TaskProcessor] Task #" << taskId << " not found");
     return false;
 }
 
 bool TaskProcessor::updateTaskStatus(int taskId, TaskStatus status) {
-    auto task = getTask(taskId);
+    LatencyTimer timer(*metrics, LatencyMetric::UPDATE);
+    Task* task = findTask(taskId);
     if (task) {
-        task->status = status;
-        if (status == TaskStatus::COMPLETED || status == TaskStatus::FAILED) {
-            task->completedAt = getCurrentTimestamp();
+        setStatus(*task, status);
+        if (wal) {
+            WalRecord record{WalRecordType::STATUS};
+            record.id = taskId;
+            record.value = static_cast<uint8_t>(status);
+            record.timestamp = task->completedAt;
+            logMutation(record);
         }
-        updateCounts();
-        
-        std::cout << "[TaskProcessor] Task #" << taskId 
-                  << " status updated to " << statusToString(status) << std::endl;
         return true;
     }
     return false;
 }
 
+// ============ Batch Mutations ============
+
+size_t TaskProcessor::addTasks(const TaskSpec* specs, size_t count, int* idsOut) {
+    if (count == 0) {
+        return 0;
+    }
+    LatencyTimer timer(*metrics, LatencyMetric::ADD);
+    if (slots.size() + count > slots.capacity()) {
+        slots.reserve(std::max(slots.size() + count, slots.capacity() * 2));
+    }
+    store.reserve(count);
+    
+    std::array<int, kPriorityLevels> added{};
+    size_t inserted = 0;
+    // Also run if an allocation fails part-way, so the tasks already
+    // inserted are counted
+    auto settleCounts = [&] {
+        for (size_t i = 0; i < kPriorityLevels; i++) {
+            priorityCount[i] += added[i];
+            metrics->countAdded(static_cast<TaskPriority>(i), static_cast<uint64_t>(added[i]));
+        }
+        statusCount[static_cast<size_t>(TaskStatus::PENDING)] += static_cast<int>(inserted);
+        liveCount += inserted;
+        verifyCounts();
+    };
+    
+    uint64_t sequence = 0;
+    int firstId = nextId;
+    try {
+        for (size_t i = 0; i < count; i++) {
+            const TaskSpec& spec = specs[i];
+            auto task = makeTask(nextId, spec.title, spec.description, spec.priority);
+            nextId++;
+            store.appendBorrowed(task->id, task->title, task->description, task->priority,
+                                 task->status, task->createdAt, task->completedAt);
+            enqueueReady(*task);
+            slots.push_back(task);
+            added[static_cast<size_t>(spec.priority)]++;
+            inserted++;
+            if (idsOut) {
+                idsOut[i] = task->id;
+            }
+            if (wal) {
+                WalRecord record{WalRecordType::ADD};
+                record.id = task->id;
+                record.value = static_cast<uint8_t>(spec.priority);
+                record.timestamp = task->createdAt;
+                record.title = spec.title;
+                record.description = spec.description;
+                sequence = wal->append(record);
+            }
+        }
+    } catch (...) {
+        settleCounts();
+        throw;
+    }
+    settleCounts();
+    if (wal) {
+        commitBatch(sequence);
+    }
+    
+    TP_LOG_INFO(*logger, "[TaskProcessor] Added " << count << " tasks (#"
+        << firstId << "-#" << nextId - 1 << ")");
+    return count;
+}
+
+size_t TaskProcessor::updateStatuses(const TaskStatusUpdate* updates, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    LatencyTimer timer(*metrics, LatencyMetric::UPDATE);
+    std::array<int, kStatusLevels> delta{};
+    uint64_t sequence = 0;
+    size_t updated = 0;
+    for (size_t i = 0; i < count; i++) {
+        Task* task = findTask(updates[i].id);
+        if (!task) {
+            continue;
+        }
+        delta[static_cast<size_t>(task->status)]--;
+        delta[static_cast<size_t>(updates[i].status)]++;
+        applyStatus(*task, updates[i].status, 0);
+        updated++;
+        if (wal) {
+            WalRecord record{WalRecordType::STATUS};
+            record.id = task->id;
+            record.value = static_cast<uint8_t>(task->status);
+            record.timestamp = task->completedAt;
+            sequence = wal->append(record);
+        }
+    }
+    
+    for (size_t i = 0; i < kStatusLevels; i++) {
+        statusCount[i] += delta[i];
+    }
+    verifyCounts();
+    if (wal && updated) {
+        commitBatch(sequence);
+    }
+    
+    TP_LOG_INFO(*logger, "[TaskProcessor] Updated status of " << updated << " tasks ("
+        << count - updated << " not found)");
+    return updated;
+}
+
+// Tombstones are trimmed once at the end; until then every id still maps
+// to its original slot
+size_t TaskProcessor::removeTasks(const int* taskIds, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t sequence = 0;
+    size_t removed = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t slot;
+        if (!slotFor(taskIds[i], slot)) {
+            continue;
+        }
+        releaseSlot(slot);
+        removed++;
+        if (wal) {
+            WalRecord record{WalRecordType::REMOVE};
+            record.id = taskIds[i];
+            sequence = wal->append(record);
+        }
+    }
+    
+    trimTombstones();
+    verifyCounts();
+    if (wal && removed) {
+        commitBatch(sequence);
+    }
+    
+    TP_LOG_INFO(*logger, "[TaskProcessor] Removed " << removed << " tasks ("
+        << count - removed << " not found)");
+    return removed;
+}
+
+// A non-zero timestamp replaces "now" as the completion time
+void TaskProcessor::setStatus(Task& task, TaskStatus status, long long timestamp) {
+    statusCount[static_cast<size_t>(task.status)]--;
+    statusCount[static_cast<size_t>(status)]++;
+    applyStatus(task, status, timestamp);
+    verifyCounts();
+    
+    TP_LOG_DEBUG(*logger, "[TaskProcessor] Task #" << task.id 
+        << " status updated to " << statusToString(status));
+}
+
+// Moves the task between ready lists and store columns; the status
+// counters are left to the caller
+void TaskProcessor::applyStatus(Task& task, TaskStatus status, long long timestamp) {
+    if (task.status == TaskStatus::PENDING && status != TaskStatus::PENDING) {
+        unlinkReady(task);
+    } else if (task.status != TaskStatus::PENDING && status == TaskStatus::PENDING) {
+        enqueueReady(task);
+    }
+    task.status = status;
+    size_t row = static_cast<size_t>(task.id - firstSlotId);
+    store.setStatus(row, status);
+    if (status == TaskStatus::COMPLETED || status == TaskStatus::FAILED) {
+        task.completedAt = timestamp ? timestamp : getCurrentTimestamp();
+        store.setCompletedAt(row, task.completedAt);
+    }
+}
+
 bool TaskProcessor::updateTaskPriority(int taskId, TaskPriority priority) {
-    auto task = getTask(taskId);
+    LatencyTimer timer(*metrics, LatencyMetric::UPDATE);
+    Task* task = findTask(taskId);
     if (task) {
+        bool pending = task->status == TaskStatus::PENDING;
+        if (pending) {
+            unlinkReady(*task);
+        }
+        priorityCount[static_cast<size_t>(task->priority)]--;
+        priorityCount[static_cast<size_t>(priority)]++;
         task->priority = priority;
-        updateCounts();
+        store.setPriority(static_cast<size_t>(taskId - firstSlotId), priority);
+        if (pending) {
+            enqueueReady(*task);
+        }
+        verifyCounts();
+        if (wal) {
+            WalRecord record{WalRecordType::PRIORITY};
+            record.id = taskId;
+            record.value = static_cast<uint8_t>(priority);
+            logMutation(record);
+        }
         
-        std::cout << "[TaskProcessor] Task #" << taskId 
-                  << " priority updated to " << priorityToString(priority) << std::endl;
+        TP_LOG_DEBUG(*logger, "[TaskProcessor] Task #" << taskId 
+            << " priority updated to " << priorityToString(priority));
         return true;
     }
     return false;
@@ -107,152 +509,910 @@ bool TaskProcessor::updateTaskPriority(int taskId, TaskPriority priority) {
 
 // Processing
 void TaskProcessor::processTask(int taskId) {
-    auto task = getTask(taskId);
+    LatencyTimer timer(*metrics, LatencyMetric::PROCESS);
+    Task* task = findTask(taskId);
     if (!task) {
-        std::cerr << "[TaskProcessor] Cannot process task #" << taskId 
-                  << " - not found" << std::endl;
+        TP_LOG_WARN(*logger, "[TaskProcessor] Cannot process task #" << taskId 
+            << " - not found");
         return;
     }
     
     if (task->status != TaskStatus::PENDING) {
-        std::cout << "[TaskProcessor] Task #" << taskId 
-                  << " already processed (status: " 
-                  << statusToString(task->status) << ")" << std::endl;
+        TP_LOG_DEBUG(*logger, "[TaskProcessor] Task #" << taskId 
+            << " already processed (status: "
+            << statusToString(task->status) << ")");
         return;
     }
     
-    std::cout << "[TaskProcessor] Processing task #" << taskId 
-              << ": " << task->title << std::endl;
-    
-    updateTaskStatus(taskId, TaskStatus::IN_PROGRESS);
-    
-    // Simulate processing based on priority
-    bool success = true; // In real scenario, this would be actual processing logic
+    runTask(*task);
+    commitDrain();
+}
+
+void TaskProcessor::runTask(Task& task) {
+    TP_LOG_DEBUG(*logger, "[TaskProcessor] Processing task #" << task.id 
+        << ": " << task.title);
     
+    setStatus(task, TaskStatus::IN_PROGRESS);
+    long long started = beginService(task);
+    finishTask(task, executeTask(task));
+    endService(started);
+}
+
+// Records the task's queue wait and returns the steady-clock start of its
+// run for endService (-1 while latency metrics are off). The wait has to be
+// measured on the wall clock because createdAt is wall time (with only
+// millisecond resolution); the run itself is timed on the steady clock so
+// a clock adjustment cannot distort it.
+long long TaskProcessor::beginService(const Task& task) {
+    if (!metrics->latencyEnabled()) {
+        return -1;
+    }
+    long long waited = wallNanos() - task.createdAt * 1000000;
+    metrics->record(LatencyMetric::QUEUE_WAIT, static_cast<uint64_t>(waited > 0 ? waited : 0));
+    return steadyNanos();
+}
+
+void TaskProcessor::endService(long long startedAt) {
+    if (startedAt >= 0) {
+        long long served = steadyNanos() - startedAt;
+        metrics->record(LatencyMetric::SERVICE, static_cast<uint64_t>(served > 0 ? served : 0));
+    }
+}
+
+// Runs the plugged-in work function; without one every task succeeds
+bool TaskProcessor::executeTask(const Task& task) {
+    if (!workFunction) {
+        return true;
+    }
+    try {
+        return workFunction(task);
+    } catch (const std::exception& e) {
+        TP_LOG_WARN(*logger, "[TaskProcessor] Task #" << task.id 
+            << " threw: " << e.what());
+        return false;
+    } catch (...) {
+        TP_LOG_WARN(*logger, "[TaskProcessor] Task #" << task.id 
+            << " threw a non-standard exception");
+        return false;
+    }
+}
+
+void TaskProcessor::finishTask(Task& task, bool success, long long finishedAt) {
+    metrics->countOutcome(task.priority, success);
     if (success) {
-        updateTaskStatus(taskId, TaskStatus::COMPLETED);
+        setStatus(task, TaskStatus::COMPLETED, finishedAt);
         processedCount++;
-        std::cout << "[TaskProcessor] Task #" << taskId << " completed successfully" << std::endl;
+        TP_LOG_DEBUG(*logger, "[TaskProcessor] Task #" << task.id << " completed successfully");
     } else {
-        updateTaskStatus(taskId, TaskStatus::FAILED);
+        setStatus(task, TaskStatus::FAILED, finishedAt);
         failedCount++;
-        std::cerr << "[TaskProcessor] Task #" << taskId << " failed" << std::endl;
+        TP_LOG_WARN(*logger, "[TaskProcessor] Task #" << task.id << " failed");
+    }
+    if (wal) {
+        WalRecord record{WalRecordType::OUTCOME};
+        record.id = task.id;
+        record.value = success ? 1 : 0;
+        record.timestamp = task.completedAt;
+        wal->append(record);
+    }
+}
+
+// Pops from the head of the ready list. Only the tasks queued when the drain
+// starts are taken, so a task re-queued while processing waits for the next pass.
+void TaskProcessor::drainReady(TaskPriority priority) {
+    ReadyList& list = readyLists[static_cast<size_t>(priority)];
+    for (size_t budget = list.size; budget > 0 && list.head; budget--) {
+        runTask(*list.head);
     }
 }
 
 void TaskProcessor::processAll() {
-    std::cout << "[TaskProcessor] Processing all " << tasks.size() << " tasks..." << std::endl;
+    LatencyTimer timer(*metrics, LatencyMetric::PROCESS);
+    TP_LOG_INFO(*logger, "[TaskProcessor] Processing all " << liveCount << " tasks...");
     
-    // Process by priority: CRITICAL -> HIGH -> MEDIUM -> LOW
-    processByPriority(TaskPriority::CRITICAL);
-    processByPriority(TaskPriority::HIGH);
-    processByPriority(TaskPriority::MEDIUM);
-    processByPriority(TaskPriority::LOW);
+    if (workerCount > 0) {
+        std::array<size_t, kPriorityLevels> budget;
+        for (size_t i = 0; i < kPriorityLevels; i++) {
+            budget[i] = readyLists[i].size;
+        }
+        drainBudgeted(budget);
+    } else {
+        // Process by priority: CRITICAL -> HIGH -> MEDIUM -> LOW
+        drainReady(TaskPriority::CRITICAL);
+        drainReady(TaskPriority::HIGH);
+        drainReady(TaskPriority::MEDIUM);
+        drainReady(TaskPriority::LOW);
+    }
     
-    std::cout << "[TaskProcessor] Batch processing complete. "
-              << processedCount << " successful, "
-              << failedCount << " failed" << std::endl;
+    TP_LOG_INFO(*logger, "[TaskProcessor] Batch processing complete. "
+        << getProcessedCount() << " successful, "
+        << getFailedCount() << " failed");
+    commitDrain();
 }
 
 void TaskProcessor::processByPriority(TaskPriority priority) {
-    auto priorityTasks = getTasksByPriority(priority);
-    for (const auto& task : priorityTasks) {
-        if (task->status == TaskStatus::PENDING) {
-            processTask(task->id);
+    LatencyTimer timer(*metrics, LatencyMetric::PROCESS);
+    if (workerCount > 0) {
+        std::array<size_t, kPriorityLevels> budget{};
+        budget[static_cast<size_t>(priority)] = readyLists[static_cast<size_t>(priority)].size;
+        drainBudgeted(budget);
+    } else {
+        drainReady(priority);
+    }
+    commitDrain();
+}
+
+// ============ Logging ============
+
+void TaskProcessor::setLogger(std::shared_ptr<Logger> sink) {
+    logger = sink ? std::move(sink) : defaultLogger();
+}
+
+std::shared_ptr<Logger> TaskProcessor::getLogger() const {
+    return logger;
+}
+
+std::pmr::memory_resource* TaskProcessor::getMemoryResource() const {
+    return memory;
+}
+
+// ============ Write-Ahead Log ============
+
+bool TaskProcessor::enableWal(const std::string& path, const WalOptions& options) {
+    wal.reset();
+    auto opened = WriteAheadLog::open(path, options);
+    if (!opened) {
+        TP_LOG_ERROR(*logger, "[TaskProcessor] Cannot open write-ahead log " << path);
+        return false;
+    }
+    
+    // Pick up where the loaded snapshot left off: a log continuing it, or
+    // the log it was taken from (whose covered prefix was not dropped yet).
+    // A self-contained log is the newer, complete history.
+    size_t from = 0;
+    bool checkpoint = liveCount > 0 && !snapshot;
+    if (snapshot && !opened->empty()) {
+        const SnapshotHeader& base = snapshot->header();
+        if (opened->getBaseSnapshot() == base.snapshotId) {
+            from = 0;
+        } else if (opened->getGeneration() == base.walGeneration) {
+            from = static_cast<size_t>(base.walOffset);
+        } else if (opened->getBaseSnapshot() == 0) {
+            resetTasks();
+        } else {
+            TP_LOG_ERROR(*logger, "[TaskProcessor] Write-ahead log " << path
+                << " continues a different snapshot");
+            return false;
+        }
+    } else if (!snapshot && opened->getBaseSnapshot() != 0) {
+        TP_LOG_ERROR(*logger, "[TaskProcessor] Write-ahead log " << path
+            << " needs its snapshot loaded first");
+        return false;
+    }
+    
+    // Replay runs with wal unset so the applied mutations are not re-logged
+    size_t replayed = 0;
+    if (!opened->replay([this](const WalRecord& record) { applyWalRecord(record); }, from, &replayed)) {
+        TP_LOG_ERROR(*logger, "[TaskProcessor] Write-ahead log " << path << ": stopped after "
+            << replayed << " records at a frame that cannot be decoded; file left as it is");
+        return false;
+    }
+    wal = std::move(opened);
+    walCheckpointBytes = 0;
+    if (snapshot && wal->empty()) {
+        // A fresh log continues the loaded snapshot
+        wal->discardPrefix(wal->getGeneration(), wal->sizeBytes(), snapshot->header().snapshotId);
+    }
+    
+    TP_LOG_INFO(*logger, "[TaskProcessor] Write-ahead log " << path << ": replayed "
+        << replayed << " records, " << liveCount << " tasks");
+    // Tasks that existed before the log was attached are only covered once
+    // they are written into it
+    return checkpoint ? checkpointWal() : true;
+}
+
+void TaskProcessor::disableWal() {
+    wal.reset();
+}
+
+bool TaskProcessor::isWalEnabled() const {
+    return wal != nullptr;
+}
+
+bool TaskProcessor::checkpointWal() {
+    if (!wal) {
+        return false;
+    }
+    if (!wal->rewrite([this](const std::function<void(const WalRecord&)>& emit) { writeImage(emit); })) {
+        TP_LOG_ERROR(*logger, "[TaskProcessor] Write-ahead log checkpoint failed");
+        return false;
+    }
+    walCheckpointBytes = wal->sizeBytes();
+    TP_LOG_DEBUG(*logger, "[TaskProcessor] Write-ahead log checkpointed at "
+        << walCheckpointBytes << " bytes");
+    return true;
+}
+
+bool TaskProcessor::syncWal() {
+    return wal && wal->sync();
+}
+
+int TaskProcessor::getWalError() const {
+    return wal ? wal->getError() : 0;
+}
+
+// Called from the owning thread only: checkpoints must not race a drain
+void TaskProcessor::logMutation(const WalRecord& record) {
+    uint64_t sequence = wal->append(record);
+    if (wal->getOptions().waitForCommit && !wal->waitDurable(sequence)) {
+        failCommit();
+    }
+    maybeCheckpointWal();
+}
+
+// Batches append without waiting; the last record's commit covers them all
+void TaskProcessor::commitBatch(uint64_t sequence) {
+    if (wal->getOptions().waitForCommit && !wal->waitDurable(sequence)) {
+        failCommit();
+    }
+    maybeCheckpointWal();
+}
+
+// Outcomes are appended without waiting; one sync per drain commits them
+void TaskProcessor::commitDrain() {
+    if (!wal) {
+        return;
+    }
+    if (wal->getOptions().waitForCommit && !wal->sync()) {
+        failCommit();
+    }
+    maybeCheckpointWal();
+}
+
+void TaskProcessor::failCommit() {
+    int error = wal->getError();
+    TP_LOG_ERROR(*logger, "[TaskProcessor] Write-ahead log " << wal->getPath()
+        << " failed: " << std::strerror(error));
+    throw std::system_error(error, std::generic_category(), "write-ahead log");
+}
+
+void TaskProcessor::maybeCheckpointWal() {
+    size_t size = wal->sizeBytes();
+    if (size > wal->getOptions().truncateBytes && size > 2 * walCheckpointBytes) {
+        checkpointWal();
+    }
+}
+
+// Live tasks in id order, then the counters (whose nextId covers removed tail ids)
+void TaskProcessor::writeImage(const std::function<void(const WalRecord&)>& emit) const {
+    for (size_t row = 0; row < store.rowCount(); row++) {
+        if (!store.isLive(row)) continue;
+        TaskView task = store.view(row);
+        WalRecord add{WalRecordType::ADD};
+        add.id = task.id;
+        add.value = static_cast<uint8_t>(task.priority);
+        add.timestamp = task.createdAt;
+        add.title = task.title;
+        add.description = task.description;
+        emit(add);
+        if (task.status != TaskStatus::PENDING) {
+            WalRecord status{WalRecordType::STATUS};
+            status.id = task.id;
+            status.value = static_cast<uint8_t>(task.status);
+            status.timestamp = task.completedAt;
+            emit(status);
+        }
+    }
+    WalRecord counters{WalRecordType::COUNTERS};
+    counters.id = nextId;
+    counters.processed = processedCount;
+    counters.failed = failedCount;
+    emit(counters);
+}
+
+// Tombstones the ids up to `id` so the slot for id is next in line
+void TaskProcessor::padSlots(int id) {
+    while (firstSlotId + static_cast<int>(slots.size()) < id) {
+        slots.emplace_back();
+        store.remove(store.append(firstSlotId + static_cast<int>(slots.size()) - 1, "", "",
+                                  TaskPriority::LOW, TaskStatus::PENDING, 0));
+    }
+}
+
+void TaskProcessor::applyWalRecord(const WalRecord& record) {
+    Task* task = record.type == WalRecordType::STATUS || record.type == WalRecordType::OUTCOME
+        ? findTask(record.id) : nullptr;
+    switch (record.type) {
+        case WalRecordType::ADD:
+            restoreTask(record);
+            break;
+        case WalRecordType::REMOVE:
+            removeTask(record.id);
+            break;
+        case WalRecordType::STATUS:
+            if (task) setStatus(*task, static_cast<TaskStatus>(record.value), record.timestamp);
+            break;
+        case WalRecordType::PRIORITY:
+            updateTaskPriority(record.id, static_cast<TaskPriority>(record.value));
+            break;
+        case WalRecordType::OUTCOME:
+            if (task) finishTask(*task, record.value != 0, record.timestamp);
+            break;
+        case WalRecordType::CLEAR:
+            clearTasks();
+            break;
+        case WalRecordType::CLEAR_COMPLETED:
+            clearCompleted();
+            break;
+        case WalRecordType::COUNTERS:
+            nextId = std::max(nextId, record.id);
+            processedCount = static_cast<int>(record.processed);
+            failedCount = static_cast<int>(record.failed);
+            if (liveCount == 0) {
+                trimTombstones();
+            } else {
+                padSlots(nextId);
+            }
+            break;
+    }
+}
+
+// Re-creates a logged task under its original id. Ids removed before a
+// checkpoint leave gaps, which become tombstoned slots.
+void TaskProcessor::restoreTask(const WalRecord& record) {
+    if (record.id < firstSlotId + static_cast<int>(slots.size())) {
+        TP_LOG_WARN(*logger, "[TaskProcessor] Skipping out-of-order log record for task #" << record.id);
+        return;
+    }
+    if (slots.empty()) {
+        firstSlotId = record.id;
+    } else {
+        padSlots(record.id);
+    }
+    nextId = record.id;
+    auto task = makeTask(nextId++, record.title, record.description,
+                         static_cast<TaskPriority>(record.value));
+    task->createdAt = record.timestamp;
+    insertTask(task);
+}
+
+// ============ Snapshots ============
+
+bool TaskProcessor::saveSnapshot(const std::string& path) {
+    return saveSnapshotAsync(path).get();
+}
+
+std::future<bool> TaskProcessor::saveSnapshotAsync(const std::string& path) {
+    SnapshotHeader header{};
+    header.snapshotId = newGenerationId();
+    header.nextId = nextId;
+    header.processedCount = processedCount;
+    header.failedCount = failedCount;
+    std::shared_ptr<WriteAheadLog> log = wal;
+    if (log) {
+        // Everything logged so far is reflected in the captured tasks; a
+        // failed log cannot be cut back to what the snapshot covers
+        if (!log->sync()) {
+            TP_LOG_ERROR(*logger, "[TaskProcessor] Cannot snapshot to " << path
+                << ": write-ahead log failed: " << std::strerror(log->getError()));
+            std::promise<bool> failed;
+            failed.set_value(false);
+            return failed.get_future();
+        }
+        header.walGeneration = log->getGeneration();
+        header.walOffset = log->sizeBytes();
+    }
+    auto image = std::make_shared<std::string>(buildSnapshot(store, header));
+    if (image->empty()) {
+        TP_LOG_ERROR(*logger, "[TaskProcessor] Cannot snapshot to " << path
+            << ": task strings exceed the 4 GiB snapshot heap");
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
+    TP_LOG_DEBUG(*logger, "[TaskProcessor] Captured snapshot of " << liveCount
+        << " tasks (" << image->size() << " bytes)");
+    
+    return std::async(std::launch::async, [path, image, log, header] {
+        if (!writeFileAtomically(path, *image)) {
+            return false;
+        }
+        if (log) {
+            log->discardPrefix(header.walGeneration, static_cast<size_t>(header.walOffset),
+                               header.snapshotId);
+        }
+        return true;
+    });
+}
+
+bool TaskProcessor::loadSnapshot(const std::string& path, bool verifyChecksums) {
+    if (wal) {
+        TP_LOG_ERROR(*logger, "[TaskProcessor] Load snapshots before enabling the write-ahead log");
+        return false;
+    }
+    auto mapped = MappedSnapshot::open(path);
+    if (!mapped || (verifyChecksums && !mapped->verify())) {
+        TP_LOG_ERROR(*logger, "[TaskProcessor] Cannot load snapshot " << path);
+        return false;
+    }
+    
+    const SnapshotHeader& header = mapped->header();
+    for (size_t i = 1; i < mapped->recordCount(); i++) {
+        if (mapped->record(i).id <= mapped->record(i - 1).id) {
+            TP_LOG_ERROR(*logger, "[TaskProcessor] Snapshot " << path << " is out of order");
+            return false;
+        }
+    }
+    
+    resetTasks();
+    snapshot = mapped;
+    for (size_t i = 0; i < snapshot->recordCount(); i++) {
+        const SnapshotRecord& record = snapshot->record(i);
+        if (slots.empty()) {
+            firstSlotId = record.id;
+        } else {
+            padSlots(record.id);
+        }
+        auto priority = static_cast<TaskPriority>(record.priority & 3);
+        auto status = static_cast<TaskStatus>(record.status & 3);
+        store.appendBorrowed(record.id,
+                             snapshot->string(record.titleOffset, record.titleLength),
+                             snapshot->string(record.descriptionOffset, record.descriptionLength),
+                             priority, status, record.createdAt, record.completedAt);
+        slots.emplace_back();
+        liveCount++;
+        priorityCount[static_cast<size_t>(priority)]++;
+        statusCount[static_cast<size_t>(status)]++;
+        if (status == TaskStatus::PENDING) {
+            enqueueReady(*taskAt(slots.size() - 1));
+        }
+    }
+    nextId = std::max(header.nextId, firstSlotId + static_cast<int>(slots.size()));
+    processedCount = static_cast<int>(header.processedCount);
+    failedCount = static_cast<int>(header.failedCount);
+    if (liveCount == 0) {
+        trimTombstones();
+    } else {
+        padSlots(nextId);
+    }
+    verifyCounts();
+    
+    TP_LOG_INFO(*logger, "[TaskProcessor] Loaded snapshot " << path << ": " << liveCount << " tasks");
+    return true;
+}
+
+// Drops every task and counter without logging, ready for a reload
+void TaskProcessor::resetTasks() {
+    slots.clear();
+    store.clear();
+    readyLists.fill(ReadyList());
+    priorityCount.fill(0);
+    statusCount.fill(0);
+    liveCount = 0;
+    leadingTombstones = 0;
+    nextId = 1;
+    firstSlotId = 1;
+    processedCount = 0;
+    failedCount = 0;
+    snapshot.reset();
+}
+
+// ============ Worker Pool ============
+
+void TaskProcessor::setWorkFunction(TaskWorkFunction work) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    workFunction = std::move(work);
+}
+
+void TaskProcessor::setWorkerCount(size_t count) {
+    stopPool();
+    workerCount = count;
+    startPool();
+    TP_LOG_INFO(*logger, "[TaskProcessor] Worker pool size set to " << count);
+}
+
+size_t TaskProcessor::getWorkerCount() const {
+    return workerCount;
+}
+
+void TaskProcessor::setSchedulingMode(SchedulingMode mode, size_t starvation) {
+    stopPool();
+    schedulingMode = mode;
+    starvationLimit = starvation;
+    startPool();
+}
+
+SchedulingMode TaskProcessor::getSchedulingMode() const {
+    return schedulingMode;
+}
+
+void TaskProcessor::startPool() {
+    if (workerCount == 0) {
+        return;
+    }
+    if (schedulingMode == SchedulingMode::WORK_STEALING) {
+        stealer = std::make_unique<WorkStealingScheduler>(workerCount, starvationLimit);
+        return;
+    }
+    stopWorkers = false;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&TaskProcessor::workerLoop, this);
+    }
+}
+
+void TaskProcessor::stopPool() {
+    stealer.reset();
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopWorkers = true;
+    }
+    workReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void TaskProcessor::drainBudgeted(const std::array<size_t, kPriorityLevels>& budget) {
+    if (schedulingMode == SchedulingMode::WORK_STEALING) {
+        drainStealing(budget);
+    } else {
+        drainPooled(budget);
+    }
+}
+
+// Claims the whole budget up front, highest priority first, and lets the
+// scheduler spread it over the workers. Outcomes are buffered per worker so
+// the hot loop shares no lock; they are applied once every job has run.
+void TaskProcessor::drainStealing(const std::array<size_t, kPriorityLevels>& budget) {
+    std::array<std::vector<Task*>, kPriorityLevels> bands;
+    for (size_t i = kPriorityLevels; i-- > 0;) {
+        ReadyList& list = readyLists[i];
+        bands[i].reserve(std::min(budget[i], list.size));
+        for (size_t left = budget[i]; left > 0 && list.head; left--) {
+            Task* task = list.head;
+            TP_LOG_DEBUG(*logger, "[TaskProcessor] Processing task #" << task->id 
+                << ": " << task->title);
+            setStatus(*task, TaskStatus::IN_PROGRESS);
+            bands[i].push_back(task);
+        }
+    }
+    
+    struct Outcome {
+        Task* task;
+        bool success;
+        long long finishedAt;
+    };
+    std::vector<std::vector<Outcome>> outcomes(workerCount);
+    stealer->run(bands, [this, &outcomes](Task* task, size_t worker) {
+        long long started = beginService(*task);
+        bool success = executeTask(*task);
+        outcomes[worker].push_back({task, success, getCurrentTimestamp()});
+        endService(started);
+    });
+    
+    for (const auto& perWorker : outcomes) {
+        for (const Outcome& outcome : perWorker) {
+            finishTask(*outcome.task, outcome.success, outcome.finishedAt);
+        }
+    }
+}
+
+void TaskProcessor::drainPooled(const std::array<size_t, kPriorityLevels>& budget) {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    drainBudget = budget;
+    workReady.notify_all();
+    drainDone.wait(lock, [this] { return inFlight == 0 && !hasClaimableTask(); });
+    drainBudget.fill(0);
+}
+
+bool TaskProcessor::hasClaimableTask() const {
+    for (size_t i = 0; i < kPriorityLevels; i++) {
+        if (drainBudget[i] > 0 && readyLists[i].head) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Takes the head of the highest-priority list that still has budget and
+// marks it IN_PROGRESS. Called with poolMutex held.
+Task* TaskProcessor::claimReady() {
+    for (size_t i = kPriorityLevels; i-- > 0;) {
+        // The budget is checked first: outside a drain the caller owns the
+        // lists and idle workers must not touch them
+        if (drainBudget[i] == 0 || !readyLists[i].head) {
+            continue;
+        }
+        Task* task = readyLists[i].head;
+        drainBudget[i]--;
+        TP_LOG_DEBUG(*logger, "[TaskProcessor] Processing task #" << task->id 
+            << ": " << task->title);
+        setStatus(*task, TaskStatus::IN_PROGRESS);
+        return task;
+    }
+    return nullptr;
+}
+
+void TaskProcessor::workerLoop() {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    while (!stopWorkers) {
+        Task* task = claimReady();
+        if (!task) {
+            workReady.wait(lock);
+            continue;
+        }
+        
+        inFlight++;
+        lock.unlock();
+        long long started = beginService(*task);
+        bool success = executeTask(*task);
+        lock.lock();
+        finishTask(*task, success);
+        endService(started);
+        inFlight--;
+        
+        if (inFlight == 0 && !hasClaimableTask()) {
+            drainDone.notify_all();
         }
     }
 }
 
 // Query methods
 std::shared_ptr<Task> TaskProcessor::getTask(int taskId) const {
-    auto it = std::find_if(tasks.begin(), tasks.end(),
-                          [taskId](const std::shared_ptr<Task>& t) { 
-                              return t->id == taskId; 
-                          });
-    return (it != tasks.end()) ? *it : nullptr;
+    size_t slot;
+    return slotFor(taskId, slot) ? taskAt(slot) : nullptr;
 }
 
 std::vector<std::shared_ptr<Task>> TaskProcessor::getAllTasks() const {
-    return tasks;
+    LatencyTimer timer(*metrics, LatencyMetric::QUERY);
+    std::vector<std::shared_ptr<Task>> all;
+    all.reserve(liveCount);
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        if (store.isLive(slot)) all.push_back(taskAt(slot));
+    }
+    return all;
+}
+
+// Filters run the column kernels and only touch matching tasks
+std::vector<uint32_t> TaskProcessor::selectRows(const TaskQuery& predicate) const {
+    std::vector<uint32_t> rows(store.rowCount());
+    size_t found = queryKernels().select(store.statusColumn(), store.priorityColumn(),
+                                         store.rowCount(), predicate, rows.data());
+    rows.resize(found);
+    return rows;
 }
 
 std::vector<std::shared_ptr<Task>> TaskProcessor::getTasksByStatus(TaskStatus status) const {
+    LatencyTimer timer(*metrics, LatencyMetric::QUERY);
     std::vector<std::shared_ptr<Task>> filtered;
-    std::copy_if(tasks.begin(), tasks.end(), std::back_inserter(filtered),
-                [status](const std::shared_ptr<Task>& t) { 
-                    return t->status == status; 
-                });
+    for (uint32_t row : selectRows(TaskQuery::withStatus(status))) {
+        filtered.push_back(taskAt(row));
+    }
     return filtered;
 }
 
 std::vector<std::shared_ptr<Task>> TaskProcessor::getTasksByPriority(TaskPriority priority) const {
+    LatencyTimer timer(*metrics, LatencyMetric::QUERY);
     std::vector<std::shared_ptr<Task>> filtered;
-    std::copy_if(tasks.begin(), tasks.end(), std::back_inserter(filtered),
-                [priority](const std::shared_ptr<Task>& t) { 
-                    return t->priority == priority; 
-                });
+    for (uint32_t row : selectRows(TaskQuery::withPriority(priority))) {
+        filtered.push_back(taskAt(row));
+    }
     return filtered;
 }
 
+std::optional<TaskView> TaskProcessor::getTaskView(int taskId) const {
+    size_t slot;
+    if (!slotFor(taskId, slot)) {
+        return std::nullopt;
+    }
+    return store.view(slot);
+}
+
+// A handle can outlive its task (or come from another processor), so it
+// gets the same range and liveness check as an id
+std::optional<TaskView> TaskProcessor::getTaskView(TaskHandle handle) const {
+    return getTaskView(handle.id);
+}
+
+std::vector<TaskHandle> TaskProcessor::findByStatus(TaskStatus status) const {
+    std::vector<TaskHandle> handles;
+    for (int id : query(TaskQuery::withStatus(status))) {
+        handles.push_back(TaskHandle{id});
+    }
+    return handles;
+}
+
+std::vector<TaskHandle> TaskProcessor::findByPriority(TaskPriority priority) const {
+    std::vector<TaskHandle> handles;
+    for (int id : query(TaskQuery::withPriority(priority))) {
+        handles.push_back(TaskHandle{id});
+    }
+    return handles;
+}
+
+std::vector<int> TaskProcessor::query(const TaskQuery& predicate) const {
+    LatencyTimer timer(*metrics, LatencyMetric::QUERY);
+    std::vector<int> ids;
+    const int* idColumn = store.idColumn();
+    for (uint32_t row : selectRows(predicate)) {
+        ids.push_back(idColumn[row]);
+    }
+    return ids;
+}
+
+size_t TaskProcessor::serializeTasks(char* buffer, size_t capacity, const TaskQuery& filter) const {
+    return writeWire(store, selectRows(filter), buffer, capacity);
+}
+
+bool TaskProcessor::serializeTasks(WireSegments& out, const TaskQuery& filter) const {
+    return gatherWire(store, selectRows(filter), out);
+}
+
+size_t TaskProcessor::writeTasksJson(JsonWriter& out, const TaskQuery& filter,
+                                     size_t offset, size_t limit) const {
+    size_t total = countMatching(filter);
+    out.beginObject();
+    out.key("total").value(total);
+    out.key("offset").value(offset);
+    out.key("limit");
+    if (limit == SIZE_MAX) out.null();
+    else out.value(limit);
+
+    out.key("tasks").beginArray();
+    const uint8_t* statuses = store.statusColumn();
+    const uint8_t* priorities = store.priorityColumn();
+    size_t skipped = 0;
+    size_t written = 0;
+    for (size_t row = 0; row < store.rowCount() && written < limit; row++) {
+        if (!filter.matches(statuses[row], priorities[row])) continue;
+        if (skipped < offset) {
+            skipped++;
+            continue;
+        }
+        out.task(store.view(row));
+        written++;
+    }
+    out.endArray();
+
+    out.key("next_offset");
+    if (offset + written < total) out.value(offset + written);
+    else out.null();
+    out.endObject();
+    return written;
+}
+
+TaskBitmap TaskProcessor::queryBitmap(const TaskQuery& predicate) const {
+    LatencyTimer timer(*metrics, LatencyMetric::QUERY);
+    TaskBitmap bitmap;
+    bitmap.firstId = firstSlotId;
+    bitmap.rows = store.rowCount();
+    bitmap.words.resize((bitmap.rows + 63) / 64);
+    queryKernels().bitmap(store.statusColumn(), store.priorityColumn(),
+                          bitmap.rows, predicate, bitmap.words.data());
+    return bitmap;
+}
+
+size_t TaskProcessor::countMatching(const TaskQuery& predicate) const {
+    LatencyTimer timer(*metrics, LatencyMetric::QUERY);
+    return queryKernels().count(store.statusColumn(), store.priorityColumn(),
+                                store.rowCount(), predicate);
+}
+
+const TaskStore& TaskProcessor::getStore() const {
+    return store;
+}
+
 // Statistics
 int TaskProcessor::getProcessedCount() const {
-    return processedCount;
+    return processedCount.load(std::memory_order_relaxed);
 }
 
 int TaskProcessor::getFailedCount() const {
-    return failedCount;
+    return failedCount.load(std::memory_order_relaxed);
 }
 
 int TaskProcessor::getTotalCount() const {
-    return static_cast<int>(tasks.size());
+    return static_cast<int>(liveCount);
 }
 
 int TaskProcessor::getPendingCount() const {
-    return static_cast<int>(getTasksByStatus(TaskStatus::PENDING).size());
+    return statusCount[static_cast<size_t>(TaskStatus::PENDING)];
 }
 
+int TaskProcessor::getStatusCount(TaskStatus status) const {
+    return statusCount[static_cast<size_t>(status)];
+}
+
+int TaskProcessor::getPriorityCount(TaskPriority priority) const {
+    return priorityCount[static_cast<size_t>(priority)];
+}
+
+// Only levels with at least one task are reported, as before
 std::map<TaskPriority, int> TaskProcessor::getPriorityStats() const {
-    return priorityCount;
+    std::map<TaskPriority, int> stats;
+    for (size_t i = 0; i < kPriorityLevels; i++) {
+        if (priorityCount[i] > 0) {
+            stats.emplace_hint(stats.end(), static_cast<TaskPriority>(i), priorityCount[i]);
+        }
+    }
+    return stats;
 }
 
 std::map<TaskStatus, int> TaskProcessor::getStatusStats() const {
-    return statusCount;
+    std::map<TaskStatus, int> stats;
+    for (size_t i = 0; i < kStatusLevels; i++) {
+        if (statusCount[i] > 0) {
+            stats.emplace_hint(stats.end(), static_cast<TaskStatus>(i), statusCount[i]);
+        }
+    }
+    return stats;
+}
+
+void TaskProcessor::setLatencyMetricsEnabled(bool enabled) {
+    metrics->setLatencyEnabled(enabled);
+}
+
+bool TaskProcessor::isLatencyMetricsEnabled() const {
+    return metrics->latencyEnabled();
+}
+
+TaskMetricsSnapshot TaskProcessor::getMetrics() const {
+    return metrics->snapshot();
+}
+
+void TaskProcessor::resetMetrics() {
+    metrics->reset();
 }
 
 // Utility
 void TaskProcessor::clearTasks() {
-    tasks.clear();
-    updateCounts();
-    std::cout << "[TaskProcessor] All tasks cleared" << std::endl;
+    slots.clear();
+    readyLists.fill(ReadyList());
+    liveCount = 0;
+    trimTombstones();
+    priorityCount.fill(0);
+    statusCount.fill(0);
+    if (wal) {
+        logMutation(WalRecord{WalRecordType::CLEAR});
+    }
+    TP_LOG_INFO(*logger, "[TaskProcessor] All tasks cleared");
 }
 
 void TaskProcessor::clearCompleted() {
-    auto it = std::remove_if(tasks.begin(), tasks.end(),
-                            [](const std::shared_ptr<Task>& t) {
-                                return t->status == TaskStatus::COMPLETED;
-                            });
-    size_t removed = std::distance(it, tasks.end());
-    tasks.erase(it, tasks.end());
-    updateCounts();
+    size_t removed = 0;
+    const uint8_t* statuses = store.statusColumn();
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        if (statuses[slot] == static_cast<uint8_t>(TaskStatus::COMPLETED)) {
+            releaseSlot(slot);
+            removed++;
+        }
+    }
+    trimTombstones();
+    verifyCounts();
+    if (wal) {
+        logMutation(WalRecord{WalRecordType::CLEAR_COMPLETED});
+    }
     
-    std::cout << "[TaskProcessor] Cleared " << removed << " completed tasks" << std::endl;
+    TP_LOG_INFO(*logger, "[TaskProcessor] Cleared " << removed << " completed tasks");
 }
 
 std::string TaskProcessor::getTaskSummary() const {
     std::ostringstream oss;
     oss << "\n=== Task Processor Summary ===\n";
     oss << "Total Tasks: " << getTotalCount() << "\n";
-    oss << "Processed: " << processedCount << "\n";
-    oss << "Failed: " << failedCount << "\n";
+    oss << "Processed: " << getProcessedCount() << "\n";
+    oss << "Failed: " << getFailedCount() << "\n";
     oss << "Pending: " << getPendingCount() << "\n\n";
     
     oss << "By Priority:\n";
-    for (const auto& [priority, count] : priorityCount) {
+    for (const auto& [priority, count] : getPriorityStats()) {
         oss << "  " << priorityToString(priority) << ": " << count << "\n";
     }
     
     oss << "\nBy Status:\n";
-    for (const auto& [status, count] : statusCount) {
+    for (const auto& [status, count] : getStatusStats()) {
         oss << "  " << statusToString(status) << ": " << count << "\n";
     }
     oss << "============================\n";
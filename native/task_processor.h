@@ -1,10 +1,28 @@
 #ifndef TASK_PROCESSOR_H
 #define TASK_PROCESSOR_H
 
+#include "logger.h"
+#include "task_store.h"
+#include "task_query.h"
+#include "task_wal.h"
+#include "task_snapshot.h"
+#include "task_wire.h"
+#include "task_json.h"
+#include "task_metrics.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 // Task priority levels
 enum class TaskPriority {
@@ -22,35 +40,180 @@ enum class TaskStatus {
     FAILED
 };
 
-// Task structure
+// Number of enumerators, used to size enum-indexed tables
+constexpr size_t kPriorityLevels = 4;
+constexpr size_t kStatusLevels = 4;
+
+// Task structure. The strings allocate from the same memory resource as the
+// task itself (see TaskProcessor's memory resource constructor).
 struct Task {
     int id;
-    std::string title;
-    std::string description;
+    std::pmr::string title;
+    std::pmr::string description;
     TaskPriority priority;
     TaskStatus status;
     long long createdAt;
     long long completedAt;
     
-    Task(int id, const std::string& title, const std::string& desc = "", 
-         TaskPriority prio = TaskPriority::MEDIUM);
+    // Ready-queue links, maintained by TaskProcessor while the task is PENDING
+    Task* readyPrev;
+    Task* readyNext;
+    
+    Task(int id, std::string_view title, std::string_view desc = {},
+         TaskPriority prio = TaskPriority::MEDIUM,
+         std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+};
+
+// How a worker pool drains tasks: one mutex-protected set of ready queues,
+// or per-worker work-stealing deques (see work_stealing.h)
+enum class SchedulingMode {
+    SHARED_QUEUE,
+    WORK_STEALING
+};
+
+class WorkStealingScheduler;
+
+// Processing logic plugged into TaskProcessor; returns true on success.
+// With a worker pool it runs concurrently and outside the processor's lock,
+// so it must not call back into the same TaskProcessor.
+using TaskWorkFunction = std::function<bool(const Task&)>;
+
+// One task for TaskProcessor::addTasks; the strings are copied during the call
+struct TaskSpec {
+    std::string_view title;
+    std::string_view description;
+    TaskPriority priority = TaskPriority::MEDIUM;
+};
+
+// One entry for TaskProcessor::updateStatuses
+struct TaskStatusUpdate {
+    int id;
+    TaskStatus status;
 };
 
 // Task processor class
 class TaskProcessor {
 private:
-    std::vector<std::shared_ptr<Task>> tasks;
-    std::map<TaskPriority, int> priorityCount;
-    std::map<TaskStatus, int> statusCount;
+    std::shared_ptr<Logger> logger;
+    // Source of every Task object and its strings
+    std::pmr::memory_resource* memory;
+    
+    // Slot table indexed by (id - firstSlotId). Ids are handed out
+    // monotonically, so a removed task leaves a tombstone and every id-keyed
+    // lookup stays O(1) while iteration keeps insertion order. The store row
+    // decides liveness: tasks loaded from a snapshot keep a nullptr slot
+    // until taskAt() first builds them.
+    mutable std::vector<std::shared_ptr<Task>> slots;
+    int firstSlotId;
+    size_t liveCount;
+    size_t leadingTombstones;
+    // Columnar mirror of the slot table (row == slot) used for scans and the
+    // handle/view query API. Its strings are borrowed: a row points at its
+    // slot's Task strings (which never move, the Task being heap-allocated
+    // and the strings never reassigned) or, for lazy rows, into the mapped
+    // snapshot, so each title and description is held once.
+    TaskStore store;
+    // Maintained by deltas on every mutation, indexed by enum value
+    std::array<int, kPriorityLevels> priorityCount;
+    std::array<int, kStatusLevels> statusCount;
+    
+    // Intrusive FIFO of PENDING tasks for one priority level
+    struct ReadyList {
+        Task* head = nullptr;
+        Task* tail = nullptr;
+        size_t size = 0;
+    };
+    std::array<ReadyList, kPriorityLevels> readyLists;
     int nextId;
-    int processedCount;
-    int failedCount;
+    std::atomic<int> processedCount;
+    std::atomic<int> failedCount;
+    
+    // Worker pool. With no workers everything runs inline on the caller;
+    // otherwise processAll/processByPriority hand their drain budget to the
+    // workers and block until it is used up. Workers claim tasks under
+    // poolMutex, always from the highest non-empty priority.
+    TaskWorkFunction workFunction;
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable workReady;
+    std::condition_variable drainDone;
+    std::array<size_t, kPriorityLevels> drainBudget;
+    size_t inFlight;
+    bool stopWorkers;
+    
+    // WORK_STEALING mode moves the drain budget into a WorkStealingScheduler;
+    // workers record outcomes locally and they are applied when the drain ends
+    SchedulingMode schedulingMode;
+    size_t workerCount;
+    size_t starvationLimit;
+    std::unique_ptr<WorkStealingScheduler> stealer;
+    
+    // Optional write-ahead log. Mutations append a record; worker outcomes
+    // never wait for fsync, so a crash mid-drain can re-run finished tasks
+    // but never lose a submitted one. Transient IN_PROGRESS marks set by the
+    // runners are not logged: interrupted tasks come back PENDING.
+    std::shared_ptr<WriteAheadLog> wal;
+    size_t walCheckpointBytes;
+    
+    // Snapshot the current tasks were loaded from; store rows borrow its
+    // strings, and its log position tells enableWal where replay resumes
+    std::shared_ptr<MappedSnapshot> snapshot;
+    
+    // Throughput counters and latency histograms (task_metrics.h); never
+    // replaced, so getMetrics() can read it from any thread
+    std::unique_ptr<TaskMetrics> metrics;
 
-    void updateCounts();
+    void countTask(const Task& task, int delta);
+    void verifyCounts() const;
+    bool slotFor(int taskId, size_t& slot) const;
+    Task* findTask(int taskId) const;
+    const std::shared_ptr<Task>& taskAt(size_t slot) const;
+    std::shared_ptr<Task> makeTask(int id, std::string_view title, std::string_view description,
+                                   TaskPriority priority) const;
+    std::vector<uint32_t> selectRows(const TaskQuery& predicate) const;
+    void setStatus(Task& task, TaskStatus status, long long timestamp = 0);
+    void applyStatus(Task& task, TaskStatus status, long long timestamp);
+    void enqueueReady(Task& task);
+    void unlinkReady(Task& task);
+    void runTask(Task& task);
+    long long beginService(const Task& task);
+    void endService(long long startedAt);
+    bool executeTask(const Task& task);
+    void finishTask(Task& task, bool success, long long finishedAt = 0);
+    void drainReady(TaskPriority priority);
+    void drainPooled(const std::array<size_t, kPriorityLevels>& budget);
+    void drainStealing(const std::array<size_t, kPriorityLevels>& budget);
+    void drainBudgeted(const std::array<size_t, kPriorityLevels>& budget);
+    Task* claimReady();
+    bool hasClaimableTask() const;
+    void workerLoop();
+    void stopPool();
+    void startPool();
+    void releaseSlot(size_t slot);
+    void trimTombstones();
+    void insertTask(const std::shared_ptr<Task>& task);
+    void restoreTask(const WalRecord& record);
+    void padSlots(int id);
+    void resetTasks();
+    void applyWalRecord(const WalRecord& record);
+    void logMutation(const WalRecord& record);
+    void commitBatch(uint64_t sequence);
+    [[noreturn]] void failCommit();
+    void commitDrain();
+    void maybeCheckpointWal();
+    void writeImage(const std::function<void(const WalRecord&)>& emit) const;
     long long getCurrentTimestamp() const;
 
 public:
     TaskProcessor();
+    explicit TaskProcessor(std::shared_ptr<Logger> sink);
+    // Allocates every Task and its strings from `resource` (nullptr = the
+    // default resource). With a std::pmr::monotonic_buffer_resource a batch
+    // of tasks costs a pointer bump each and is freed by one release()
+    // after clearTasks(). The resource must outlive the processor and every
+    // Task pointer it hands out, and it is not locked: share one between
+    // processors on different threads only if it is synchronized.
+    TaskProcessor(std::shared_ptr<Logger> sink, std::pmr::memory_resource* resource);
     ~TaskProcessor();
     
     // Task management
@@ -60,25 +223,127 @@ public:
     bool updateTaskStatus(int taskId, TaskStatus status);
     bool updateTaskPriority(int taskId, TaskPriority priority);
     
+    // Batch mutations. Each call reserves capacity once, applies the
+    // counter changes once, waits for the write-ahead log once and logs one
+    // summary line, instead of doing all of that per task. addTasks assigns
+    // consecutive ids in spec order, writes them to idsOut (count entries,
+    // may be null) and returns count; the others return how many of the
+    // ids were found. Unknown ids are skipped.
+    //
+    // addTasks writes each id as soon as its task is inserted. If it throws
+    // part-way (allocation failure, or a failed write-ahead log commit),
+    // the tasks inserted so far stay and are counted, their idsOut entries
+    // are set, and the entries after them are left as they were; a caller
+    // that zero-fills idsOut can count the added tasks up to the first 0.
+    size_t addTasks(const TaskSpec* specs, size_t count, int* idsOut = nullptr);
+    size_t updateStatuses(const TaskStatusUpdate* updates, size_t count);
+    size_t removeTasks(const int* taskIds, size_t count);
+    
     // Processing
     void processTask(int taskId);
     void processAll();
     void processByPriority(TaskPriority priority);
     
-    // Query methods
+    // Logging (defaults to the shared StreamLogger)
+    void setLogger(std::shared_ptr<Logger> sink);
+    std::shared_ptr<Logger> getLogger() const;
+    std::pmr::memory_resource* getMemoryResource() const;
+    
+    // Execution mode
+    void setWorkFunction(TaskWorkFunction work);
+    void setWorkerCount(size_t count);
+    size_t getWorkerCount() const;
+    void setSchedulingMode(SchedulingMode mode, size_t starvationLimit = 64);
+    SchedulingMode getSchedulingMode() const;
+    
+    // Durability. enableWal replays an existing log into this processor,
+    // compacts it and logs every later mutation; it returns false if the
+    // file cannot be opened or written, or holds a record it cannot decode
+    // (the records before it stay applied and the file is not modified).
+    //
+    // With WalOptions::waitForCommit, a mutation or processing call whose
+    // record could not be written or fsynced throws std::system_error
+    // (carrying the errno) once the change has been applied in memory. The
+    // log stays failed, and every later waiting call throws, until
+    // checkpointWal() rewrites it from the current state.
+    bool enableWal(const std::string& path, const WalOptions& options = WalOptions());
+    void disableWal();
+    bool isWalEnabled() const;
+    // Rewrites the log as a compact image of the current state
+    bool checkpointWal();
+    // Blocks until every logged mutation is on disk; false if the log has
+    // failed (or none is attached)
+    bool syncWal();
+    // errno of the log's failed write or fsync, 0 while it is healthy
+    int getWalError() const;
+    
+    // Snapshots. The task set is captured on the calling thread and written
+    // (then, with a log attached, the covered log prefix dropped) in the
+    // background. loadSnapshot replaces the current tasks and must come
+    // before enableWal; it maps the file and reads only the fixed-width
+    // records, so strings and untouched tasks are paged in on demand.
+    bool saveSnapshot(const std::string& path);
+    std::future<bool> saveSnapshotAsync(const std::string& path);
+    bool loadSnapshot(const std::string& path, bool verifyChecksums = false);
+    
+    // Query methods. The returned tasks are the processor's own and must not
+    // be modified; the columnar store reads their strings in place.
     std::shared_ptr<Task> getTask(int taskId) const;
     std::vector<std::shared_ptr<Task>> getAllTasks() const;
     std::vector<std::shared_ptr<Task>> getTasksByStatus(TaskStatus status) const;
     std::vector<std::shared_ptr<Task>> getTasksByPriority(TaskPriority priority) const;
     
+    // Columnar queries: scan the TaskStore and return handles/views instead
+    // of shared_ptrs. Views are valid until the next removal or clear; a
+    // stale or foreign handle yields nullopt like an unknown id.
+    std::optional<TaskView> getTaskView(int taskId) const;
+    std::optional<TaskView> getTaskView(TaskHandle handle) const;
+    std::vector<TaskHandle> findByStatus(TaskStatus status) const;
+    std::vector<TaskHandle> findByPriority(TaskPriority priority) const;
+    const TaskStore& getStore() const;
+    
+    // Combined status/priority predicates evaluated by the SIMD column
+    // kernels, e.g. query(TaskQuery::withStatus(PENDING).priorityAtLeast(HIGH))
+    std::vector<int> query(const TaskQuery& predicate) const;
+    TaskBitmap queryBitmap(const TaskQuery& predicate) const;
+    size_t countMatching(const TaskQuery& predicate) const;
+    
+    // Binary export in the task_wire.h format. The buffer form returns the
+    // batch size and writes only if it fits (0: over the 4 GiB limit); the
+    // gather form copies only short strings and is valid until the next
+    // mutation.
+    size_t serializeTasks(char* buffer, size_t capacity,
+                          const TaskQuery& filter = TaskQuery::all()) const;
+    bool serializeTasks(WireSegments& out, const TaskQuery& filter = TaskQuery::all()) const;
+    
+    // One page of a JSON listing (task_json.h):
+    // {"total":N,"offset":O,"limit":L,"tasks":[...],"next_offset":O2|null}
+    // Walks the columns directly, so no memory is allocated. Returns the
+    // number of tasks written.
+    size_t writeTasksJson(JsonWriter& out, const TaskQuery& filter = TaskQuery::all(),
+                          size_t offset = 0, size_t limit = SIZE_MAX) const;
+    
     // Statistics
     int getProcessedCount() const;
     int getFailedCount() const;
     int getTotalCount() const;
     int getPendingCount() const;
+    int getStatusCount(TaskStatus status) const;
+    int getPriorityCount(TaskPriority priority) const;
     std::map<TaskPriority, int> getPriorityStats() const;
     std::map<TaskStatus, int> getStatusStats() const;
     
+    // Metrics. Tasks added, completed and failed per priority are always
+    // counted; latency histograms (add/update/process/query calls, queue
+    // wait and service time per task) cost two clock reads per operation
+    // and are recorded only once enabled. getMetrics() takes a consistent
+    // copy without locking, so it may run on any thread while the processor
+    // works; export it with toPrometheus() or writeJson().
+    void setLatencyMetricsEnabled(bool enabled);
+    bool isLatencyMetricsEnabled() const;
+    TaskMetricsSnapshot getMetrics() const;
+    void resetMetrics();
+    
     // Utility
     void clearTasks();
     void clearCompleted();
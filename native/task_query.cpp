@@ -0,0 +1,259 @@
+#include "task_query.h"
+#include "task_processor.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TASK_QUERY_X86 1
+#endif
+
+// ============ TaskQuery Implementation ============
+
+static uint8_t bitFor(TaskStatus status) {
+    return static_cast<uint8_t>(1u << static_cast<unsigned>(status));
+}
+
+static uint8_t bitFor(TaskPriority priority) {
+    return static_cast<uint8_t>(1u << static_cast<unsigned>(priority));
+}
+
+TaskQuery TaskQuery::withStatus(TaskStatus status) {
+    return TaskQuery().status(status);
+}
+
+TaskQuery TaskQuery::withPriority(TaskPriority priority) {
+    return TaskQuery().priority(priority);
+}
+
+TaskQuery& TaskQuery::status(TaskStatus status) {
+    statusMask = bitFor(status);
+    return *this;
+}
+
+TaskQuery& TaskQuery::orStatus(TaskStatus status) {
+    statusMask |= bitFor(status);
+    return *this;
+}
+
+TaskQuery& TaskQuery::priority(TaskPriority priority) {
+    priorityMask = bitFor(priority);
+    return *this;
+}
+
+TaskQuery& TaskQuery::priorityAtLeast(TaskPriority priority) {
+    priorityMask &= static_cast<uint8_t>(0x0F & ~(bitFor(priority) - 1));
+    return *this;
+}
+
+TaskQuery& TaskQuery::priorityAtMost(TaskPriority priority) {
+    priorityMask &= static_cast<uint8_t>((bitFor(priority) << 1) - 1);
+    return *this;
+}
+
+// ============ TaskBitmap Implementation ============
+
+bool TaskBitmap::test(int taskId) const {
+    if (taskId < firstId) return false;
+    size_t row = static_cast<size_t>(taskId - firstId);
+    return row < rows && ((words[row / 64] >> (row % 64)) & 1);
+}
+
+size_t TaskBitmap::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+// ============ Scalar Kernels ============
+
+static uint64_t scalarWord(const uint8_t* statuses, const uint8_t* priorities,
+                           size_t count, TaskQuery query) {
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; i++) {
+        word |= static_cast<uint64_t>(query.matches(statuses[i], priorities[i])) << i;
+    }
+    return word;
+}
+
+static size_t scalarCount(const uint8_t* statuses, const uint8_t* priorities,
+                          size_t rows, TaskQuery query) {
+    size_t total = 0;
+    for (size_t row = 0; row < rows; row++) {
+        total += query.matches(statuses[row], priorities[row]);
+    }
+    return total;
+}
+
+static void scalarBitmap(const uint8_t* statuses, const uint8_t* priorities,
+                         size_t rows, TaskQuery query, uint64_t* words) {
+    for (size_t base = 0; base < rows; base += 64) {
+        size_t count = rows - base < 64 ? rows - base : 64;
+        words[base / 64] = scalarWord(statuses + base, priorities + base, count, query);
+    }
+}
+
+static size_t scalarSelect(const uint8_t* statuses, const uint8_t* priorities,
+                           size_t rows, TaskQuery query, uint32_t* out) {
+    size_t found = 0;
+    for (size_t row = 0; row < rows; row++) {
+        out[found] = static_cast<uint32_t>(row);
+        found += query.matches(statuses[row], priorities[row]);
+    }
+    return found;
+}
+
+// Appends the rows of the set bits in `word`, numbered from `base`
+static size_t emitRows(uint64_t word, size_t base, uint32_t* out) {
+    size_t found = 0;
+    while (word) {
+        out[found++] = static_cast<uint32_t>(base + __builtin_ctzll(word));
+        word &= word - 1;
+    }
+    return found;
+}
+
+#ifdef TASK_QUERY_X86
+
+// ============ SIMD Kernels ============
+//
+// Set membership is a pshufb lookup: the table holds 0xFF at index v when
+// value v is in the mask. Bytes with the high bit set (the 0xFF tombstone)
+// make pshufb return 0, and values 4..15 hit zero entries, so neither can
+// match.
+
+__attribute__((target("sse4.2")))
+static __m128i lookupTable128(uint8_t mask) {
+    alignas(16) uint8_t table[16] = {};
+    for (unsigned v = 0; v < 8; v++) {
+        table[v] = (mask >> v) & 1 ? 0xFF : 0x00;
+    }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+}
+
+__attribute__((target("sse4.2")))
+static uint64_t sse42Word(const uint8_t* statuses, const uint8_t* priorities,
+                          __m128i statusTable, __m128i priorityTable) {
+    uint64_t word = 0;
+    for (int lane = 0; lane < 4; lane++) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(statuses + lane * 16));
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(priorities + lane * 16));
+        __m128i hit = _mm_and_si128(_mm_shuffle_epi8(statusTable, s),
+                                    _mm_shuffle_epi8(priorityTable, p));
+        word |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(hit))) << (lane * 16);
+    }
+    return word;
+}
+
+__attribute__((target("avx2")))
+static uint64_t avx2Word(const uint8_t* statuses, const uint8_t* priorities,
+                         __m256i statusTable, __m256i priorityTable) {
+    uint64_t word = 0;
+    for (int lane = 0; lane < 2; lane++) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(statuses + lane * 32));
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(priorities + lane * 32));
+        __m256i hit = _mm256_and_si256(_mm256_shuffle_epi8(statusTable, s),
+                                       _mm256_shuffle_epi8(priorityTable, p));
+        word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hit))) << (lane * 32);
+    }
+    return word;
+}
+
+// The three kernels share one loop: whole 64-row words go through the
+// vector path and the tail through the scalar one.
+#define TASK_QUERY_KERNELS(prefix, setup, wordExpr)                                      \
+    static size_t prefix##Count(const uint8_t* statuses, const uint8_t* priorities,       \
+                                size_t rows, TaskQuery query) {                          \
+        setup;                                                                            \
+        size_t total = 0, base = 0;                                                       \
+        for (; base + 64 <= rows; base += 64) {                                           \
+            total += static_cast<size_t>(__builtin_popcountll(wordExpr));                 \
+        }                                                                                 \
+        return total + scalarCount(statuses + base, priorities + base, rows - base, query); \
+    }                                                                                     \
+    static void prefix##Bitmap(const uint8_t* statuses, const uint8_t* priorities,        \
+                               size_t rows, TaskQuery query, uint64_t* words) {           \
+        setup;                                                                            \
+        size_t base = 0;                                                                  \
+        for (; base + 64 <= rows; base += 64) {                                           \
+            words[base / 64] = wordExpr;                                                  \
+        }                                                                                 \
+        if (base < rows) {                                                                \
+            words[base / 64] = scalarWord(statuses + base, priorities + base, rows - base, query); \
+        }                                                                                 \
+    }                                                                                     \
+    static size_t prefix##Select(const uint8_t* statuses, const uint8_t* priorities,      \
+                                 size_t rows, TaskQuery query, uint32_t* out) {           \
+        setup;                                                                            \
+        size_t found = 0, base = 0;                                                       \
+        for (; base + 64 <= rows; base += 64) {                                           \
+            found += emitRows(wordExpr, base, out + found);                               \
+        }                                                                                 \
+        uint64_t tail = scalarWord(statuses + base, priorities + base, rows - base, query); \
+        return found + emitRows(tail, base, out + found);                                 \
+    }
+
+#define SSE42_SETUP                                             \
+    __m128i statusTable = lookupTable128(query.statusMask);     \
+    __m128i priorityTable = lookupTable128(query.priorityMask)
+#define SSE42_WORD sse42Word(statuses + base, priorities + base, statusTable, priorityTable)
+
+#define AVX2_SETUP                                                                  \
+    __m256i statusTable = _mm256_broadcastsi128_si256(lookupTable128(query.statusMask)); \
+    __m256i priorityTable = _mm256_broadcastsi128_si256(lookupTable128(query.priorityMask))
+#define AVX2_WORD avx2Word(statuses + base, priorities + base, statusTable, priorityTable)
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+TASK_QUERY_KERNELS(sse42, SSE42_SETUP, SSE42_WORD)
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+TASK_QUERY_KERNELS(avx2, AVX2_SETUP, AVX2_WORD)
+#pragma GCC pop_options
+
+#endif // TASK_QUERY_X86
+
+// ============ Dispatch ============
+
+SimdLevel detectSimdLevel() {
+#ifdef TASK_QUERY_X86
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.2")) return SimdLevel::SSE42;
+        return SimdLevel::SCALAR;
+    }();
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+const char* simdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE42: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+const QueryKernels& queryKernels(SimdLevel level) {
+    static const QueryKernels scalar = {scalarCount, scalarBitmap, scalarSelect};
+#ifdef TASK_QUERY_X86
+    static const QueryKernels sse42 = {sse42Count, sse42Bitmap, sse42Select};
+    static const QueryKernels avx2 = {avx2Count, avx2Bitmap, avx2Select};
+    if (level > detectSimdLevel()) level = detectSimdLevel();
+    if (level == SimdLevel::AVX2) return avx2;
+    if (level == SimdLevel::SSE42) return sse42;
+#else
+    (void)level;
+#endif
+    return scalar;
+}
+
+const QueryKernels& queryKernels() {
+    static const QueryKernels& best = queryKernels(detectSimdLevel());
+    return best;
+}
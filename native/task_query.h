@@ -0,0 +1,75 @@
+#ifndef TASK_QUERY_H
+#define TASK_QUERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class TaskPriority;
+enum class TaskStatus;
+
+// Predicate over the status and priority columns: a row matches when its
+// status is in statusMask and its priority is in priorityMask (bit N set
+// means value N is accepted). Tombstoned rows never match.
+//
+//   TaskQuery::withStatus(TaskStatus::PENDING).priorityAtLeast(TaskPriority::HIGH)
+struct TaskQuery {
+    uint8_t statusMask = 0x0F;
+    uint8_t priorityMask = 0x0F;
+
+    static TaskQuery all() { return TaskQuery(); }
+    static TaskQuery withStatus(TaskStatus status);
+    static TaskQuery withPriority(TaskPriority priority);
+
+    TaskQuery& status(TaskStatus status);
+    TaskQuery& orStatus(TaskStatus status);
+    TaskQuery& priority(TaskPriority priority);
+    TaskQuery& priorityAtLeast(TaskPriority priority);
+    TaskQuery& priorityAtMost(TaskPriority priority);
+
+    bool matches(uint8_t status, uint8_t priority) const {
+        return status < 8 && priority < 8 &&
+               ((statusMask >> status) & (priorityMask >> priority) & 1);
+    }
+};
+
+// One bit per row of the store at the time of the query; bit i describes
+// task id firstId + i
+struct TaskBitmap {
+    int firstId = 0;
+    size_t rows = 0;
+    std::vector<uint64_t> words;
+
+    bool test(int taskId) const;
+    size_t count() const;
+};
+
+// Instruction sets the query kernels can use, best last
+enum class SimdLevel {
+    SCALAR,
+    SSE42,
+    AVX2
+};
+
+// Best level supported by the running CPU (checked once)
+SimdLevel detectSimdLevel();
+const char* simdLevelToString(SimdLevel level);
+
+// Column kernels. Each exists in a scalar, SSE4.2 and AVX2 flavour; the
+// dispatching entry points below use the detected level unless one is
+// given (levels above the detected one fall back to it).
+struct QueryKernels {
+    size_t (*count)(const uint8_t* statuses, const uint8_t* priorities,
+                    size_t rows, TaskQuery query);
+    // Writes ceil(rows / 64) words
+    void (*bitmap)(const uint8_t* statuses, const uint8_t* priorities,
+                   size_t rows, TaskQuery query, uint64_t* words);
+    // Writes matching row numbers in ascending order, returns how many
+    size_t (*select)(const uint8_t* statuses, const uint8_t* priorities,
+                     size_t rows, TaskQuery query, uint32_t* out);
+};
+
+const QueryKernels& queryKernels();
+const QueryKernels& queryKernels(SimdLevel level);
+
+#endif // TASK_QUERY_H
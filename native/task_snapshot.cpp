@@ -0,0 +1,149 @@
+#include "task_snapshot.h"
+#include "task_store.h"
+#include "task_wal.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <cstdlib>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'T', 'P', 'S', 'N', 'A', 'P', 0, 1};
+constexpr size_t kHeapLimit = UINT32_MAX;
+
+uint32_t headerChecksum(SnapshotHeader header) {
+    header.headerCrc = 0;
+    return checksum32(&header, sizeof(header));
+}
+
+} // namespace
+
+// ============ Snapshot Writer ============
+
+std::string buildSnapshot(const TaskStore& store, SnapshotHeader header) {
+    std::vector<SnapshotRecord> records;
+    std::string heap;
+    for (size_t row = 0; row < store.rowCount(); row++) {
+        if (!store.isLive(row)) continue;
+        TaskView view = store.view(row);
+        if (heap.size() + view.title.size() + view.description.size() > kHeapLimit) {
+            return std::string();
+        }
+        SnapshotRecord record{};
+        record.id = view.id;
+        record.priority = store.priorityColumn()[row];
+        record.status = store.statusColumn()[row];
+        record.titleOffset = static_cast<uint32_t>(heap.size());
+        record.titleLength = static_cast<uint32_t>(view.title.size());
+        heap.append(view.title);
+        record.descriptionOffset = static_cast<uint32_t>(heap.size());
+        record.descriptionLength = static_cast<uint32_t>(view.description.size());
+        heap.append(view.description);
+        record.createdAt = view.createdAt;
+        record.completedAt = view.completedAt;
+        records.push_back(record);
+    }
+
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.recordCount = records.size();
+    header.heapBytes = heap.size();
+    header.recordsCrc = checksum32(records.data(), records.size() * sizeof(SnapshotRecord));
+    header.heapCrc = checksum32(heap.data(), heap.size());
+    header.reserved = 0;
+    header.headerCrc = headerChecksum(header);
+
+    std::string image;
+    image.reserve(sizeof(header) + records.size() * sizeof(SnapshotRecord) + heap.size());
+    image.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    image.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(SnapshotRecord));
+    image.append(heap);
+    return image;
+}
+
+// ============ MappedSnapshot Implementation ============
+
+std::shared_ptr<MappedSnapshot> MappedSnapshot::open(const std::string& path) {
+    const char* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    // No mmap: read the file into memory instead
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return nullptr;
+    std::fseek(file, 0, SEEK_END);
+    long length = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    char* buffer = length > 0 ? static_cast<char*>(std::malloc(length)) : nullptr;
+    if (!buffer || std::fread(buffer, 1, length, file) != static_cast<size_t>(length)) {
+        std::free(buffer);
+        std::fclose(file);
+        return nullptr;
+    }
+    std::fclose(file);
+    base = buffer;
+    size = static_cast<size_t>(length);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+        ::close(fd);
+        return nullptr;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return nullptr;
+    base = static_cast<const char*>(mapping);
+#endif
+
+    std::shared_ptr<MappedSnapshot> snapshot(new MappedSnapshot(base, size));
+    if (size < sizeof(SnapshotHeader)) return nullptr;
+    const SnapshotHeader& header = snapshot->header();
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header.version != kSnapshotVersion || headerChecksum(header) != header.headerCrc) {
+        return nullptr;
+    }
+    uint64_t recordBytes = header.recordCount * sizeof(SnapshotRecord);
+    if (header.recordCount > size / sizeof(SnapshotRecord) ||
+        sizeof(SnapshotHeader) + recordBytes + header.heapBytes != size) {
+        return nullptr;
+    }
+    snapshot->records = reinterpret_cast<const SnapshotRecord*>(base + sizeof(SnapshotHeader));
+    snapshot->heap = base + sizeof(SnapshotHeader) + recordBytes;
+    return snapshot;
+}
+
+MappedSnapshot::MappedSnapshot(const char* base, size_t size)
+    : base(base), size(size), records(nullptr), heap(nullptr) {
+}
+
+MappedSnapshot::~MappedSnapshot() {
+#ifdef _WIN32
+    std::free(const_cast<char*>(base));
+#else
+    munmap(const_cast<char*>(base), size);
+#endif
+}
+
+std::string_view MappedSnapshot::string(uint32_t offset, uint32_t length) const {
+    uint64_t end = static_cast<uint64_t>(offset) + length;
+    if (end > header().heapBytes) {
+        return std::string_view();
+    }
+    return std::string_view(heap + offset, length);
+}
+
+bool MappedSnapshot::verify() const {
+    const SnapshotHeader& h = header();
+    return checksum32(records, recordCount() * sizeof(SnapshotRecord)) == h.recordsCrc &&
+           checksum32(heap, static_cast<size_t>(h.heapBytes)) == h.heapCrc;
+}
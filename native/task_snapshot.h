@@ -0,0 +1,91 @@
+#ifndef TASK_SNAPSHOT_H
+#define TASK_SNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class TaskStore;
+
+constexpr uint32_t kSnapshotVersion = 1;
+
+// On-disk layout: this header, recordCount SnapshotRecords in id order, then
+// a heap holding every title and description back to back. All integers
+// are little-endian; both structs are laid out without padding.
+//
+// MappedSnapshot reads the structs in place, so only little-endian hosts
+// can write or read the format.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "snapshot files are mapped in place and need a little-endian host"
+#endif
+
+struct SnapshotHeader {
+    char magic[8];              // "TPSNAP\0\1"
+    uint32_t version;
+    uint32_t headerCrc;         // over the header with this field zeroed
+    uint64_t snapshotId;
+    uint64_t walGeneration;     // write-ahead log covered up to walOffset,
+    uint64_t walOffset;         // or 0 when no log was attached
+    uint64_t recordCount;
+    uint64_t heapBytes;
+    int32_t nextId;
+    uint32_t recordsCrc;
+    int64_t processedCount;
+    int64_t failedCount;
+    uint32_t heapCrc;
+    uint32_t reserved;
+};
+
+struct SnapshotRecord {
+    int32_t id;
+    uint8_t priority;
+    uint8_t status;
+    uint16_t reserved;
+    uint32_t titleOffset;
+    uint32_t titleLength;
+    uint32_t descriptionOffset;
+    uint32_t descriptionLength;
+    int64_t createdAt;
+    int64_t completedAt;
+};
+
+static_assert(sizeof(SnapshotHeader) == 88, "snapshot header layout changed");
+static_assert(sizeof(SnapshotRecord) == 40, "snapshot record layout changed");
+
+// Serializes the live rows of `store`; `header` supplies the counters and
+// log position, the rest of it is filled in here. Returns an empty string
+// if the strings do not fit the 32-bit heap offsets (4 GiB).
+std::string buildSnapshot(const TaskStore& store, SnapshotHeader header);
+
+// Read-only view of a snapshot file mapped into memory. Opening checks the
+// header and its checksum only; records and strings are paged in by the OS
+// as they are touched. verify() checksums the whole file.
+class MappedSnapshot {
+public:
+    // Returns nullptr if the file is missing, truncated or has a bad header
+    static std::shared_ptr<MappedSnapshot> open(const std::string& path);
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    const SnapshotHeader& header() const { return *reinterpret_cast<const SnapshotHeader*>(base); }
+    const SnapshotRecord& record(size_t index) const { return records[index]; }
+    size_t recordCount() const { return static_cast<size_t>(header().recordCount); }
+
+    // Empty view if the range falls outside the heap
+    std::string_view string(uint32_t offset, uint32_t length) const;
+
+    bool verify() const;
+
+private:
+    MappedSnapshot(const char* base, size_t size);
+
+    const char* base;
+    size_t size;
+    const SnapshotRecord* records;
+    const char* heap;
+};
+
+#endif // TASK_SNAPSHOT_H
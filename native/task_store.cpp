@@ -0,0 +1,159 @@
+#include "task_store.h"
+#include "task_processor.h"
+#include <algorithm>
+#include <cstring>
+
+// ============ StringArena Implementation ============
+
+StringArena::StringArena(size_t blockSize)
+    : blockSize(blockSize), cursor(nullptr), remaining(0), used(0) {
+}
+
+std::string_view StringArena::store(std::string_view text) {
+    if (text.empty()) {
+        return std::string_view();
+    }
+    if (text.size() > remaining) {
+        if (text.size() >= blockSize / 4) {
+            // Large strings get a block of their own so the current block
+            // keeps its free space
+            blocks.emplace_back(new char[text.size()]);
+            std::memcpy(blocks.back().get(), text.data(), text.size());
+            used += text.size();
+            return std::string_view(blocks.back().get(), text.size());
+        }
+        blocks.emplace_back(new char[blockSize]);
+        cursor = blocks.back().get();
+        remaining = blockSize;
+    }
+    std::memcpy(cursor, text.data(), text.size());
+    std::string_view stored(cursor, text.size());
+    cursor += text.size();
+    remaining -= text.size();
+    used += text.size();
+    return stored;
+}
+
+void StringArena::clear() {
+    blocks.clear();
+    cursor = nullptr;
+    remaining = 0;
+    used = 0;
+}
+
+size_t StringArena::bytesUsed() const {
+    return used;
+}
+
+// ============ TaskStore Implementation ============
+
+size_t TaskStore::append(int id, std::string_view title, std::string_view description,
+                         TaskPriority priority, TaskStatus status, long long created) {
+    ids.push_back(id);
+    priorities.push_back(static_cast<uint8_t>(priority));
+    statuses.push_back(static_cast<uint8_t>(status));
+    createdAt.push_back(created);
+    completedAt.push_back(0);
+    titles.push_back(arena.store(title));
+    descriptions.push_back(arena.store(description));
+    liveStringBytes += title.size() + description.size();
+    return ids.size() - 1;
+}
+
+// Borrowed strings count as live but not as arena bytes, so they only make
+// compaction (which copies them in) less eager
+size_t TaskStore::appendBorrowed(int id, std::string_view title, std::string_view description,
+                                 TaskPriority priority, TaskStatus status,
+                                 long long created, long long completed) {
+    ids.push_back(id);
+    priorities.push_back(static_cast<uint8_t>(priority));
+    statuses.push_back(static_cast<uint8_t>(status));
+    createdAt.push_back(created);
+    completedAt.push_back(completed);
+    titles.push_back(title);
+    descriptions.push_back(description);
+    liveStringBytes += title.size() + description.size();
+    return ids.size() - 1;
+}
+
+// Never less than doubling, so a stream of small batches still grows the
+// columns geometrically
+void TaskStore::reserve(size_t rows) {
+    size_t total = ids.size() + rows;
+    if (total <= ids.capacity()) return;
+    total = std::max(total, ids.capacity() * 2);
+    ids.reserve(total);
+    priorities.reserve(total);
+    statuses.reserve(total);
+    createdAt.reserve(total);
+    completedAt.reserve(total);
+    titles.reserve(total);
+    descriptions.reserve(total);
+}
+
+void TaskStore::setStatus(size_t row, TaskStatus status) {
+    statuses[row] = static_cast<uint8_t>(status);
+}
+
+void TaskStore::setPriority(size_t row, TaskPriority priority) {
+    priorities[row] = static_cast<uint8_t>(priority);
+}
+
+void TaskStore::setCompletedAt(size_t row, long long timestamp) {
+    completedAt[row] = timestamp;
+}
+
+void TaskStore::remove(size_t row) {
+    liveStringBytes -= titles[row].size() + descriptions[row].size();
+    statuses[row] = kRemovedMarker;
+    priorities[row] = kRemovedMarker;
+    titles[row] = std::string_view();
+    descriptions[row] = std::string_view();
+    if (liveStringBytes * 2 < arena.bytesUsed() && arena.bytesUsed() > 1024 * 1024) {
+        compactStrings();
+    }
+}
+
+void TaskStore::eraseFront(size_t count) {
+    auto drop = [count](auto& column) {
+        column.erase(column.begin(), column.begin() + count);
+    };
+    drop(ids);
+    drop(priorities);
+    drop(statuses);
+    drop(createdAt);
+    drop(completedAt);
+    drop(titles);
+    drop(descriptions);
+}
+
+void TaskStore::clear() {
+    ids.clear();
+    priorities.clear();
+    statuses.clear();
+    createdAt.clear();
+    completedAt.clear();
+    titles.clear();
+    descriptions.clear();
+    arena.clear();
+    liveStringBytes = 0;
+}
+
+TaskView TaskStore::view(size_t row) const {
+    return TaskView{ids[row],
+                    static_cast<TaskPriority>(priorities[row]),
+                    static_cast<TaskStatus>(statuses[row]),
+                    createdAt[row],
+                    completedAt[row],
+                    titles[row],
+                    descriptions[row]};
+}
+
+void TaskStore::compactStrings() {
+    StringArena fresh;
+    for (size_t row = 0; row < ids.size(); row++) {
+        titles[row] = fresh.store(titles[row]);
+        descriptions[row] = fresh.store(descriptions[row]);
+    }
+    arena = std::move(fresh);
+}
@@ -0,0 +1,101 @@
+#ifndef TASK_STORE_H
+#define TASK_STORE_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+enum class TaskPriority;
+enum class TaskStatus;
+
+// Append-only storage for task strings. Text is copied into large blocks
+// that never move, so the returned views stay valid until clear().
+class StringArena {
+public:
+    explicit StringArena(size_t blockSize = 64 * 1024);
+
+    std::string_view store(std::string_view text);
+    void clear();
+    size_t bytesUsed() const;
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockSize;
+    char* cursor;
+    size_t remaining;
+    size_t used;
+};
+
+// Stable reference to a task: valid for as long as the task exists
+struct TaskHandle {
+    int id;
+};
+
+// Read-only snapshot of one task row. The strings point into the store's
+// arena or at memory the row borrows, and stay valid until the next removal
+// (which may compact the arena) or clear.
+struct TaskView {
+    int id;
+    TaskPriority priority;
+    TaskStatus status;
+    long long createdAt;
+    long long completedAt;
+    std::string_view title;
+    std::string_view description;
+};
+
+// Structure-of-arrays task storage. Each field lives in its own contiguous
+// column and titles/descriptions are packed into a StringArena, so scans
+// over status or priority touch one byte per task. Rows are appended in id
+// order; removal leaves a tombstone (kRemovedMarker in the status and
+// priority columns) until eraseFront() drops a leading run.
+class TaskStore {
+public:
+    static constexpr uint8_t kRemovedMarker = 0xFF;
+
+    size_t append(int id, std::string_view title, std::string_view description,
+                  TaskPriority priority, TaskStatus status, long long createdAt);
+    // Like append, but keeps the strings where they are instead of copying
+    // them into the arena; the caller keeps that memory alive
+    size_t appendBorrowed(int id, std::string_view title, std::string_view description,
+                          TaskPriority priority, TaskStatus status,
+                          long long createdAt, long long completedAt);
+    // Makes room for `rows` more appends
+    void reserve(size_t rows);
+    void setStatus(size_t row, TaskStatus status);
+    void setPriority(size_t row, TaskPriority priority);
+    void setCompletedAt(size_t row, long long timestamp);
+    void remove(size_t row);
+    void eraseFront(size_t count);
+    void clear();
+
+    size_t rowCount() const { return ids.size(); }
+    bool isLive(size_t row) const { return statuses[row] != kRemovedMarker; }
+    TaskView view(size_t row) const;
+
+    // Raw columns, one entry per row (tombstones included)
+    const int* idColumn() const { return ids.data(); }
+    const uint8_t* statusColumn() const { return statuses.data(); }
+    const uint8_t* priorityColumn() const { return priorities.data(); }
+    const long long* createdAtColumn() const { return createdAt.data(); }
+    const long long* completedAtColumn() const { return completedAt.data(); }
+
+    // Rewrites live strings into a fresh arena; remove() calls it once dead
+    // strings outweigh live ones. Invalidates outstanding views.
+    void compactStrings();
+    size_t stringBytes() const { return arena.bytesUsed(); }
+
+private:
+    std::vector<int> ids;
+    std::vector<uint8_t> priorities;
+    std::vector<uint8_t> statuses;
+    std::vector<long long> createdAt;
+    std::vector<long long> completedAt;
+    std::vector<std::string_view> titles;
+    std::vector<std::string_view> descriptions;
+    StringArena arena;
+    size_t liveStringBytes = 0;
+};
+
+#endif // TASK_STORE_H
@@ -0,0 +1,509 @@
+#include "task_wal.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define WAL_OPEN_FLAGS (O_RDWR | O_CREAT | O_APPEND | O_BINARY)
+#define ftruncate _chsize
+#define fsync _commit
+#else
+#include <unistd.h>
+#define WAL_OPEN_FLAGS (O_RDWR | O_CREAT | O_APPEND)
+#endif
+
+namespace {
+
+constexpr char kWalMagic[8] = {'T', 'P', 'W', 'A', 'L', 0, 0, 1};
+constexpr size_t kWalHeader = 24;    // magic + generation + base snapshot
+constexpr size_t kFrameHeader = 9;   // length + crc + type
+
+std::string makeHeader(uint64_t generation, uint64_t baseSnapshot) {
+    std::string header(kWalMagic, sizeof(kWalMagic));
+    header.append(reinterpret_cast<const char*>(&generation), sizeof(generation));
+    header.append(reinterpret_cast<const char*>(&baseSnapshot), sizeof(baseSnapshot));
+    return header;
+}
+
+bool readAt(int fd, size_t offset, char* data, size_t length) {
+    if (::lseek(fd, static_cast<off_t>(offset), SEEK_SET) < 0) return false;
+    while (length > 0) {
+        auto got = ::read(fd, data, length);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        data += got;
+        length -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+// Data only, where the platform allows it
+int syncData(int fd) {
+#if defined(__linux__)
+    return fdatasync(fd);
+#else
+    return fsync(fd);
+#endif
+}
+
+bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        auto written = ::write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool get(const char*& cursor, const char* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(value)) return false;
+    std::memcpy(&value, cursor, sizeof(value));
+    cursor += sizeof(value);
+    return true;
+}
+
+bool getString(const char*& cursor, const char* end, std::string_view& text) {
+    uint32_t length;
+    if (!get(cursor, end, length) || static_cast<size_t>(end - cursor) < length) return false;
+    text = std::string_view(cursor, length);
+    cursor += length;
+    return true;
+}
+
+void encode(std::string& out, const WalRecord& record) {
+    size_t start = out.size();
+    out.append(kFrameHeader - 1, '\0');
+    put(out, static_cast<uint8_t>(record.type));
+    switch (record.type) {
+        case WalRecordType::ADD:
+            put<int32_t>(out, record.id);
+            put<uint8_t>(out, record.value);
+            put<int64_t>(out, record.timestamp);
+            put<uint32_t>(out, static_cast<uint32_t>(record.title.size()));
+            out.append(record.title);
+            put<uint32_t>(out, static_cast<uint32_t>(record.description.size()));
+            out.append(record.description);
+            break;
+        case WalRecordType::REMOVE:
+            put<int32_t>(out, record.id);
+            break;
+        case WalRecordType::STATUS:
+        case WalRecordType::OUTCOME:
+            put<int32_t>(out, record.id);
+            put<uint8_t>(out, record.value);
+            put<int64_t>(out, record.timestamp);
+            break;
+        case WalRecordType::PRIORITY:
+            put<int32_t>(out, record.id);
+            put<uint8_t>(out, record.value);
+            break;
+        case WalRecordType::CLEAR:
+        case WalRecordType::CLEAR_COMPLETED:
+            break;
+        case WalRecordType::COUNTERS:
+            put<int32_t>(out, record.id);
+            put<int64_t>(out, record.processed);
+            put<int64_t>(out, record.failed);
+            break;
+    }
+    // Length covers the payload after the type byte; the crc covers type + payload
+    uint32_t length = static_cast<uint32_t>(out.size() - start - kFrameHeader);
+    uint32_t crc = checksum32(out.data() + start + 8, length + 1);
+    std::memcpy(&out[start], &length, sizeof(length));
+    std::memcpy(&out[start + 4], &crc, sizeof(crc));
+}
+
+bool decode(uint8_t type, const char* cursor, const char* end, WalRecord& record) {
+    record = WalRecord{static_cast<WalRecordType>(type)};
+    int32_t id = 0;
+    int64_t timestamp = 0;
+    switch (record.type) {
+        case WalRecordType::ADD:
+            if (!get(cursor, end, id) || !get(cursor, end, record.value) ||
+                !get(cursor, end, timestamp) || !getString(cursor, end, record.title) ||
+                !getString(cursor, end, record.description)) {
+                return false;
+            }
+            break;
+        case WalRecordType::REMOVE:
+            if (!get(cursor, end, id)) return false;
+            break;
+        case WalRecordType::STATUS:
+        case WalRecordType::OUTCOME:
+            if (!get(cursor, end, id) || !get(cursor, end, record.value) ||
+                !get(cursor, end, timestamp)) {
+                return false;
+            }
+            break;
+        case WalRecordType::PRIORITY:
+            if (!get(cursor, end, id) || !get(cursor, end, record.value)) return false;
+            break;
+        case WalRecordType::CLEAR:
+        case WalRecordType::CLEAR_COMPLETED:
+            break;
+        case WalRecordType::COUNTERS: {
+            int64_t processed, failed;
+            if (!get(cursor, end, id) || !get(cursor, end, processed) ||
+                !get(cursor, end, failed)) {
+                return false;
+            }
+            record.processed = processed;
+            record.failed = failed;
+            break;
+        }
+        default:
+            return false;
+    }
+    record.id = id;
+    record.timestamp = timestamp;
+    return cursor == end;
+}
+
+} // namespace
+
+// ============ Checksum ============
+
+uint32_t checksum32(const void* data, size_t length, uint32_t crc) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value >> 1) ^ (value & 1 ? 0xEDB88320u : 0);
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ============ File Helpers ============
+
+bool writeFileAtomically(const std::string& path, const std::string& contents) {
+    std::string tmpPath = path + ".tmp";
+    int tmp = ::open(tmpPath.c_str(), WAL_OPEN_FLAGS | O_TRUNC, 0644);
+    if (tmp < 0) {
+        return false;
+    }
+    bool written = writeAll(tmp, contents.data(), contents.size()) && fsync(tmp) == 0;
+    ::close(tmp);
+#ifdef _WIN32
+    if (written) std::remove(path.c_str());
+#endif
+    if (!written || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+#ifndef _WIN32
+    // Make the rename itself durable
+    std::string dir = path.find('/') == std::string::npos ? "." : path.substr(0, path.rfind('/') + 1);
+    int dirFd = ::open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+#endif
+    return true;
+}
+
+uint64_t newGenerationId() {
+    static std::mutex lock;
+    static std::mt19937_64 engine(std::random_device{}() ^
+        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::lock_guard<std::mutex> guard(lock);
+    uint64_t id;
+    do {
+        id = engine();
+    } while (id == 0);
+    return id;
+}
+
+// ============ WriteAheadLog Implementation ============
+
+std::unique_ptr<WriteAheadLog> WriteAheadLog::open(const std::string& path,
+                                                   const WalOptions& options) {
+    int fd = ::open(path.c_str(), WAL_OPEN_FLAGS, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    uint64_t generation = 0, baseSnapshot = 0;
+    if (size == 0) {
+        generation = newGenerationId();
+        std::string header = makeHeader(generation, 0);
+        if (!writeAll(fd, header.data(), header.size()) || fsync(fd) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        size = header.size();
+    } else {
+        char header[kWalHeader];
+        if (size < kWalHeader || !readAt(fd, 0, header, sizeof(header)) ||
+            std::memcmp(header, kWalMagic, sizeof(kWalMagic)) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        std::memcpy(&generation, header + 8, sizeof(generation));
+        std::memcpy(&baseSnapshot, header + 16, sizeof(baseSnapshot));
+    }
+    return std::unique_ptr<WriteAheadLog>(
+        new WriteAheadLog(path, options, fd, size, generation, baseSnapshot));
+}
+
+WriteAheadLog::WriteAheadLog(const std::string& path, const WalOptions& options, int fd, size_t size,
+                             uint64_t generation, uint64_t baseSnapshot)
+    : path(path), options(options), fd(fd), appendedSeq(0), durableSeq(0),
+      writeError(0), fileBytes(size), flushingBytes(0), generation(generation),
+      baseSnapshot(baseSnapshot), syncRequested(false), stopping(false) {
+    flusher = std::thread(&WriteAheadLog::flusherLoop, this);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    flushWake.notify_one();
+    flusher.join();
+    ::close(fd);
+}
+
+bool WriteAheadLog::replay(const std::function<void(const WalRecord&)>& apply, size_t from,
+                           size_t* applied) {
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    std::string contents(fileBytes, '\0');
+    size_t loaded = 0;
+    ::lseek(fd, 0, SEEK_SET);
+    while (loaded < contents.size()) {
+        auto got = ::read(fd, &contents[loaded], contents.size() - loaded);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        loaded += static_cast<size_t>(got);
+    }
+    contents.resize(loaded);
+
+    size_t offset = std::min(std::max(from, kWalHeader), contents.size());
+    size_t count = 0;
+    bool readable = true;
+    while (contents.size() - offset >= kFrameHeader) {
+        uint32_t length, crc;
+        std::memcpy(&length, &contents[offset], sizeof(length));
+        std::memcpy(&crc, &contents[offset + 4], sizeof(crc));
+        if (contents.size() - offset - kFrameHeader < length ||
+            checksum32(&contents[offset + 8], length + 1) != crc) {
+            break;
+        }
+        WalRecord record{WalRecordType::CLEAR};
+        const char* payload = &contents[offset + kFrameHeader];
+        if (!decode(static_cast<uint8_t>(contents[offset + 8]), payload, payload + length, record)) {
+            readable = false;
+            break;
+        }
+        apply(record);
+        count++;
+        offset += kFrameHeader + length;
+    }
+    if (applied) *applied = count;
+    if (!readable) return false;
+
+    if (offset < fileBytes) {
+        // Drop the torn tail so new records follow the last good one
+        if (ftruncate(fd, static_cast<off_t>(offset)) == 0 && fsync(fd) == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            fileBytes = offset;
+        }
+    }
+    return true;
+}
+
+uint64_t WriteAheadLog::append(const WalRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool wasEmpty = pending.empty();
+    encode(pending, record);
+    if (wasEmpty) {
+        flushWake.notify_one();
+    }
+    return ++appendedSeq;
+}
+
+bool WriteAheadLog::waitDurable(uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (durableSeq >= sequence) return true;
+    if (writeError) return false;
+    syncRequested = true;
+    flushWake.notify_one();
+    durable.wait(lock, [this, sequence] { return durableSeq >= sequence || writeError; });
+    return durableSeq >= sequence;
+}
+
+bool WriteAheadLog::sync() {
+    uint64_t target;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        target = appendedSeq;
+    }
+    return waitDurable(target);
+}
+
+int WriteAheadLog::getError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writeError;
+}
+
+// Sleeps until a record arrives, then holds the batch open for the commit
+// window (cut short by sync/waitDurable or shutdown) before one write+fsync.
+void WriteAheadLog::flusherLoop() {
+    std::string batch;
+    while (true) {
+        std::unique_lock<std::mutex> fileLock(fileMutex, std::defer_lock);
+        uint64_t target;
+        int failed;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            flushWake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            flushWake.wait_for(lock, options.commitLatency,
+                               [this] { return stopping || syncRequested; });
+            lock.unlock();
+            // Take the file first so a concurrent rewrite cannot slip in
+            // between collecting the batch and writing it
+            fileLock.lock();
+            lock.lock();
+            batch.swap(pending);
+            pending.clear();
+            flushingBytes = batch.size();
+            target = appendedSeq;
+            syncRequested = false;
+            failed = writeError;
+        }
+
+        // After a failure a partial frame may sit at the end of the file and
+        // would hide anything written behind it from replay, so later
+        // batches are dropped until rewrite() starts a fresh file
+        size_t written = 0;
+        if (!batch.empty() && !failed) {
+            if (!writeAll(fd, batch.data(), batch.size())) {
+                failed = errno ? errno : EIO;
+            } else {
+                written = batch.size();
+                if (syncData(fd) != 0) {
+                    failed = errno ? errno : EIO;
+                }
+            }
+        }
+        batch.clear();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        fileBytes += written;
+        flushingBytes = 0;
+        if (failed) {
+            if (!writeError) writeError = failed;
+        } else if (durableSeq < target) {
+            durableSeq = target;
+        }
+        durable.notify_all();
+    }
+}
+
+bool WriteAheadLog::rewrite(
+        const std::function<void(const std::function<void(const WalRecord&)>&)>& image) {
+    uint64_t nextGeneration = newGenerationId();
+    std::string contents = makeHeader(nextGeneration, 0);
+    image([&contents](const WalRecord& record) { encode(contents, record); });
+
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    if (!replaceFile(contents, nextGeneration, 0)) {
+        return false;
+    }
+    // The image covers every record appended so far, including any a
+    // failed write lost, so the log is healthy again
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.clear();
+    durableSeq = appendedSeq;
+    writeError = 0;
+    durable.notify_all();
+    return true;
+}
+
+bool WriteAheadLog::discardPrefix(uint64_t expected, size_t offset, uint64_t snapshotId) {
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    if (generation != expected || offset < kWalHeader || offset > fileBytes) {
+        return false;
+    }
+    uint64_t nextGeneration = newGenerationId();
+    std::string contents = makeHeader(nextGeneration, snapshotId);
+    contents.resize(kWalHeader + fileBytes - offset);
+    if (!readAt(fd, offset, &contents[kWalHeader], fileBytes - offset)) {
+        return false;
+    }
+    return replaceFile(contents, nextGeneration, snapshotId);
+}
+
+// Swaps in a new file image. Called with fileMutex held.
+bool WriteAheadLog::replaceFile(const std::string& contents, uint64_t nextGeneration,
+                                uint64_t nextBase) {
+    if (!writeFileAtomically(path, contents)) {
+        return false;
+    }
+    int reopened = ::open(path.c_str(), WAL_OPEN_FLAGS, 0644);
+    if (reopened < 0) {
+        return false;
+    }
+    ::close(fd);
+    fd = reopened;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    fileBytes = contents.size();
+    generation = nextGeneration;
+    baseSnapshot = nextBase;
+    return true;
+}
+
+uint64_t WriteAheadLog::getGeneration() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return generation;
+}
+
+uint64_t WriteAheadLog::getBaseSnapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return baseSnapshot;
+}
+
+bool WriteAheadLog::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return fileBytes == kWalHeader && flushingBytes == 0 && pending.empty();
+}
+
+size_t WriteAheadLog::sizeBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return fileBytes + flushingBytes + pending.size();
+}
@@ -0,0 +1,148 @@
+#ifndef TASK_WAL_H
+#define TASK_WAL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// CRC-32 (IEEE); pass the previous result as `crc` to checksum in pieces
+uint32_t checksum32(const void* data, size_t length, uint32_t crc = 0);
+
+// Replaces `path` with `contents` via a fsynced temporary file and rename,
+// so readers see either the old or the new file, never a mix
+bool writeFileAtomically(const std::string& path, const std::string& contents);
+
+// Random non-zero id for log generations and snapshots
+uint64_t newGenerationId();
+
+enum class WalRecordType : uint8_t {
+    ADD = 1,             // id, value = priority, timestamp = createdAt, title, description
+    REMOVE = 2,          // id
+    STATUS = 3,          // id, value = status, timestamp = completedAt
+    PRIORITY = 4,        // id, value = priority
+    OUTCOME = 5,         // id, value = 1 on success, timestamp = finishedAt
+    CLEAR = 6,
+    CLEAR_COMPLETED = 7,
+    COUNTERS = 8         // id = nextId, processed, failed
+};
+
+// One decoded log entry. Fields a type does not use are zero; the strings
+// point into the replay buffer and are only valid during the callback.
+struct WalRecord {
+    WalRecordType type;
+    int id = 0;
+    uint8_t value = 0;
+    long long timestamp = 0;
+    long long processed = 0;
+    long long failed = 0;
+    std::string_view title{};
+    std::string_view description{};
+};
+
+struct WalOptions {
+    // Group commit window: appended records are written and fsynced together
+    // at most this long after the first of them
+    std::chrono::microseconds commitLatency{2000};
+    // Block each TaskProcessor mutation until its record is durable
+    bool waitForCommit = false;
+    // The processor rewrites the log as a compact image of its state once the
+    // log passes this size (and has doubled since the last rewrite)
+    size_t truncateBytes = 64 * 1024 * 1024;
+};
+
+// Append-only binary log of TaskProcessor mutations. Each record is framed
+// as [u32 payload length][u32 crc][u8 type][payload]; appends are buffered
+// and a background thread writes and fsyncs them in batches.
+//
+// The file header names the log's generation, which changes whenever the
+// file is rewritten, and the snapshot it continues from (0 when the log
+// alone holds the full history).
+class WriteAheadLog {
+public:
+    // Opens or creates the log; returns nullptr if the file cannot be used
+    static std::unique_ptr<WriteAheadLog> open(const std::string& path,
+                                               const WalOptions& options = WalOptions());
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Feeds every intact record to `apply` in order and counts them in
+    // `applied`. A torn tail (a frame whose length or checksum fails, left by
+    // a crash mid-write) ends the replay and is cut off the file. A frame
+    // that passes its checksum but cannot be decoded was written by a newer
+    // or broken writer: the replay stops there, the file is left untouched
+    // and false is returned.
+    // `from` is a file offset previously taken from sizeBytes() (0 = start).
+    bool replay(const std::function<void(const WalRecord&)>& apply, size_t from = 0,
+                size_t* applied = nullptr);
+
+    // Buffers a record and returns its sequence number. Thread-safe.
+    uint64_t append(const WalRecord& record);
+    // Blocks until `sequence` is on disk. Returns false if a write or fsync
+    // failed first. The failure is sticky: no later record is reported
+    // durable until rewrite() replaces the file.
+    bool waitDurable(uint64_t sequence);
+    // Writes and fsyncs everything appended so far; false as waitDurable
+    bool sync();
+    // errno of the write or fsync that failed, 0 while the log is healthy
+    int getError() const;
+
+    // Atomically replaces the log with the records `image` emits (a compact
+    // image of current state). Pending appends are dropped: the image
+    // supersedes them.
+    bool rewrite(const std::function<void(const std::function<void(const WalRecord&)>&)>& image);
+
+    // Once the snapshot `snapshotId` covers everything before `offset` of
+    // generation `expected`, drops that prefix and marks the log as
+    // continuing the snapshot. Records appended since are kept. Does nothing
+    // (returns false) if the log has been rewritten since.
+    bool discardPrefix(uint64_t expected, size_t offset, uint64_t snapshotId);
+
+    uint64_t getGeneration() const;
+    uint64_t getBaseSnapshot() const;
+    // True if the log holds no records
+    bool empty() const;
+
+    size_t sizeBytes() const;
+    const WalOptions& getOptions() const { return options; }
+    const std::string& getPath() const { return path; }
+
+private:
+    WriteAheadLog(const std::string& path, const WalOptions& options, int fd, size_t size,
+                  uint64_t generation, uint64_t baseSnapshot);
+    void flusherLoop();
+    bool replaceFile(const std::string& contents, uint64_t generation, uint64_t baseSnapshot);
+
+    std::string path;
+    WalOptions options;
+    int fd;
+
+    // fileMutex serializes file writes (flusher batches and rewrites); mutex
+    // guards the buffer and sequence numbers. fileBytes is only changed with
+    // both held, so either one is enough to read it. Lock order: fileMutex,
+    // mutex.
+    std::mutex fileMutex;
+    mutable std::mutex mutex;
+    std::condition_variable flushWake;
+    std::condition_variable durable;
+    std::string pending;
+    uint64_t appendedSeq;
+    uint64_t durableSeq;
+    int writeError;
+    size_t fileBytes;
+    size_t flushingBytes;   // taken from pending, not yet counted in fileBytes
+    uint64_t generation;
+    uint64_t baseSnapshot;
+    bool syncRequested;
+    bool stopping;
+    std::thread flusher;
+};
+
+#endif // TASK_WAL_H
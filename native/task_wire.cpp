@@ -0,0 +1,266 @@
+#include "task_wire.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kWireMagic[4] = {'T', 'P', 'W', '1'};
+constexpr size_t kWireLimit = UINT32_MAX;
+// Strings shorter than this are gathered by copying them into a staging
+// buffer; an iovec of their own would cost more than the copy
+constexpr size_t kGatherCopyBelow = 512;
+
+// Fields go through memcpy, so buffers need no particular alignment, and
+// are byte-swapped on big-endian hosts
+template <typename T>
+void storeLE(char* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    std::reverse(out, out + sizeof(T));
+#endif
+}
+
+template <typename T>
+T loadLE(const char* in) {
+    T value;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    char bytes[sizeof(T)];
+    std::reverse_copy(in, in + sizeof(T), bytes);
+    std::memcpy(&value, bytes, sizeof(T));
+#else
+    std::memcpy(&value, in, sizeof(T));
+#endif
+    return value;
+}
+
+size_t prefixBytes(size_t count) {
+    return sizeof(WireHeader) + count * sizeof(WireRecord) + (2 * count + 1) * sizeof(uint32_t);
+}
+
+size_t heapBytes(const TaskStore& store, const std::vector<uint32_t>& rows) {
+    size_t bytes = 0;
+    for (uint32_t row : rows) {
+        TaskView view = store.view(row);
+        bytes += view.title.size() + view.description.size();
+    }
+    return bytes;
+}
+
+// Header, records and offset table; `out` has room for prefixBytes()
+void encodePrefix(const TaskStore& store, const std::vector<uint32_t>& rows,
+                  size_t heap, char* out) {
+    size_t count = rows.size();
+    storeLE(out, static_cast<uint32_t>(prefixBytes(count) + heap));
+    std::memcpy(out + 4, kWireMagic, sizeof(kWireMagic));
+    storeLE(out + 8, static_cast<uint32_t>(count));
+    storeLE(out + 12, static_cast<uint32_t>(heap));
+
+    char* record = out + sizeof(WireHeader);
+    char* offset = record + count * sizeof(WireRecord);
+    uint32_t cursor = 0;
+    for (uint32_t row : rows) {
+        TaskView view = store.view(row);
+        storeLE(record, static_cast<int32_t>(view.id));
+        record[4] = static_cast<char>(store.priorityColumn()[row]);
+        record[5] = static_cast<char>(store.statusColumn()[row]);
+        storeLE(record + 6, static_cast<uint16_t>(0));
+        storeLE(record + 8, static_cast<int64_t>(view.createdAt));
+        storeLE(record + 16, static_cast<int64_t>(view.completedAt));
+        record += sizeof(WireRecord);
+
+        storeLE(offset, cursor);
+        cursor += static_cast<uint32_t>(view.title.size());
+        storeLE(offset + 4, cursor);
+        cursor += static_cast<uint32_t>(view.description.size());
+        offset += 8;
+    }
+    storeLE(offset, cursor);
+}
+
+} // namespace
+
+// ============ Writer ============
+
+size_t wireSize(const TaskStore& store, const std::vector<uint32_t>& rows) {
+    size_t total = prefixBytes(rows.size()) + heapBytes(store, rows);
+    return total > kWireLimit ? 0 : total;
+}
+
+size_t writeWire(const TaskStore& store, const std::vector<uint32_t>& rows,
+                 char* buffer, size_t capacity) {
+    size_t heap = heapBytes(store, rows);
+    size_t prefix = prefixBytes(rows.size());
+    if (prefix + heap > kWireLimit) {
+        return 0;
+    }
+    if (prefix + heap > capacity) {
+        return prefix + heap;
+    }
+
+    encodePrefix(store, rows, heap, buffer);
+    char* out = buffer + prefix;
+    for (uint32_t row : rows) {
+        TaskView view = store.view(row);
+        out = std::copy(view.title.begin(), view.title.end(), out);
+        out = std::copy(view.description.begin(), view.description.end(), out);
+    }
+    return prefix + heap;
+}
+
+bool gatherWire(const TaskStore& store, const std::vector<uint32_t>& rows, WireSegments& out) {
+    size_t heap = heapBytes(store, rows);
+    size_t prefix = prefixBytes(rows.size());
+    out.segments.clear();
+    out.totalBytes = 0;
+    if (prefix + heap > kWireLimit) {
+        return false;
+    }
+
+    out.prefix.resize(prefix);
+    encodePrefix(store, rows, heap, &out.prefix[0]);
+    out.segments.push_back(iovec{&out.prefix[0], prefix});
+
+    // Short strings are copied into `staged`, which is sized up front so it
+    // never moves; consecutive ones (and long strings that happen to sit
+    // back to back) extend the previous segment instead of adding one
+    size_t stagedBytes = 0;
+    for (uint32_t row : rows) {
+        TaskView view = store.view(row);
+        if (view.title.size() < kGatherCopyBelow) stagedBytes += view.title.size();
+        if (view.description.size() < kGatherCopyBelow) stagedBytes += view.description.size();
+    }
+    out.staged.clear();
+    out.staged.reserve(stagedBytes);
+    auto add = [&](std::string_view text) {
+        if (text.empty()) return;
+        const char* data = text.data();
+        if (text.size() < kGatherCopyBelow) {
+            data = out.staged.data() + out.staged.size();
+            out.staged.append(text);
+        }
+        iovec& last = out.segments.back();
+        if (out.segments.size() > 1 &&
+            static_cast<const char*>(last.iov_base) + last.iov_len == data) {
+            last.iov_len += text.size();
+        } else {
+            out.segments.push_back(iovec{const_cast<char*>(data), text.size()});
+        }
+    };
+    for (uint32_t row : rows) {
+        TaskView view = store.view(row);
+        add(view.title);
+        add(view.description);
+    }
+    out.totalBytes = prefix + heap;
+    return true;
+}
+
+bool writeSegments(int fd, const WireSegments& batch) {
+#ifdef _WIN32
+    for (const iovec& segment : batch.segments) {
+        const char* data = static_cast<const char*>(segment.iov_base);
+        size_t left = segment.iov_len;
+        while (left > 0) {
+            int written = _write(fd, data, static_cast<unsigned>(std::min<size_t>(left, INT_MAX)));
+            if (written <= 0) return false;
+            data += written;
+            left -= static_cast<size_t>(written);
+        }
+    }
+    return true;
+#else
+    std::vector<iovec> pending(batch.segments);
+    size_t next = 0;
+    while (next < pending.size()) {
+        int chunk = static_cast<int>(std::min<size_t>(pending.size() - next, IOV_MAX));
+        ssize_t written = ::writev(fd, &pending[next], chunk);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // Skip whole segments, then trim a partially written one
+        size_t left = static_cast<size_t>(written);
+        while (next < pending.size() && left >= pending[next].iov_len) {
+            left -= pending[next].iov_len;
+            next++;
+        }
+        if (left > 0) {
+            pending[next].iov_base = static_cast<char*>(pending[next].iov_base) + left;
+            pending[next].iov_len -= left;
+        }
+    }
+    return true;
+#endif
+}
+
+// ============ Reader ============
+
+bool WireReader::open(const void* data, size_t size) {
+    base = static_cast<const char*>(data);
+    count = 0;
+    total = 0;
+    if (size < sizeof(WireHeader) || std::memcmp(base + 4, kWireMagic, sizeof(kWireMagic)) != 0) {
+        return false;
+    }
+    uint64_t totalBytes = loadLE<uint32_t>(base);
+    uint64_t recordCount = loadLE<uint32_t>(base + 8);
+    uint64_t heapSize = loadLE<uint32_t>(base + 12);
+    uint64_t prefix = sizeof(WireHeader) + recordCount * sizeof(WireRecord) +
+                      (2 * recordCount + 1) * sizeof(uint32_t);
+    if (totalBytes > size || prefix + heapSize != totalBytes) {
+        return false;
+    }
+
+    records = base + sizeof(WireHeader);
+    offsets = records + recordCount * sizeof(WireRecord);
+    heap = base + prefix;
+
+    // Checked once here so record() can trust every offset and enum value
+    uint32_t previous = 0;
+    for (uint64_t k = 0; k <= 2 * recordCount; k++) {
+        uint32_t offset = loadLE<uint32_t>(offsets + k * sizeof(uint32_t));
+        if (offset < previous || offset > heapSize || (k == 0 && offset != 0)) {
+            return false;
+        }
+        previous = offset;
+    }
+    if (previous != heapSize) {
+        return false;
+    }
+    for (uint64_t i = 0; i < recordCount; i++) {
+        const char* record = records + i * sizeof(WireRecord);
+        if (static_cast<uint8_t>(record[4]) >= 4 || static_cast<uint8_t>(record[5]) >= 4) {
+            return false;
+        }
+    }
+
+    count = static_cast<size_t>(recordCount);
+    total = static_cast<size_t>(totalBytes);
+    return true;
+}
+
+TaskView WireReader::record(size_t index) const {
+    const char* record = records + index * sizeof(WireRecord);
+    const char* offset = offsets + 2 * index * sizeof(uint32_t);
+    uint32_t titleStart = loadLE<uint32_t>(offset);
+    uint32_t descriptionStart = loadLE<uint32_t>(offset + 4);
+    uint32_t end = loadLE<uint32_t>(offset + 8);
+
+    TaskView view;
+    view.id = loadLE<int32_t>(record);
+    view.priority = static_cast<TaskPriority>(static_cast<uint8_t>(record[4]));
+    view.status = static_cast<TaskStatus>(static_cast<uint8_t>(record[5]));
+    view.createdAt = loadLE<int64_t>(record + 8);
+    view.completedAt = loadLE<int64_t>(record + 16);
+    view.title = std::string_view(heap + titleStart, descriptionStart - titleStart);
+    view.description = std::string_view(heap + descriptionStart, end - descriptionStart);
+    return view;
+}
@@ -0,0 +1,99 @@
+#ifndef TASK_WIRE_H
+#define TASK_WIRE_H
+
+#include "task_store.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+struct iovec {
+    void* iov_base;
+    size_t iov_len;
+};
+#else
+#include <sys/uio.h>
+#endif
+
+// Binary exchange format for task batches. Little-endian throughout:
+//
+//   WireHeader                        16 bytes
+//   WireRecord[recordCount]           24 bytes each
+//   uint32 offsets[2*recordCount+1]   string k is heap[offsets[k], offsets[k+1]);
+//                                     record i owns strings 2i (title) and
+//                                     2i+1 (description)
+//   heap                              heapBytes of UTF-8, no terminators
+//
+// totalBytes comes first, so a stream reader can frame a batch from its
+// first four bytes.
+struct WireHeader {
+    uint32_t totalBytes;
+    char magic[4];              // "TPW1"
+    uint32_t recordCount;
+    uint32_t heapBytes;
+};
+
+struct WireRecord {
+    int32_t id;
+    uint8_t priority;
+    uint8_t status;
+    uint16_t reserved;
+    int64_t createdAt;
+    int64_t completedAt;
+};
+
+static_assert(sizeof(WireHeader) == 16, "wire header layout changed");
+static_assert(sizeof(WireRecord) == 24, "wire record layout changed");
+
+// Encoded size of `rows` (live rows of `store`); 0 if the batch would not
+// fit the format's 4 GiB limit
+size_t wireSize(const TaskStore& store, const std::vector<uint32_t>& rows);
+
+// Encodes `rows` into `buffer`. Returns the size of the batch and writes
+// it only if that fits in `capacity`, so callers can size a buffer with a
+// first call. Returns 0 if the batch exceeds the format's limit.
+size_t writeWire(const TaskStore& store, const std::vector<uint32_t>& rows,
+                 char* buffer, size_t capacity);
+
+// A batch as a gather list: `prefix` holds the header, records and offset
+// table, and `segments` covers prefix followed by the strings. Short strings
+// are copied into `staged` so a batch of small tasks needs few segments;
+// long ones are referenced where they live in the store, so the segments
+// are only valid until the store next changes. Segments point into
+// `prefix` and `staged`: copying the struct leaves the copy's segments
+// aimed at the original.
+struct WireSegments {
+    std::string prefix;
+    std::string staged;
+    std::vector<iovec> segments;
+    size_t totalBytes = 0;
+};
+
+// Returns false if the batch exceeds the format's limit
+bool gatherWire(const TaskStore& store, const std::vector<uint32_t>& rows, WireSegments& out);
+
+// Writes every segment to `fd` with writev, resuming after partial writes
+bool writeSegments(int fd, const WireSegments& batch);
+
+// Zero-copy decoder. open() checks the header, bounds and offset table
+// once; records() then hands out TaskViews whose strings point into the
+// caller's buffer, which must outlive the reader.
+class WireReader {
+public:
+    // False if `data` does not start with a well-formed batch
+    bool open(const void* data, size_t size);
+
+    size_t size() const { return count; }
+    size_t bytes() const { return total; }
+    TaskView record(size_t index) const;
+
+private:
+    const char* base = nullptr;
+    const char* records = nullptr;
+    const char* offsets = nullptr;
+    const char* heap = nullptr;
+    size_t count = 0;
+    size_t total = 0;
+};
+
+#endif // TASK_WIRE_H
@@ -0,0 +1,1649 @@
+#include "task_processor.h"
+#include "task_api.h"
+#include "concurrent_task_processor.h"
+#include "task_ingest.h"
+#include <iostream>
+#include <cassert>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+#include <csignal>
+#include <cerrno>
+#include <system_error>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+void test_lookup_and_removal() {
+    std::cout << "\n=== Testing Task Lookup and Removal ===\n";
+
+    TaskProcessor processor;
+    for (int i = 0; i < 10; i++) {
+        processor.addTask("Task " + std::to_string(i), "", TaskPriority::MEDIUM);
+    }
+    assert(processor.getTotalCount() == 10);
+    assert(processor.getTask(1)->title == "Task 0");
+    assert(processor.getTask(10)->title == "Task 9");
+    assert(processor.getTask(0) == nullptr);
+    assert(processor.getTask(11) == nullptr);
+
+    // Removing from the middle leaves a tombstone; order is preserved
+    assert(processor.removeTask(5));
+    assert(!processor.removeTask(5));
+    assert(processor.getTask(5) == nullptr);
+    assert(processor.getTask(6)->id == 6);
+
+    auto all = processor.getAllTasks();
+    assert(all.size() == 9);
+    for (size_t i = 1; i < all.size(); i++) {
+        assert(all[i - 1]->id < all[i]->id);
+    }
+
+    // Removing the head repeatedly trims the slot table
+    for (int id = 1; id <= 4; id++) {
+        assert(processor.removeTask(id));
+    }
+    for (int id = 6; id <= 10; id++) {
+        assert(processor.getTask(id) != nullptr);
+    }
+    assert(processor.getTotalCount() == 5);
+
+    // Ids keep increasing after the table has been trimmed or cleared
+    int id = processor.addTask("After trim");
+    assert(id == 11);
+    assert(processor.getTask(11)->title == "After trim");
+
+    processor.clearTasks();
+    assert(processor.getTotalCount() == 0);
+    assert(processor.getTask(11) == nullptr);
+    id = processor.addTask("After clear");
+    assert(id == 12);
+    assert(processor.getTask(12) != nullptr);
+
+    std::cout << "✓ All lookup tests passed!\n";
+}
+
+void test_status_and_priority_updates() {
+    std::cout << "\n=== Testing Status and Priority Updates ===\n";
+
+    TaskProcessor processor;
+    int low = processor.addTask("Low", "", TaskPriority::LOW);
+    int high = processor.addTask("High", "", TaskPriority::HIGH);
+
+    assert(processor.updateTaskPriority(low, TaskPriority::CRITICAL));
+    assert(processor.getTask(low)->priority == TaskPriority::CRITICAL);
+    assert(!processor.updateTaskPriority(99, TaskPriority::LOW));
+
+    assert(processor.updateTaskStatus(high, TaskStatus::FAILED));
+    assert(processor.getTask(high)->completedAt != 0);
+    assert(!processor.updateTaskStatus(99, TaskStatus::FAILED));
+
+    processor.processTask(low);
+    assert(processor.getTask(low)->status == TaskStatus::COMPLETED);
+    assert(processor.getProcessedCount() == 1);
+
+    processor.clearCompleted();
+    assert(processor.getTask(low) == nullptr);
+    assert(processor.getTask(high) != nullptr);
+    assert(processor.getTotalCount() == 1);
+
+    std::cout << "✓ All update tests passed!\n";
+}
+
+void test_process_all() {
+    std::cout << "\n=== Testing Batch Processing ===\n";
+
+    TaskProcessor processor;
+    processor.addTask("A", "", TaskPriority::LOW);
+    processor.addTask("B", "", TaskPriority::CRITICAL);
+    processor.addTask("C", "", TaskPriority::MEDIUM);
+    processor.addTask("D", "", TaskPriority::HIGH);
+
+    processor.processAll();
+    assert(processor.getProcessedCount() == 4);
+    assert(processor.getPendingCount() == 0);
+    assert(processor.getTasksByStatus(TaskStatus::COMPLETED).size() == 4);
+
+    std::cout << "✓ All batch processing tests passed!\n";
+}
+
+void test_statistics() {
+    std::cout << "\n=== Testing Statistics Counters ===\n";
+
+    TaskProcessor processor;
+    int a = processor.addTask("A", "", TaskPriority::LOW);
+    int b = processor.addTask("B", "", TaskPriority::LOW);
+    int c = processor.addTask("C", "", TaskPriority::HIGH);
+
+    auto priorities = processor.getPriorityStats();
+    assert(priorities.size() == 2);
+    assert(priorities[TaskPriority::LOW] == 2);
+    assert(priorities[TaskPriority::HIGH] == 1);
+    assert(processor.getPendingCount() == 3);
+
+    processor.updateTaskPriority(b, TaskPriority::HIGH);
+    processor.updateTaskStatus(a, TaskStatus::IN_PROGRESS);
+    processor.processTask(c);
+    priorities = processor.getPriorityStats();
+    assert(priorities[TaskPriority::LOW] == 1);
+    assert(priorities[TaskPriority::HIGH] == 2);
+
+    auto statuses = processor.getStatusStats();
+    assert(statuses[TaskStatus::PENDING] == 1);
+    assert(statuses[TaskStatus::IN_PROGRESS] == 1);
+    assert(statuses[TaskStatus::COMPLETED] == 1);
+    assert(processor.getPendingCount() == 1);
+
+    processor.removeTask(a);
+    processor.clearCompleted();
+    statuses = processor.getStatusStats();
+    assert(statuses.size() == 1);
+    assert(statuses[TaskStatus::PENDING] == 1);
+
+    processor.clearTasks();
+    assert(processor.getPriorityStats().empty());
+    assert(processor.getStatusStats().empty());
+    assert(processor.getPendingCount() == 0);
+
+    std::cout << "✓ All statistics tests passed!\n";
+}
+
+void test_ready_queue() {
+    std::cout << "\n=== Testing Ready Queue ===\n";
+
+    TaskProcessor processor;
+    int low = processor.addTask("Low", "", TaskPriority::LOW);
+    int high1 = processor.addTask("High 1", "", TaskPriority::HIGH);
+    int high2 = processor.addTask("High 2", "", TaskPriority::HIGH);
+    int removed = processor.addTask("Removed", "", TaskPriority::HIGH);
+    int blocked = processor.addTask("Blocked", "", TaskPriority::HIGH);
+
+    // Removed and non-pending tasks leave the queue
+    processor.removeTask(removed);
+    processor.updateTaskStatus(blocked, TaskStatus::IN_PROGRESS);
+
+    processor.processByPriority(TaskPriority::HIGH);
+    assert(processor.getTask(high1)->status == TaskStatus::COMPLETED);
+    assert(processor.getTask(high2)->status == TaskStatus::COMPLETED);
+    assert(processor.getTask(blocked)->status == TaskStatus::IN_PROGRESS);
+    assert(processor.getTask(low)->status == TaskStatus::PENDING);
+    assert(processor.getProcessedCount() == 2);
+
+    // A priority change moves a pending task to the other queue
+    processor.updateTaskPriority(low, TaskPriority::CRITICAL);
+    processor.processByPriority(TaskPriority::LOW);
+    assert(processor.getTask(low)->status == TaskStatus::PENDING);
+    processor.processByPriority(TaskPriority::CRITICAL);
+    assert(processor.getTask(low)->status == TaskStatus::COMPLETED);
+
+    // Returning a task to PENDING queues it again
+    processor.updateTaskStatus(blocked, TaskStatus::PENDING);
+    processor.processAll();
+    assert(processor.getTask(blocked)->status == TaskStatus::COMPLETED);
+    assert(processor.getProcessedCount() == 4);
+
+    std::cout << "✓ All ready queue tests passed!\n";
+}
+
+void test_worker_pool() {
+    std::cout << "\n=== Testing Worker Pool ===\n";
+
+    // A single worker starts tasks strictly CRITICAL -> HIGH -> MEDIUM -> LOW
+    TaskProcessor ordered;
+    std::vector<TaskPriority> started;
+    ordered.setWorkFunction([&started](const Task& task) {
+        started.push_back(task.priority);
+        return true;
+    });
+    ordered.setWorkerCount(1);
+    for (int i = 0; i < 20; i++) {
+        ordered.addTask("Task", "", static_cast<TaskPriority>(i % 4));
+    }
+    ordered.processAll();
+    assert(started.size() == 20);
+    for (size_t i = 1; i < started.size(); i++) {
+        assert(started[i - 1] >= started[i]);
+    }
+    assert(ordered.getProcessedCount() == 20);
+
+    // Several workers share the drain; failures and exceptions are counted
+    TaskProcessor pooled;
+    std::mutex seenMutex;
+    int seen = 0;
+    pooled.setWorkFunction([&](const Task& task) {
+        {
+            std::lock_guard<std::mutex> lock(seenMutex);
+            seen++;
+        }
+        if (task.id % 20 == 0) throw 42;   // not a std::exception
+        if (task.id % 10 == 0) throw std::runtime_error("boom");
+        return task.id % 5 != 0;
+    });
+    pooled.setWorkerCount(4);
+    assert(pooled.getWorkerCount() == 4);
+    for (int i = 0; i < 200; i++) {
+        pooled.addTask("Task", "", static_cast<TaskPriority>(i % 4));
+    }
+    pooled.processByPriority(TaskPriority::CRITICAL);
+    assert(seen == 50);
+    pooled.processAll();
+    assert(seen == 200);
+    assert(pooled.getProcessedCount() == 160);
+    assert(pooled.getFailedCount() == 40);
+    assert(pooled.getPendingCount() == 0);
+    assert(pooled.getTasksByStatus(TaskStatus::FAILED).size() == 40);
+
+    // Going back to inline mode keeps using the work function
+    pooled.setWorkerCount(0);
+    int id = pooled.addTask("Inline");
+    pooled.processTask(id);
+    assert(seen == 201);
+
+    std::cout << "✓ All worker pool tests passed!\n";
+}
+
+void test_work_stealing() {
+    std::cout << "\n=== Testing Work-Stealing Scheduler ===\n";
+
+    // One worker with no starvation limit keeps strict priority order
+    TaskProcessor ordered;
+    std::vector<TaskPriority> started;
+    ordered.setWorkFunction([&started](const Task& task) {
+        started.push_back(task.priority);
+        return true;
+    });
+    ordered.setSchedulingMode(SchedulingMode::WORK_STEALING, 0);
+    ordered.setWorkerCount(1);
+    for (int i = 0; i < 40; i++) {
+        ordered.addTask("Task", "", static_cast<TaskPriority>(i % 4));
+    }
+    ordered.processAll();
+    assert(started.size() == 40);
+    for (size_t i = 1; i < started.size(); i++) {
+        assert(started[i - 1] >= started[i]);
+    }
+
+    // With a starvation limit a LOW task runs before all CRITICAL ones finish
+    TaskProcessor aging;
+    std::vector<TaskPriority> agingOrder;
+    aging.setWorkFunction([&agingOrder](const Task& task) {
+        agingOrder.push_back(task.priority);
+        return true;
+    });
+    aging.setSchedulingMode(SchedulingMode::WORK_STEALING, 4);
+    aging.setWorkerCount(1);
+    for (int i = 0; i < 20; i++) {
+        aging.addTask("Critical", "", TaskPriority::CRITICAL);
+    }
+    aging.addTask("Low", "", TaskPriority::LOW);
+    aging.processAll();
+    assert(agingOrder.size() == 21);
+    assert(agingOrder[4] == TaskPriority::LOW);
+
+    // Many workers: every task runs exactly once and outcomes are applied
+    TaskProcessor pooled;
+    std::atomic<int> runs(0);
+    pooled.setWorkFunction([&runs](const Task& task) {
+        runs++;
+        return task.id % 3 != 0;
+    });
+    pooled.setSchedulingMode(SchedulingMode::WORK_STEALING);
+    pooled.setWorkerCount(8);
+    for (int i = 0; i < 3000; i++) {
+        pooled.addTask("Task", "", static_cast<TaskPriority>(i % 4));
+    }
+    pooled.processByPriority(TaskPriority::HIGH);
+    assert(runs == 750);
+    pooled.processAll();
+    assert(runs == 3000);
+    assert(pooled.getProcessedCount() == 2000);
+    assert(pooled.getFailedCount() == 1000);
+    assert(pooled.getStatusStats()[TaskStatus::COMPLETED] == 2000);
+    assert(pooled.getTask(3)->status == TaskStatus::FAILED);
+    assert(pooled.getTask(3)->completedAt != 0);
+
+    std::cout << "✓ All work-stealing tests passed!\n";
+}
+
+// Collects lines so tests can inspect what the processor logged
+class CaptureLogger : public Logger {
+public:
+    std::vector<std::pair<LogLevel, std::string>> lines;
+
+    void write(LogLevel level, const char* message, size_t length) override {
+        lines.emplace_back(level, std::string(message, length));
+    }
+};
+
+void test_logging() {
+    std::cout << "\n=== Testing Logging ===\n";
+
+    LogLine line;
+    line << "id=" << 42 << " big=" << 1234567890123LL << " size=" << size_t(7);
+    assert(std::string(line.data(), line.size()) == "id=42 big=1234567890123 size=7");
+    LogLine longLine;
+    longLine << std::string(1000, 'x');
+    assert(longLine.size() == kMaxLogLine);
+
+    auto capture = std::make_shared<CaptureLogger>();
+    capture->setLevel(LogLevel::INFO);
+    {
+        TaskProcessor processor;
+        processor.setLogger(capture);
+        processor.addTask("Quiet");
+        processor.removeTask(99);
+    }
+    bool sawWarning = false;
+    for (const auto& entry : capture->lines) {
+        assert(entry.first >= LogLevel::INFO);
+        if (entry.first == LogLevel::WARN) {
+            sawWarning = entry.second == "[TaskProcessor] Task #99 not found";
+        }
+    }
+    assert(sawWarning);
+
+    // Lines from many threads all reach the file once flushed
+    FILE* out = std::tmpfile();
+    assert(out);
+    {
+        AsyncLogger async(out, 64);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; t++) {
+            producers.emplace_back([&async, t] {
+                for (int i = 0; i < 500; i++) {
+                    TP_LOG_INFO(async, "producer " << t << " line " << i);
+                }
+            });
+        }
+        for (auto& producer : producers) producer.join();
+        async.flush();
+
+        std::fseek(out, 0, SEEK_SET);
+        size_t newlines = 0;
+        for (int ch; (ch = std::fgetc(out)) != EOF;) {
+            newlines += ch == '\n';
+        }
+        assert(newlines + async.getDroppedCount() == 2000);
+    }
+    std::fclose(out);
+
+    std::cout << "✓ All logging tests passed!\n";
+}
+
+void test_task_store() {
+    std::cout << "\n=== Testing Task Store ===\n";
+
+    StringArena arena(64);
+    std::string_view small = arena.store("abc");
+    std::string_view large = arena.store(std::string(100, 'y'));
+    assert(small == "abc");
+    assert(large.size() == 100 && large[99] == 'y');
+    assert(arena.bytesUsed() == 103);
+
+    TaskProcessor processor;
+    int a = processor.addTask("Alpha", "first", TaskPriority::HIGH);
+    int b = processor.addTask("Beta", "second", TaskPriority::LOW);
+    int c = processor.addTask("Gamma", "", TaskPriority::HIGH);
+
+    auto view = processor.getTaskView(a);
+    assert(view && view->title == "Alpha" && view->description == "first");
+    assert(view->priority == TaskPriority::HIGH);
+    assert(!processor.getTaskView(999));
+
+    auto high = processor.findByPriority(TaskPriority::HIGH);
+    assert(high.size() == 2 && high[0].id == a && high[1].id == c);
+    assert(processor.getTaskView(high[1])->title == "Gamma");
+
+    processor.updateTaskStatus(b, TaskStatus::COMPLETED);
+    processor.updateTaskPriority(c, TaskPriority::CRITICAL);
+    auto done = processor.findByStatus(TaskStatus::COMPLETED);
+    assert(done.size() == 1 && done[0].id == b);
+    assert(processor.getTaskView(b)->completedAt != 0);
+    assert(processor.findByPriority(TaskPriority::HIGH).size() == 1);
+    assert(processor.getTasksByPriority(TaskPriority::CRITICAL)[0]->id == c);
+
+    // Removed rows are skipped by scans; trimming keeps rows and ids aligned
+    processor.removeTask(a);
+    processor.removeTask(b);
+    assert(!processor.getTaskView(high[0]));   // stale handle
+    assert(!processor.getTaskView(TaskHandle{0}) && !processor.getTaskView(TaskHandle{999}));
+    assert(processor.findByStatus(TaskStatus::PENDING).size() == 1);
+    assert(processor.getStore().rowCount() == 1);
+    assert(processor.getTaskView(c)->title == "Gamma");
+    // The store reads the tasks' own strings rather than keeping copies
+    assert(processor.getTaskView(c)->title.data() == processor.getTask(c)->title.data());
+    processor.clearTasks();
+    assert(processor.getStore().rowCount() == 0);
+    assert(processor.getStore().stringBytes() == 0);
+
+    std::cout << "✓ All task store tests passed!\n";
+}
+
+void test_query() {
+    std::cout << "\n=== Testing Query Kernels ===\n";
+
+    // Every kernel level agrees with TaskQuery::matches on random columns
+    // (tombstones included) at lengths around the 64-row word boundary
+    std::vector<uint8_t> statuses(1000), priorities(1000);
+    unsigned seed = 12345;
+    for (size_t i = 0; i < statuses.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        statuses[i] = (seed >> 16) % 11 == 0 ? TaskStore::kRemovedMarker : (seed >> 8) % 4;
+        priorities[i] = statuses[i] == TaskStore::kRemovedMarker ? statuses[i] : (seed >> 20) % 4;
+    }
+    TaskQuery predicate = TaskQuery::withStatus(TaskStatus::PENDING).priorityAtLeast(TaskPriority::HIGH);
+    assert(predicate.priorityMask == 0x0C);
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE42, SimdLevel::AVX2}) {
+        const QueryKernels& kernels = queryKernels(level);
+        for (size_t rows : {size_t(0), size_t(1), size_t(63), size_t(64), size_t(65), size_t(1000)}) {
+            std::vector<uint32_t> expected;
+            for (size_t row = 0; row < rows; row++) {
+                if (predicate.matches(statuses[row], priorities[row])) expected.push_back(row);
+            }
+            std::vector<uint32_t> selected(rows);
+            selected.resize(kernels.select(statuses.data(), priorities.data(), rows, predicate, selected.data()));
+            assert(selected == expected);
+            assert(kernels.count(statuses.data(), priorities.data(), rows, predicate) == expected.size());
+            std::vector<uint64_t> words((rows + 63) / 64);
+            kernels.bitmap(statuses.data(), priorities.data(), rows, predicate, words.data());
+            size_t bits = 0;
+            for (uint64_t word : words) bits += __builtin_popcountll(word);
+            assert(bits == expected.size());
+        }
+    }
+
+    TaskProcessor processor;
+    for (int i = 0; i < 200; i++) {
+        processor.addTask("Task", "", static_cast<TaskPriority>(i % 4));
+    }
+    processor.updateTaskStatus(4, TaskStatus::COMPLETED);   // CRITICAL
+    processor.removeTask(8);                                // CRITICAL
+    auto urgent = processor.query(predicate);
+    assert(urgent.size() == 98);
+    assert(urgent[0] == 3 && urgent[1] == 7 && urgent[2] == 11);
+    assert(processor.countMatching(predicate) == 98);
+    TaskBitmap bitmap = processor.queryBitmap(predicate);
+    assert(bitmap.count() == 98);
+    assert(bitmap.test(3) && !bitmap.test(4) && !bitmap.test(8) && !bitmap.test(1000));
+    assert(processor.countMatching(TaskQuery::all()) == 199);
+    assert(processor.countMatching(TaskQuery::withStatus(TaskStatus::PENDING).orStatus(TaskStatus::COMPLETED)
+                                       .priorityAtMost(TaskPriority::LOW)) == 50);
+
+    std::cout << "✓ All query kernel tests passed! (" << simdLevelToString(detectSimdLevel()) << ")\n";
+}
+
+void test_write_ahead_log() {
+    std::cout << "\n=== Testing Write-Ahead Log ===\n";
+
+    const std::string path = "test_task_processor.wal";
+    std::remove(path.c_str());
+    {
+        TaskProcessor processor;
+        assert(processor.enableWal(path));
+        processor.setWorkFunction([](const Task& task) { return task.id != 2; });
+        processor.addTask("Alpha", "first", TaskPriority::HIGH);
+        processor.addTask("Beta", "", TaskPriority::LOW);
+        processor.addTask("Gamma", "third", TaskPriority::MEDIUM);
+        processor.addTask("Delta", "", TaskPriority::LOW);
+        processor.processByPriority(TaskPriority::LOW);   // 2 fails, 4 completes
+        processor.updateTaskPriority(3, TaskPriority::CRITICAL);
+        processor.updateTaskStatus(1, TaskStatus::IN_PROGRESS);
+        processor.removeTask(4);
+        processor.addTask("Epsilon");
+        processor.syncWal();
+    }
+
+    // A torn record at the end (crash mid-append) is ignored and cut off
+    FILE* log = std::fopen(path.c_str(), "ab");
+    assert(log);
+    std::fputs("\x20\x00\x00\x00garbage", log);
+    std::fclose(log);
+    {
+        TaskProcessor recovered;
+        assert(recovered.enableWal(path));
+        assert(recovered.getTotalCount() == 4);
+        assert(!recovered.getTask(4));
+        assert(recovered.getTask(1)->status == TaskStatus::IN_PROGRESS);
+        assert(recovered.getTask(2)->status == TaskStatus::FAILED);
+        assert(recovered.getTask(3)->priority == TaskPriority::CRITICAL);
+        assert(recovered.getTask(3)->description == "third");
+        assert(recovered.getTaskView(5)->title == "Epsilon");
+        assert(recovered.getProcessedCount() == 1);
+        assert(recovered.getFailedCount() == 1);
+        assert(recovered.countMatching(TaskQuery::withStatus(TaskStatus::PENDING)) == 2);
+        assert(recovered.addTask("Zeta") == 6);
+        recovered.removeTask(6);
+        recovered.removeTask(5);
+    }
+    {
+        // Removed tail ids stay used across a restart
+        TaskProcessor recovered;
+        assert(recovered.enableWal(path));
+        assert(recovered.getTotalCount() == 3);
+        assert(recovered.addTask("Eta") == 7);
+    }
+
+    // A frame with a valid checksum but an unknown type is not a torn tail:
+    // enabling fails and the file keeps every byte
+    {
+        const char type = '\x7F';
+        uint32_t frame[2] = {0, checksum32(&type, 1)};
+        log = std::fopen(path.c_str(), "ab");
+        assert(log);
+        std::fwrite(frame, sizeof(frame), 1, log);
+        std::fputc(type, log);
+        std::fclose(log);
+        log = std::fopen(path.c_str(), "rb");
+        std::fseek(log, 0, SEEK_END);
+        long before = std::ftell(log);
+        std::fclose(log);
+
+        TaskProcessor recovered;
+        assert(!recovered.enableWal(path));
+        assert(!recovered.isWalEnabled());
+        log = std::fopen(path.c_str(), "rb");
+        std::fseek(log, 0, SEEK_END);
+        assert(std::ftell(log) == before);
+        std::fclose(log);
+    }
+
+    // Group commit with waiting callers, and periodic truncation
+    std::remove(path.c_str());
+    {
+        WalOptions options;
+        options.waitForCommit = true;
+        options.commitLatency = std::chrono::microseconds(200);
+        options.truncateBytes = 4096;
+        TaskProcessor processor;
+        assert(processor.enableWal(path, options));
+        processor.setWorkerCount(2);
+        for (int i = 0; i < 500; i++) {
+            int id = processor.addTask("Churn", "", TaskPriority::HIGH);
+            if (i % 10 != 0) processor.removeTask(id);
+        }
+        processor.processAll();
+        log = std::fopen(path.c_str(), "rb");
+        std::fseek(log, 0, SEEK_END);
+        assert(std::ftell(log) < 8192);
+        std::fclose(log);
+    }
+    {
+        TaskProcessor recovered;
+        assert(recovered.enableWal(path));
+        assert(recovered.getTotalCount() == 50);
+        assert(recovered.getProcessedCount() == 50);
+        assert(recovered.addTask("Next") == 501);
+    }
+    std::remove(path.c_str());
+
+    // The size read by the processor after every mutation is consistent
+    // while the flusher writes: it never shrinks and ends at the file size
+    {
+        WalOptions options;
+        options.commitLatency = std::chrono::microseconds(50);
+        auto direct = WriteAheadLog::open(path, options);
+        assert(direct && direct->empty());
+        std::atomic<bool> done{false};
+        std::thread reader([&] {
+            size_t last = 0;
+            while (!done.load()) {
+                size_t size = direct->sizeBytes();
+                assert(size >= last);
+                last = size;
+            }
+        });
+        WalRecord record{WalRecordType::PRIORITY};
+        for (int i = 0; i < 20000; i++) {
+            record.id = i;
+            direct->append(record);
+        }
+        done = true;
+        reader.join();
+        assert(direct->sync() && !direct->empty());
+        log = std::fopen(path.c_str(), "rb");
+        std::fseek(log, 0, SEEK_END);
+        assert(static_cast<size_t>(std::ftell(log)) == direct->sizeBytes());
+        std::fclose(log);
+    }
+    std::remove(path.c_str());
+
+#ifndef _WIN32
+    // A failed write is never reported durable: with waitForCommit the
+    // mutation throws, and the log stays failed until a checkpoint
+    {
+        WalOptions options;
+        options.waitForCommit = true;
+        TaskProcessor processor(std::make_shared<StreamLogger>(LogLevel::ERROR));
+        assert(processor.enableWal(path, options));
+        processor.addTask("Durable");
+        assert(processor.syncWal() && processor.getWalError() == 0);
+
+        // Cap the file size so the next append fails with EFBIG
+        struct rlimit saved;
+        getrlimit(RLIMIT_FSIZE, &saved);
+        std::signal(SIGXFSZ, SIG_IGN);
+        FILE* current = std::fopen(path.c_str(), "rb");
+        std::fseek(current, 0, SEEK_END);
+        struct rlimit capped = saved;
+        capped.rlim_cur = static_cast<rlim_t>(std::ftell(current)) + 16;
+        std::fclose(current);
+        setrlimit(RLIMIT_FSIZE, &capped);
+        bool threw = false;
+        try {
+            processor.addTask(std::string(256, 'x'));
+        } catch (const std::system_error& error) {
+            threw = error.code().value() == EFBIG;
+        }
+        setrlimit(RLIMIT_FSIZE, &saved);
+        std::signal(SIGXFSZ, SIG_DFL);
+        assert(threw);
+        assert(processor.getTotalCount() == 2);   // applied in memory only
+        assert(processor.getWalError() == EFBIG && !processor.syncWal());
+        threw = false;
+        try {
+            processor.updateTaskStatus(1, TaskStatus::COMPLETED);
+        } catch (const std::system_error&) {
+            threw = true;
+        }
+        assert(threw);
+
+        // The checkpoint writes a fresh file holding everything
+        assert(processor.checkpointWal());
+        assert(processor.getWalError() == 0);
+        processor.addTask("After");
+        assert(processor.syncWal());
+    }
+    {
+        TaskProcessor recovered;
+        assert(recovered.enableWal(path));
+        assert(recovered.getTotalCount() == 3);
+        assert(recovered.getTask(2)->title.size() == 256);
+        assert(recovered.getTask(1)->status == TaskStatus::COMPLETED);
+    }
+    std::remove(path.c_str());
+#endif
+
+    std::cout << "✓ All write-ahead log tests passed!\n";
+}
+
+void test_snapshot() {
+    std::cout << "\n=== Testing Snapshots ===\n";
+
+    const std::string path = "test_task_processor.snap";
+    const std::string logPath = "test_task_processor.snap.wal";
+    std::remove(path.c_str());
+    std::remove(logPath.c_str());
+    {
+        TaskProcessor processor;
+        processor.setWorkFunction([](const Task& task) { return task.id % 3 != 0; });
+        for (int i = 0; i < 300; i++) {
+            processor.addTask("Task " + std::to_string(i), i % 2 ? "odd" : "",
+                              static_cast<TaskPriority>(i % 4));
+        }
+        processor.processByPriority(TaskPriority::HIGH);
+        processor.removeTask(1);
+        processor.removeTask(150);
+        processor.removeTask(300);
+        assert(processor.saveSnapshotAsync(path).get());
+    }
+    {
+        TaskProcessor loaded;
+        assert(loaded.loadSnapshot(path, true));
+        assert(loaded.getTotalCount() == 297);
+        assert(loaded.getProcessedCount() == 50 && loaded.getFailedCount() == 25);
+        assert(loaded.getStatusStats()[TaskStatus::PENDING] == 222);
+        // Views and queries read the mapped file without building tasks
+        assert(loaded.getTaskView(2)->title == "Task 1");
+        assert(loaded.getTaskView(2)->description == "odd");
+        assert(!loaded.getTaskView(150));
+        assert(loaded.countMatching(TaskQuery::withStatus(TaskStatus::FAILED)) == 25);
+        auto task = loaded.getTask(7);
+        assert(task && task->status == TaskStatus::COMPLETED && task->completedAt != 0);
+        assert(task->priority == TaskPriority::HIGH && task->title == "Task 6");
+        assert(loaded.addTask("After") == 301);
+        loaded.processAll();
+        assert(loaded.getPendingCount() == 0);
+        loaded.clearCompleted();
+        assert(loaded.getTotalCount() == loaded.getFailedCount());
+    }
+
+    // A damaged header is rejected; damaged contents only by a full check
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    assert(file);
+    std::fseek(file, -1, SEEK_END);
+    std::fputc('#', file);
+    std::fclose(file);
+    {
+        TaskProcessor loaded;
+        assert(!loaded.loadSnapshot(path, true));
+        assert(loaded.loadSnapshot(path));
+    }
+    file = std::fopen(path.c_str(), "r+b");
+    std::fseek(file, 20, SEEK_SET);
+    std::fputc(0x7F, file);
+    std::fclose(file);
+    {
+        TaskProcessor loaded;
+        assert(!loaded.loadSnapshot(path));
+    }
+
+    // With a log attached, a snapshot drops the log prefix it covers and a
+    // restart replays only what came after it
+    std::remove(path.c_str());
+    {
+        TaskProcessor processor;
+        assert(processor.enableWal(logPath));
+        for (int i = 0; i < 100; i++) {
+            processor.addTask("Logged", std::string(50, 'x'));
+        }
+        assert(processor.saveSnapshot(path));
+        processor.removeTask(5);
+        processor.updateTaskStatus(6, TaskStatus::FAILED);
+        processor.addTask("Late");
+    }
+    FILE* log = std::fopen(logPath.c_str(), "rb");
+    std::fseek(log, 0, SEEK_END);
+    assert(std::ftell(log) < 200);
+    std::fclose(log);
+    {
+        TaskProcessor recovered;
+        assert(!recovered.enableWal(logPath));   // needs the snapshot first
+    }
+    {
+        TaskProcessor recovered;
+        assert(recovered.loadSnapshot(path));
+        assert(recovered.enableWal(logPath));
+        assert(recovered.getTotalCount() == 100);
+        assert(!recovered.getTask(5));
+        assert(recovered.getTask(6)->status == TaskStatus::FAILED);
+        assert(recovered.getTask(101)->title == "Late");
+        assert(recovered.addTask("Next") == 102);
+    }
+    std::remove(path.c_str());
+    std::remove(logPath.c_str());
+
+    std::cout << "✓ All snapshot tests passed!\n";
+}
+
+void test_c_api() {
+    std::cout << "\n=== Testing C API ===\n";
+
+    task_processor_handle* handle = task_processor_create();
+    assert(handle);
+
+    const char strings[] = "FirstdescSecondThird";
+    uint32_t titleLengths[] = {5, 6, 5};
+    uint32_t descriptionLengths[] = {4, 0, 0};
+    int32_t priorities[] = {3, 0, 7};
+    int32_t ids[3];
+    assert(task_processor_add_tasks(handle, 3, strings, titleLengths, descriptionLengths,
+                                    priorities, ids) == 2);
+    assert(ids[0] == 1 && ids[1] == 2 && ids[2] == 0);
+
+    uint32_t letterLengths[] = {1, 1};
+    int32_t defaults[2];
+    assert(task_processor_add_tasks(handle, 2, "AB", letterLengths, nullptr, nullptr, defaults) == 2);
+    assert(defaults[0] == 3 && defaults[1] == 4);
+
+    int32_t updateIds[] = {1, 3, 99};
+    int32_t statuses[] = {2, 3, 2};
+    assert(task_processor_update_statuses(handle, updateIds, statuses, 3) == 2);
+    int32_t priorityIds[] = {2};
+    int32_t newPriorities[] = {2};
+    assert(task_processor_update_priorities(handle, priorityIds, newPriorities, 1) == 1);
+
+    int32_t matches[2];
+    assert(task_processor_query(handle, TASK_MASK_ALL, TASK_MASK_ALL, matches, 2) == 4);
+    assert(matches[0] == 1 && matches[1] == 2);
+    assert(task_processor_query(handle, 1u << 0, 1u << 2, matches, 2) == 1 && matches[0] == 2);
+
+    int32_t lookup[] = {1, 42};
+    task_record records[2];
+    assert(task_processor_get_records(handle, lookup, 2, records) == 1);
+    assert(records[0].id == 1 && records[0].priority == 3 && records[0].status == 2);
+    assert(records[0].completed_at >= records[0].created_at && records[1].id == 0);
+
+    char buffer[16];
+    uint32_t titles[2], descriptions[2];
+    assert(task_processor_get_strings(handle, lookup, 2, buffer, 4, titles, descriptions) == 9);
+    assert(task_processor_get_strings(handle, lookup, 2, buffer, sizeof(buffer), titles, descriptions) == 9);
+    assert(std::string(buffer, 9) == "Firstdesc" && titles[1] == 0);
+
+    int32_t removeIds[] = {3, 3};
+    assert(task_processor_remove_tasks(handle, removeIds, 2) == 1);
+    task_processor_process_all(handle);
+
+    int32_t byPriority[4], byStatus[4];
+    int64_t totals[3];
+    task_processor_get_counts(handle, byPriority, byStatus, totals);
+    assert(byStatus[2] == 3 && byStatus[0] == 0);
+    assert(byPriority[1] == 1 && byPriority[2] == 1 && byPriority[3] == 1);
+    assert(totals[0] == 2 && totals[1] == 0 && totals[2] == 3);
+
+    char wire[256];
+    size_t wireBytes = task_processor_serialize(handle, TASK_MASK_ALL, TASK_MASK_ALL, wire, sizeof(wire));
+    WireReader reader;
+    assert(wireBytes > 0 && reader.open(wire, wireBytes) && reader.size() == 3);
+    assert(reader.record(0).title == "First" && reader.record(0).description == "desc");
+
+    task_processor_destroy(handle);
+    task_processor_destroy(nullptr);
+
+    std::cout << "✓ All C API tests passed!\n";
+}
+
+void test_wire_format() {
+    std::cout << "\n=== Testing Wire Format ===\n";
+
+    TaskProcessor processor;
+    for (int i = 0; i < 50; i++) {
+        processor.addTask("Task " + std::to_string(i), i % 3 ? "desc" : "",
+                          static_cast<TaskPriority>(i % 4));
+    }
+    processor.addTask("");
+    processor.updateTaskStatus(2, TaskStatus::COMPLETED);
+    processor.removeTask(10);
+
+    // Sizing call, then the real one
+    size_t needed = processor.serializeTasks(nullptr, 0);
+    assert(needed > sizeof(WireHeader));
+    std::vector<char> buffer(needed + 8);
+    assert(processor.serializeTasks(buffer.data(), buffer.size()) == needed);
+
+    WireReader reader;
+    assert(reader.open(buffer.data(), buffer.size()));
+    assert(reader.size() == 50 && reader.bytes() == needed);
+    TaskView first = reader.record(0);
+    assert(first.id == 1 && first.title == "Task 0" && first.description.empty());
+    assert(first.priority == TaskPriority::LOW && first.status == TaskStatus::PENDING);
+    assert(reader.record(1).status == TaskStatus::COMPLETED && reader.record(1).completedAt > 0);
+    assert(reader.record(1).description == "desc");
+    assert(reader.record(8).id == 9 && reader.record(9).id == 11);   // 10 was removed
+    TaskView last = reader.record(49);
+    assert(last.id == 51 && last.title.empty() && last.priority == TaskPriority::MEDIUM);
+    // Zero-copy: strings point into the caller's buffer
+    assert(first.title.data() >= buffer.data() && first.title.data() < buffer.data() + needed);
+
+    // Filtered batches
+    size_t highBytes = processor.serializeTasks(buffer.data(), buffer.size(),
+                                                TaskQuery::withPriority(TaskPriority::HIGH));
+    assert(reader.open(buffer.data(), highBytes) && reader.size() == 12);
+    for (size_t i = 0; i < reader.size(); i++) {
+        assert(reader.record(i).priority == TaskPriority::HIGH);
+    }
+    size_t emptyBytes = processor.serializeTasks(buffer.data(), buffer.size(),
+                                                 TaskQuery::withStatus(TaskStatus::FAILED));
+    assert(reader.open(buffer.data(), emptyBytes) && reader.size() == 0);
+
+    // Gather form matches the buffer form byte for byte
+    WireSegments batch;
+    assert(processor.serializeTasks(batch));
+    assert(batch.totalBytes == needed && batch.segments.size() < 10);
+    std::string gathered;
+    for (const iovec& segment : batch.segments) {
+        gathered.append(static_cast<const char*>(segment.iov_base), segment.iov_len);
+    }
+    assert(processor.serializeTasks(buffer.data(), buffer.size()) == needed);
+    assert(gathered == std::string(buffer.data(), needed));
+
+    const std::string path = "test_task_processor.wire";
+    FILE* file = std::fopen(path.c_str(), "wb");
+    assert(file);
+    assert(writeSegments(fileno(file), batch));
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "rb");
+    std::string onDisk(needed, '\0');
+    assert(std::fread(&onDisk[0], 1, needed, file) == needed);
+    std::fclose(file);
+    std::remove(path.c_str());
+    assert(onDisk == gathered);
+
+    // Long strings are referenced where the task keeps them, not copied
+    {
+        TaskProcessor longer;
+        longer.addTask("Short", std::string(4096, 'x'));
+        WireSegments single;
+        assert(longer.serializeTasks(single) && single.segments.size() == 3);
+        assert(single.segments[2].iov_base == longer.getTask(1)->description.data());
+    }
+
+    // Malformed input is rejected up front
+    assert(!reader.open(buffer.data(), needed - 1));
+    std::vector<char> corrupt(buffer.begin(), buffer.begin() + needed);
+    corrupt[4] = 'X';
+    assert(!reader.open(corrupt.data(), corrupt.size()));
+    corrupt[4] = 'T';
+    corrupt[sizeof(WireHeader) + 4] = 9;   // priority out of range
+    assert(!reader.open(corrupt.data(), corrupt.size()));
+    corrupt.assign(buffer.begin(), buffer.begin() + needed);
+    size_t offsetTable = sizeof(WireHeader) + 50 * sizeof(WireRecord);
+    corrupt[offsetTable + 8] = static_cast<char>(0xFF);   // offsets must not decrease
+    assert(!reader.open(corrupt.data(), corrupt.size()));
+
+    std::cout << "✓ All wire format tests passed!\n";
+}
+
+void test_json_encoder() {
+    std::cout << "\n=== Testing JSON Encoder ===\n";
+
+    char buffer[512];
+    {
+        JsonWriter out(buffer, sizeof(buffer));
+        out.beginObject().key("n").value(-42).key("list").beginArray()
+           .value(true).null().value("a\"b\\c\n\t\x01\xc3\xa9").beginObject().endObject()
+           .endArray().key("big").value(static_cast<size_t>(18446744073709551615ULL)).endObject();
+        assert(out.ok());
+        assert(std::string(buffer, out.size()) ==
+               "{\"n\":-42,\"list\":[true,null,\"a\\\"b\\\\c\\n\\t\\u0001\xc3\xa9\",{}],"
+               "\"big\":18446744073709551615}");
+    }
+    {
+        JsonWriter out(buffer, sizeof(buffer));
+        out.beginArray().value(0.1).value(-2.5e-7).value(3.0).value(1.0 / 0.0).endArray();
+        assert(std::string(buffer, out.size()) == "[0.1,-2.5e-07,3,null]");
+    }
+
+    TaskProcessor processor;
+    processor.addTask("Write \"docs\"", "line1\nline2", TaskPriority::HIGH);
+    processor.addTask("Second");
+    processor.addTask("Third", "", TaskPriority::CRITICAL);
+    processor.processTask(2);
+    processor.removeTask(3);
+    processor.addTask("Fourth", "", TaskPriority::LOW);
+
+    // Pages of one task
+    JsonWriter page(buffer, sizeof(buffer));
+    assert(processor.writeTasksJson(page, TaskQuery::all(), 1, 1) == 1);
+    std::string json(buffer, page.size());
+    assert(json.rfind("{\"total\":3,\"offset\":1,\"limit\":1,\"tasks\":[{\"id\":2,", 0) == 0);
+    assert(json.find("\"status\":\"completed\",\"completed\":true") != std::string::npos);
+    assert(json.find("\"completed_at\":null") == std::string::npos);
+    assert(json.size() > 20 && json.compare(json.size() - 19, 19, "}],\"next_offset\":2}") == 0);
+
+    JsonWriter filtered(buffer, sizeof(buffer));
+    assert(processor.writeTasksJson(filtered, TaskQuery::withPriority(TaskPriority::HIGH)) == 1);
+    json.assign(buffer, filtered.size());
+    assert(json.find("\"title\":\"Write \\\"docs\\\"\",\"description\":\"line1\\nline2\","
+                     "\"priority\":\"high\",\"status\":\"pending\",\"completed\":false") != std::string::npos);
+    assert(json.find("\"limit\":null") != std::string::npos);
+    assert(json.find("\"completed_at\":null}],\"next_offset\":null}") != std::string::npos);
+
+    // A short buffer reports the size a retry needs
+    JsonWriter small(buffer, 10);
+    processor.writeTasksJson(small);
+    assert(!small.ok() && small.size() > 100);
+    std::vector<char> big(small.size());
+    JsonWriter retry(big.data(), big.size());
+    processor.writeTasksJson(retry);
+    assert(retry.ok() && retry.size() == big.size());
+
+    // Streaming to a descriptor matches the buffered output, across many
+    // internal flushes
+    for (int i = 0; i < 2000; i++) {
+        processor.addTask("Bulk " + std::to_string(i), std::string(i % 50, 'x'));
+    }
+    JsonWriter sizing(nullptr, 0);
+    processor.writeTasksJson(sizing);
+    std::vector<char> expected(sizing.size());
+    JsonWriter buffered(expected.data(), expected.size());
+    processor.writeTasksJson(buffered);
+
+    const std::string path = "test_task_processor.json";
+    FILE* file = std::fopen(path.c_str(), "wb");
+    assert(file);
+    {
+        JsonWriter stream(fileno(file));
+        assert(processor.writeTasksJson(stream) == 2003);
+        assert(stream.flush() && stream.size() == expected.size());
+    }
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "rb");
+    std::string onDisk(expected.size() + 1, '\0');
+    assert(std::fread(&onDisk[0], 1, onDisk.size(), file) == expected.size());
+    std::fclose(file);
+    std::remove(path.c_str());
+    assert(onDisk.compare(0, expected.size(), expected.data(), expected.size()) == 0);
+
+    std::cout << "✓ All JSON encoder tests passed!\n";
+}
+
+// Forwards to an upstream resource and counts the traffic
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+private:
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        return upstream->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        deallocations++;
+        upstream->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Throws bad_alloc once `remaining` allocations have been served
+class FailingResource : public std::pmr::memory_resource {
+public:
+    FailingResource(std::pmr::memory_resource* upstream, size_t remaining)
+        : remaining(remaining), upstream(upstream) {}
+    size_t remaining;
+
+private:
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (remaining == 0) throw std::bad_alloc();
+        remaining--;
+        return upstream->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        upstream->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void test_memory_resource() {
+    std::cout << "\n=== Testing Task Memory Resource ===\n";
+
+    TaskProcessor plain;
+    assert(plain.getMemoryResource() == std::pmr::get_default_resource());
+
+    std::pmr::monotonic_buffer_resource arena(64 * 1024);
+    CountingResource counting(&arena);
+    {
+        TaskProcessor processor(nullptr, &counting);
+        assert(processor.getMemoryResource() == &counting);
+
+        // Strings past the small-string buffer: task block, title, description
+        const size_t tasks = 100;
+        for (size_t i = 0; i < tasks; i++) {
+            processor.addTask("Arena allocated task " + std::to_string(i),
+                              "A description long enough to leave the SSO buffer",
+                              static_cast<TaskPriority>(i % 4));
+        }
+        assert(counting.allocations == tasks * 3);
+        auto task = processor.getTask(42);
+        assert(task->title == "Arena allocated task 41");
+        assert(task->title.get_allocator().resource() == &counting);
+
+        processor.processAll();
+        assert(processor.getProcessedCount() == static_cast<int>(tasks));
+
+        // Everything goes back to the resource once the last owner lets go
+        processor.clearTasks();
+        assert(counting.deallocations < counting.allocations);
+        task.reset();
+        assert(counting.deallocations == counting.allocations);
+    }
+    // The whole batch is returned to the system at once
+    arena.release();
+    std::cout << "100 tasks, " << counting.allocations
+              << " allocations from a monotonic buffer, freed by one release()\n";
+
+    // Lazily built snapshot tasks come from the resource too
+    const std::string path = "test_memory_resource.snap";
+    {
+        TaskProcessor source;
+        source.addTask("Snapshot task with a long title", "", TaskPriority::HIGH);
+        source.updateTaskStatus(1, TaskStatus::COMPLETED);
+        assert(source.saveSnapshot(path));
+    }
+    {
+        CountingResource loads(std::pmr::new_delete_resource());
+        TaskProcessor loaded(nullptr, &loads);
+        assert(loaded.loadSnapshot(path));
+        assert(loads.allocations == 0);
+        assert(loaded.getTask(1)->title == "Snapshot task with a long title");
+        assert(loads.allocations == 2);
+    }
+    std::remove(path.c_str());
+
+    std::cout << "✓ All memory resource tests passed!\n";
+}
+
+void test_metrics() {
+    std::cout << "\n=== Testing Metrics ===\n";
+
+    // Bucket layout: exact below 64, then 32 buckets per power of two
+    for (uint64_t value : {0ULL, 1ULL, 31ULL, 32ULL, 63ULL, 64ULL, 65ULL, 1000ULL, 123456789ULL,
+                           (1ULL << 47) + 12345}) {
+        size_t bucket = LatencyHistogram::bucketFor(value);
+        assert(bucket < LatencyHistogram::kBucketCount);
+        assert(LatencyHistogram::bucketLowest(bucket) <= value);
+        assert(LatencyHistogram::bucketHighest(bucket) >= value);
+        uint64_t width = LatencyHistogram::bucketHighest(bucket) - LatencyHistogram::bucketLowest(bucket);
+        assert(width * 32 <= value);
+    }
+    assert(LatencyHistogram::bucketFor(63) == 63);
+    assert(LatencyHistogram::bucketFor(UINT64_MAX) == LatencyHistogram::kBucketCount - 1);
+    for (size_t bucket = 1; bucket < LatencyHistogram::kBucketCount; bucket++) {
+        assert(LatencyHistogram::bucketLowest(bucket) == LatencyHistogram::bucketHighest(bucket - 1) + 1);
+    }
+
+    LatencyHistogram histogram;
+    assert(histogram.snapshot().percentile(0.5) == 0);
+    for (uint64_t value = 1; value <= 10000; value++) {
+        histogram.record(value);
+    }
+    HistogramSnapshot copy = histogram.snapshot();
+    assert(copy.count == 10000 && copy.min == 1 && copy.max == 10000);
+    assert(copy.sum == 10000ULL * 10001 / 2);
+    auto near = [](uint64_t got, double want) { return std::abs(got - want) <= want / 32 + 1; };
+    assert(near(copy.percentile(0.5), 5000));
+    assert(near(copy.percentile(0.99), 9900));
+    assert(copy.percentile(1.0) == 10000);
+    assert(copy.percentile(0.0) == 1);
+    histogram.reset();
+    assert(histogram.snapshot().count == 0);
+
+    // Throughput counters are always kept; latencies only once enabled
+    TaskProcessor processor;
+    assert(!processor.isLatencyMetricsEnabled());
+    processor.setWorkFunction([](const Task& task) { return task.priority != TaskPriority::LOW; });
+    for (int i = 0; i < 8; i++) {
+        processor.addTask("Task " + std::to_string(i), "", static_cast<TaskPriority>(i % 4));
+    }
+    processor.processAll();
+    TaskMetricsSnapshot metrics = processor.getMetrics();
+    assert(metrics.added[0] == 2 && metrics.added[3] == 2);
+    assert(metrics.completed[0] == 0 && metrics.failed[0] == 2);
+    assert(metrics.completed[2] == 2 && metrics.failed[2] == 0);
+    assert(!metrics.latencyEnabled);
+    for (const HistogramSnapshot& latency : metrics.latency) {
+        assert(latency.count == 0);
+    }
+
+    processor.setLatencyMetricsEnabled(true);
+    processor.resetMetrics();
+    int id = processor.addTask("Timed", "", TaskPriority::HIGH);
+    processor.updateTaskPriority(id, TaskPriority::CRITICAL);
+    processor.getTasksByStatus(TaskStatus::PENDING);
+    processor.countMatching(TaskQuery::all());
+    processor.processAll();
+    processor.updateTaskStatus(id, TaskStatus::PENDING);
+    processor.processTask(id);
+    metrics = processor.getMetrics();
+    auto count = [&](LatencyMetric metric) { return metrics.latency[static_cast<size_t>(metric)].count; };
+    assert(metrics.latencyEnabled);
+    assert(count(LatencyMetric::ADD) == 1);
+    assert(count(LatencyMetric::UPDATE) == 2);
+    assert(count(LatencyMetric::QUERY) == 2);
+    assert(count(LatencyMetric::PROCESS) == 2);
+    assert(count(LatencyMetric::QUEUE_WAIT) == 2 && count(LatencyMetric::SERVICE) == 2);
+    assert(metrics.added[3] == 0 && metrics.added[2] == 1 && metrics.completed[3] == 2);
+    assert(metrics.latency[static_cast<size_t>(LatencyMetric::ADD)].max > 0);
+
+    // Snapshots run concurrently with a worker pool draining
+    processor.setWorkerCount(2);
+    processor.setWorkFunction(nullptr);
+    for (int i = 0; i < 2000; i++) {
+        processor.addTask("Pooled", "", static_cast<TaskPriority>(i % 4));
+    }
+    std::atomic<bool> draining{true};
+    std::thread reader([&] {
+        while (draining) {
+            TaskMetricsSnapshot live = processor.getMetrics();
+            assert(live.latency[static_cast<size_t>(LatencyMetric::SERVICE)].count <= 2002);
+        }
+    });
+    processor.processAll();
+    draining = false;
+    reader.join();
+    metrics = processor.getMetrics();
+    assert(count(LatencyMetric::SERVICE) == 2002);
+    assert(metrics.completed[0] + metrics.completed[1] + metrics.completed[2] + metrics.completed[3] == 2002);
+
+    std::string text = metrics.toPrometheus();
+    assert(text.find("# TYPE taskprocessor_tasks_completed_total counter\n") != std::string::npos);
+    assert(text.find("taskprocessor_tasks_added_total{priority=\"high\"} 501\n") != std::string::npos);
+    assert(text.find("taskprocessor_operation_seconds_count{operation=\"add\"} 2001\n") != std::string::npos);
+    assert(text.find("taskprocessor_operation_seconds{operation=\"process\",quantile=\"0.99\"} ")
+           != std::string::npos);
+    assert(text.find("taskprocessor_service_seconds_count 2002\n") != std::string::npos);
+    assert(metrics.toPrometheus("tp").find("tp_queue_wait_seconds_sum ") != std::string::npos);
+
+    char buffer[4096];
+    JsonWriter out(buffer, sizeof(buffer));
+    metrics.writeJson(out);
+    assert(out.ok());
+    std::string json(buffer, out.size());
+    assert(json.find("\"latency_enabled\":true,\"counters\":{\"added\":{\"low\":500,"
+                     "\"medium\":500,\"high\":501,\"critical\":500}") != std::string::npos);
+    assert(json.find("\"service\":{\"count\":2002,") != std::string::npos);
+    std::cout << "Prometheus export: " << text.size() << " bytes, JSON: " << json.size() << " bytes\n";
+
+    std::cout << "✓ All metrics tests passed!\n";
+}
+
+void test_concurrent_processor() {
+    std::cout << "\n=== Testing Concurrent Processor ===\n";
+
+    auto quiet = std::make_shared<StreamLogger>(LogLevel::ERROR);
+
+    // Ids map round-robin onto shards and round-trip through every call
+    ConcurrentTaskProcessor small(3, quiet);
+    assert(small.getShardCount() == 3);
+    for (int i = 1; i <= 7; i++) {
+        assert(small.addTask("Task " + std::to_string(i), "", static_cast<TaskPriority>(i % 4)) == i);
+    }
+    auto task = small.getTask(5);
+    assert(task && task->id == 5 && task->title == "Task 5" && task->priority == TaskPriority::MEDIUM);
+    assert(!small.getTask(0) && !small.getTask(8) && !small.getTask(-1));
+    assert(small.updateTaskStatus(5, TaskStatus::IN_PROGRESS));
+    assert(small.updateTaskPriority(6, TaskPriority::CRITICAL));
+    assert(small.removeTask(2) && !small.removeTask(2));
+    assert(small.getTotalCount() == 6 && small.getPendingCount() == 5);
+    assert(small.getStatusStats().at(TaskStatus::IN_PROGRESS) == 1);
+    assert(small.getPriorityStats().at(TaskPriority::CRITICAL) == 3);
+
+    // Merged results come back in ascending global id order
+    std::vector<int> pending = small.query(TaskQuery::withStatus(TaskStatus::PENDING));
+    assert((pending == std::vector<int>{1, 3, 4, 6, 7}));
+    auto critical = small.getTasksByPriority(TaskPriority::CRITICAL);
+    assert(critical.size() == 3 && critical[0].id == 3 && critical[1].id == 6 && critical[2].id == 7);
+    assert(small.countMatching(TaskQuery::withStatus(TaskStatus::PENDING)) == 5);
+
+    // A batch takes the same shards and ids as one addTask per spec
+    {
+        ConcurrentTaskProcessor batched(3, quiet);
+        assert(batched.addTask("Before") == 1);
+        TaskSpec five[] = {{"A", "", TaskPriority::LOW}, {"B", "b", TaskPriority::HIGH},
+                           {"C", "", TaskPriority::LOW}, {"D", "", TaskPriority::CRITICAL},
+                           {"E", "", TaskPriority::LOW}};
+        int fiveIds[5] = {};
+        assert(batched.addTasks(five, 5, fiveIds) == 5 && batched.addTasks(nullptr, 0) == 0);
+        for (int i = 0; i < 5; i++) {
+            assert(fiveIds[i] == i + 2 && batched.getTask(i + 2)->title == five[i].title);
+        }
+        assert(batched.getTask(3)->description == "b");
+        assert(batched.addTask("After") == 7);
+        assert(batched.getTotalCount() == 7 && batched.getPriorityStats().at(TaskPriority::LOW) == 3);
+    }
+
+    // processAll drains each level across all shards, CRITICAL first, and
+    // the work function sees global ids
+    std::vector<int> order;
+    small.setWorkFunction([&order](const Task& t) {
+        order.push_back(t.id);
+        return t.id != 7;
+    });
+    small.processAll();
+    assert(order.size() == 5);
+    std::sort(order.begin(), order.begin() + 3);
+    assert((order == std::vector<int>{3, 6, 7, 1, 4}));
+    assert(small.getProcessedCount() == 4 && small.getFailedCount() == 1);
+    assert(small.getTasksByStatus(TaskStatus::FAILED)[0].id == 7);
+    small.clearTasks();
+    assert(small.getTotalCount() == 0 && small.getTasksByStatus(TaskStatus::COMPLETED).empty());
+
+    // Many threads adding, updating and reading: ids stay unique and the
+    // lock-free counters agree with the merged queries once they finish
+    ConcurrentTaskProcessor shared(4, quiet);
+    const int threads = 8;
+    const int perThread = 500;
+    std::vector<std::vector<int>> ids(threads);
+    std::atomic<bool> running{true};
+    std::thread reader([&] {
+        while (running) {
+            int total = shared.getTotalCount();
+            assert(total >= 0 && total <= threads * perThread);
+            auto listed = shared.query(TaskQuery::withStatus(TaskStatus::PENDING));
+            for (size_t i = 1; i < listed.size(); i++) {
+                assert(listed[i - 1] < listed[i]);
+            }
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; i++) {
+                int id = shared.addTask("Task", "", static_cast<TaskPriority>(i % 4));
+                ids[t].push_back(id);
+                if (i % 5 == 0) assert(shared.updateTaskStatus(id, TaskStatus::COMPLETED));
+                assert(shared.getTask(id)->id == id);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    running = false;
+    reader.join();
+
+    std::vector<int> all;
+    for (const auto& mine : ids) {
+        all.insert(all.end(), mine.begin(), mine.end());
+    }
+    std::sort(all.begin(), all.end());
+    assert(std::adjacent_find(all.begin(), all.end()) == all.end());
+    assert(all.front() == 1 && all.back() == threads * perThread);
+    assert(shared.getTotalCount() == threads * perThread);
+    assert(shared.getStatusStats().at(TaskStatus::COMPLETED) == threads * perThread / 5);
+    assert(static_cast<int>(shared.getTasksByStatus(TaskStatus::COMPLETED).size()) ==
+           threads * perThread / 5);
+    assert(shared.getPendingCount() == threads * perThread * 4 / 5);
+    assert(shared.getPriorityStats().at(TaskPriority::LOW) == threads * perThread / 4);
+
+    // Processing from several threads at once still runs each task once
+    std::atomic<int> runs{0};
+    shared.setWorkFunction([&runs](const Task&) {
+        runs++;
+        return true;
+    });
+    std::vector<std::thread> drainers;
+    for (int t = 0; t < 3; t++) {
+        drainers.emplace_back([&shared] { shared.processAll(); });
+    }
+    for (auto& drainer : drainers) {
+        drainer.join();
+    }
+    assert(runs == threads * perThread * 4 / 5);
+    assert(shared.getPendingCount() == 0);
+    assert(shared.getProcessedCount() == runs);
+
+    std::cout << "✓ All concurrent processor tests passed!\n";
+}
+
+void test_ingest_queue() {
+    std::cout << "\n=== Testing Ingest Queue ===\n";
+
+    // The ring rounds up to a power of two, keeps FIFO order and reports
+    // full/empty without blocking
+    MpmcRing<int> ring(5);
+    assert(ring.capacity() == 8);
+    int value = 0;
+    assert(!ring.tryPop(value));
+    for (int i = 0; i < 8; i++) {
+        assert(ring.tryPush(int(i)));
+    }
+    assert(!ring.tryPush(99) && ring.size() == 8);
+    for (int round = 0; round < 20; round++) {
+        assert(ring.tryPop(value) && value == round);
+        assert(ring.tryPush(round + 8));
+    }
+
+    // Back-pressure: a full queue rejects at once, or after the timeout
+    auto quiet = std::make_shared<StreamLogger>(LogLevel::ERROR);
+    TaskIngestQueue small(4);
+    for (int i = 0; i < 4; i++) {
+        assert(small.trySubmit("Task " + std::to_string(i)));
+    }
+    assert(!small.trySubmit("Overflow"));
+    auto start = std::chrono::steady_clock::now();
+    assert(!small.submitFor(std::chrono::milliseconds(5), "Late"));
+    assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5));
+    assert(small.getRejectedCount() == 2);
+
+    TaskProcessor processor(quiet);
+    assert(small.drainInto(processor, 3) == 3);
+    assert(small.size() == 1 && processor.getTotalCount() == 3);
+    assert(processor.getTask(1)->title == "Task 0" && processor.getTask(3)->title == "Task 2");
+
+    // A blocked producer gets in once a consumer frees a cell
+    assert(small.trySubmit("A") && small.trySubmit("B") && small.trySubmit("C"));
+    std::thread consumer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        small.drainInto(processor);
+    });
+    assert(small.submitFor(std::chrono::seconds(5), "Waited", "", TaskPriority::HIGH));
+    consumer.join();
+    small.drainInto(processor);
+    assert(processor.getTotalCount() == 8);
+    assert(processor.getTasksByPriority(TaskPriority::HIGH).size() == 1);
+
+    // Many producers, one consumer: nothing is lost or duplicated and each
+    // producer's tasks keep their submission order
+    const int producers = 6;
+    const int perProducer = 2000;
+    TaskIngestQueue queue(64);
+    TaskProcessor sink(quiet);
+    std::atomic<int> done{0};
+    std::thread drainer([&] {
+        while (done < producers || queue.size() > 0) {
+            if (queue.drainInto(sink, 100) == 0) std::this_thread::yield();
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; i++) {
+                while (!queue.submitFor(std::chrono::milliseconds(1), std::to_string(p),
+                                        std::to_string(i), static_cast<TaskPriority>(p % 4))) {
+                }
+            }
+            done++;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    drainer.join();
+    assert(sink.getTotalCount() == producers * perProducer);
+    std::vector<int> next(producers, 0);
+    for (int id = 1; id <= producers * perProducer; id++) {
+        auto task = sink.getTask(id);
+        int p = std::stoi(std::string(task->title));
+        assert(std::stoi(std::string(task->description)) == next[p]++);
+        assert(task->priority == static_cast<TaskPriority>(p % 4));
+    }
+
+    // Several consumers may drain into a ConcurrentTaskProcessor
+    ConcurrentTaskProcessor shared(4, quiet);
+    for (int i = 0; i < 60; i++) {
+        assert(queue.trySubmit("Shared"));
+    }
+    std::thread second([&] { queue.drainInto(shared); });
+    queue.drainInto(shared);
+    second.join();
+    assert(shared.getTotalCount() == 60 && queue.size() == 0);
+
+    // A drain that throws part-way counts the popped submissions it lost
+    FailingResource failing(std::pmr::get_default_resource(), 3);
+    TaskProcessor limited(quiet, &failing);
+    for (int i = 0; i < 5; i++) {
+        assert(queue.trySubmit("Lost?"));
+    }
+    bool threw = false;
+    try {
+        queue.drainInto(limited);
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    assert(threw && limited.getTotalCount() == 3);
+    assert(queue.getDroppedCount() == 2 && queue.size() == 0);
+
+    std::cout << "✓ All ingest queue tests passed!\n";
+}
+
+void test_batch_mutations() {
+    std::cout << "\n=== Testing Batch Mutations ===\n";
+
+    auto quiet = std::make_shared<StreamLogger>(LogLevel::ERROR);
+    TaskProcessor processor(quiet);
+    processor.addTask("Single");
+
+    // Ids are consecutive, follow on from addTask and land in the buffer
+    std::vector<TaskSpec> specs;
+    std::vector<std::string> titles;
+    for (int i = 0; i < 1000; i++) {
+        titles.push_back("Batch " + std::to_string(i));
+    }
+    for (int i = 0; i < 1000; i++) {
+        specs.push_back({titles[i], i % 2 ? "odd" : "", static_cast<TaskPriority>(i % 4)});
+    }
+    std::vector<int> ids(specs.size());
+    assert(processor.addTasks(specs.data(), specs.size(), ids.data()) == 1000);
+    assert(processor.addTasks(nullptr, 0) == 0);
+    for (int i = 0; i < 1000; i++) {
+        assert(ids[i] == i + 2);
+    }
+    titles.clear();   // the processor keeps its own copies
+    assert(processor.getTask(2)->title == "Batch 0" && processor.getTask(3)->description == "odd");
+    assert(processor.getTotalCount() == 1001 && processor.getPendingCount() == 1001);
+    assert(processor.getPriorityStats().at(TaskPriority::CRITICAL) == 250);
+    assert(processor.getPriorityStats().at(TaskPriority::MEDIUM) == 251);
+    assert(processor.getMetrics().added[static_cast<size_t>(TaskPriority::LOW)] == 250);
+    assert(processor.addTask("After") == 1002);
+
+    // Unknown ids are skipped; the counters move once per found task
+    std::vector<TaskStatusUpdate> updates = {
+        {2, TaskStatus::COMPLETED}, {3, TaskStatus::IN_PROGRESS}, {9999, TaskStatus::FAILED},
+        {4, TaskStatus::FAILED}, {3, TaskStatus::PENDING}, {-1, TaskStatus::COMPLETED}};
+    assert(processor.updateStatuses(updates.data(), updates.size()) == 4);
+    assert(processor.getTask(2)->status == TaskStatus::COMPLETED && processor.getTask(2)->completedAt > 0);
+    assert(processor.getTask(3)->status == TaskStatus::PENDING);
+    assert(processor.getPendingCount() == 1000);
+    assert(processor.getStatusStats().at(TaskStatus::FAILED) == 1);
+    assert(processor.countMatching(TaskQuery::withStatus(TaskStatus::PENDING)) == 1000);
+
+    // Removing the leading run, with duplicates and misses, keeps later ids
+    // reachable
+    std::vector<int> doomed;
+    for (int id = 1; id <= 600; id++) {
+        doomed.push_back(id);
+    }
+    doomed.push_back(5);
+    doomed.push_back(5000);
+    assert(processor.removeTasks(doomed.data(), doomed.size()) == 600);
+    assert(processor.getTotalCount() == 402 && !processor.getTask(600));
+    assert(processor.getTask(601)->title == "Batch 599" && processor.getTask(1002)->title == "After");
+    assert(processor.getPendingCount() == 402);
+
+    // Ready lists stay in priority then insertion order
+    std::vector<int> order;
+    processor.setWorkFunction([&order](const Task& task) {
+        order.push_back(task.id);
+        return true;
+    });
+    processor.processByPriority(TaskPriority::CRITICAL);
+    assert(order.size() == 101 && order.front() == 601 && order.back() == 1001);
+    processor.processAll();
+    assert(processor.getProcessedCount() == 402 && processor.getPendingCount() == 0);
+
+    // Batches are logged record by record, so replay rebuilds the same state
+    const std::string path = "test_task_processor.batch.wal";
+    std::remove(path.c_str());
+    {
+        TaskProcessor logged(quiet);
+        assert(logged.enableWal(path));
+        TaskSpec batch[] = {{"One", "1", TaskPriority::HIGH}, {"Two", "", TaskPriority::MEDIUM}, {"Three", "", TaskPriority::LOW}};
+        int batchIds[3];
+        assert(logged.addTasks(batch, 3, batchIds) == 3 && batchIds[2] == 3);
+        TaskStatusUpdate done[] = {{1, TaskStatus::COMPLETED}, {3, TaskStatus::FAILED}};
+        assert(logged.updateStatuses(done, 2) == 2);
+        int gone[] = {2};
+        assert(logged.removeTasks(gone, 1) == 1);
+        logged.syncWal();
+    }
+    {
+        TaskProcessor recovered(quiet);
+        assert(recovered.enableWal(path));
+        assert(recovered.getTotalCount() == 2 && !recovered.getTask(2));
+        assert(recovered.getTask(1)->status == TaskStatus::COMPLETED);
+        assert(recovered.getTask(1)->description == "1");
+        assert(recovered.getTask(3)->status == TaskStatus::FAILED);
+        assert(recovered.addTask("Four") == 4);
+    }
+    std::remove(path.c_str());
+
+    // An allocation failure part-way through keeps the tasks already added:
+    // counted, with their ids written, and the next id follows on
+    FailingResource failing(std::pmr::get_default_resource(), 3);
+    {
+        TaskProcessor limited(quiet, &failing);
+        TaskSpec five[] = {{"A", "", TaskPriority::LOW}, {"B", "", TaskPriority::HIGH},
+                           {"C", "", TaskPriority::LOW}, {"D", "", TaskPriority::LOW},
+                           {"E", "", TaskPriority::LOW}};
+        int fiveIds[5] = {};
+        bool threw = false;
+        try {
+            limited.addTasks(five, 5, fiveIds);
+        } catch (const std::bad_alloc&) {
+            threw = true;
+        }
+        assert(threw);
+        assert(fiveIds[0] == 1 && fiveIds[2] == 3 && fiveIds[3] == 0 && fiveIds[4] == 0);
+        assert(limited.getTotalCount() == 3 && limited.getPendingCount() == 3);
+        assert(limited.getPriorityStats().at(TaskPriority::LOW) == 2);
+        failing.remaining = SIZE_MAX;
+        assert(limited.addTask("F") == 4 && limited.getTask(4)->title == "F");
+    }
+
+    // The C API routes its bulk calls through the batch methods
+    task_processor_handle* handle = task_processor_create();
+    const char packed[] = "abcdef";
+    uint32_t titleLengths[] = {1, 2, 3};
+    int32_t priorities[] = {0, 7, 3};
+    int32_t apiIds[3];
+    assert(task_processor_add_tasks(handle, 3, packed, titleLengths, nullptr, priorities, apiIds) == 2);
+    assert(apiIds[0] == 1 && apiIds[1] == 0 && apiIds[2] == 2);
+    int32_t statuses[] = {2, 9};
+    assert(task_processor_update_statuses(handle, apiIds, statuses, 2) == 1);
+    assert(task_processor_remove_tasks(handle, apiIds, 3) == 2);
+    task_processor_destroy(handle);
+
+    // ...and reports a partial batch: the handle's processor allocates from
+    // the default resource it was created with
+    failing.remaining = 2;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&failing);
+    handle = task_processor_create();
+    std::pmr::set_default_resource(previous);
+    int32_t partialIds[3] = {-1, -1, -1};
+    int32_t valid[] = {0, 1, 2};
+    assert(task_processor_add_tasks(handle, 3, packed, titleLengths, nullptr, valid, partialIds) == 2);
+    assert(partialIds[0] == 1 && partialIds[1] == 2 && partialIds[2] == 0);
+    int32_t counts[4];
+    task_processor_get_counts(handle, counts, nullptr, nullptr);
+    assert(counts[0] + counts[1] + counts[2] + counts[3] == 2);
+    task_processor_destroy(handle);
+
+    std::cout << "✓ All batch mutation tests passed!\n";
+}
+
+int main() {
+    std::cout << "\n╔════════════════════════════════════╗\n";
+    std::cout << "║   TaskProcessor Test Suite v2.0    ║\n";
+    std::cout << "╚════════════════════════════════════╝\n";
+
+    test_lookup_and_removal();
+    test_status_and_priority_updates();
+    test_process_all();
+    test_statistics();
+    test_ready_queue();
+    test_worker_pool();
+    test_work_stealing();
+    test_logging();
+    test_task_store();
+    test_query();
+    test_write_ahead_log();
+    test_snapshot();
+    test_c_api();
+    test_wire_format();
+    test_json_encoder();
+    test_memory_resource();
+    test_metrics();
+    test_concurrent_processor();
+    test_ingest_queue();
+    test_batch_mutations();
+
+    std::cout << "\n╔════════════════════════════════════╗\n";
+    std::cout << "║   ✓ ALL TESTS PASSED!              ║\n";
+    std::cout << "╚════════════════════════════════════╝\n\n";
+
+    return 0;
+}
@@ -3,6 +3,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <ctype.h>
 
 void test_math_functions() {
     printf("\n=== Testing Math Functions ===\n");
@@ -38,6 +41,251 @@ void test_math_functions() {
     printf("✓ All math tests passed!\n");
 }
 
+static bool trial_division(unsigned long long n) {
+    if (n < 2) return false;
+    for (unsigned long long d = 2; d * d <= n; d++) {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+static bool bit_set(const unsigned char* bitmap, size_t i) {
+    return (bitmap[i / 8] >> (i % 8)) & 1;
+}
+
+// Sieves [low, high) and checks each bit and the count against is_prime_u64
+static void check_sieve(unsigned long long low, unsigned long long high) {
+    size_t width = (size_t)(high - low);
+    unsigned char* bitmap = (unsigned char*)safe_malloc(width / 8 + 1);
+    size_t count = prime_sieve_range(low, high, bitmap);
+    size_t expected = 0;
+    for (size_t i = 0; i < width; i++) {
+        bool prime = is_prime_u64(low + i);
+        assert(bit_set(bitmap, i) == prime);
+        expected += prime;
+    }
+    assert(count == expected);
+    free(bitmap);
+}
+
+void test_primality() {
+    printf("\n=== Testing Primality ===\n");
+
+    for (unsigned long long n = 0; n < 20000; n++) {
+        assert(is_prime_u64(n) == trial_division(n));
+    }
+    for (unsigned long long n = 4294967000ULL; n < 4294968000ULL; n++) {
+        assert(is_prime_u64(n) == trial_division(n));
+    }
+    assert(is_prime(2147483647) && !is_prime(-7) && !is_prime(1));
+
+    // Large primes and strong pseudoprimes to small bases
+    assert(is_prime_u64(2305843009213693951ULL));        // 2^61 - 1
+    assert(is_prime_u64(18446744073709551557ULL));       // largest 64-bit prime
+    assert(!is_prime_u64(18446744073709551615ULL));
+    assert(!is_prime_u64(561));                          // Carmichael
+    assert(!is_prime_u64(3215031751ULL));                // passes bases 2, 3, 5, 7
+    assert(!is_prime_u64(2152302898747ULL));             // passes bases up to 11
+    assert(!is_prime_u64(3825123056546413051ULL));       // passes bases up to 23
+    assert(!is_prime_u64(4294967291ULL * 4294967279ULL));
+
+    // Sieve: pi(10^6), odd and even starts, partial bytes, segment edges
+    unsigned char* bitmap = (unsigned char*)safe_malloc(1000000 / 8 + 1);
+    size_t primes = prime_sieve_range(0, 1000000, bitmap);
+    printf("Primes below 10^6: %zu (expected: 78498)\n", primes);
+    assert(primes == 78498);
+    assert(prime_sieve_range(10, 10, bitmap) == 0);
+    free(bitmap);
+    check_sieve(0, 3);
+    check_sieve(1, 100);
+    check_sieve(2, 3);
+    check_sieve(7, 300001);
+    check_sieve(1000000007ULL, 1000300000ULL);
+    check_sieve(1099511627776ULL - 50000, 1099511627776ULL + 50003);   // around 2^40, sieved
+    check_sieve(1099511627776ULL - 5000, 1099511627776ULL + 5003);     // narrow: tested one by one
+    check_sieve(18446744073709550000ULL, 18446744073709551615ULL);      // top of the range
+
+    // Batch: sieved (small values, a narrow high range) and tested one by
+    // one (values spread over 64 bits)
+    size_t count = 5000;
+    long long* values = (long long*)safe_malloc(count * sizeof(long long));
+    unsigned char* out = (unsigned char*)safe_malloc(count / 8 + 1);
+    unsigned int seed = 3;
+    for (int pass = 0; pass < 3; pass++) {
+        for (size_t i = 0; i < count; i++) {
+            seed = seed * 1103515245u + 12345u;
+            switch (pass) {
+                case 0: values[i] = (long long)(seed % 100000) - 10; break;
+                case 1: values[i] = 3000000000LL + (long long)(seed % 1000000); break;
+                case 2: values[i] = (long long)(((unsigned long long)seed << 31) | seed); break;
+            }
+        }
+        is_prime_batch(values, count, out);
+        for (size_t i = 0; i < count; i++) {
+            assert(bit_set(out, i) == (values[i] >= 0 && is_prime_u64((unsigned long long)values[i])));
+        }
+    }
+    free(values);
+    free(out);
+    printf("✓ All primality tests passed!\n");
+}
+
+// Limbs reduced modulo m by Horner's rule, for cross-checking *_mod
+static unsigned long long limbs_mod(const uint32_t* limbs, size_t count, unsigned long long m) {
+    unsigned long long r = 0;
+    for (size_t i = count; i-- > 0;) {
+        r = (unsigned long long)(((unsigned __int128)r << 32 | limbs[i]) % m);
+    }
+    return r;
+}
+
+void test_big_numbers() {
+    printf("\n=== Testing Big Numbers ===\n");
+
+    // Fast doubling wraps exactly like the old iterative loops
+    long long a = 0, b = 1;
+    for (int n = 0; n < 200; n++) {
+        assert(fibonacci_long(n) == a);
+        assert(fibonacci(n) == (int)(unsigned int)(unsigned long long)a);
+        long long next = (long long)((unsigned long long)a + (unsigned long long)b);
+        a = b;
+        b = next;
+    }
+    assert(factorial(12) == 479001600 && factorial_long(20) == 2432902008176640000LL);
+    assert(factorial(-1) == -1 && fibonacci_long(-3) == -1);
+
+    // Modular variants
+    unsigned long long p = 1000000007ULL, big = 18446744073709551557ULL;
+    unsigned long long fa = 0, fb = 1, fc = 0, fd = 1, fact = 1;
+    for (unsigned long long n = 0; n < 3000; n++) {
+        assert(fibonacci_mod(n, p) == fa);
+        assert(fibonacci_mod(n, big) == fc);
+        if (n > 0) fact = (unsigned long long)((unsigned __int128)fact * n % big);
+        assert(factorial_mod(n, big) == fact);
+        unsigned long long next = (fa + fb) % p;
+        fa = fb;
+        fb = next;
+        next = (unsigned long long)(((unsigned __int128)fc + fd) % big);
+        fc = fd;
+        fd = next;
+    }
+    assert(factorial_mod(1000002, 1000003) == 1000002);     // Wilson's theorem
+    assert(factorial_mod(10, 7) == 0 && fibonacci_mod(10, 1) == 0 && factorial_mod(5, 0) == 0);
+    assert(fibonacci_mod(1000000000000000000ULL, 1000000007ULL) == 209783453ULL);
+
+    // Exact values in decimal
+    char text[512];
+    uint32_t limbs[64];
+    size_t count = factorial_big(100, limbs, 64);
+    assert(count <= factorial_big_limbs(100));
+    big_to_decimal(limbs, count, text, sizeof(text));
+    assert(strcmp(text, "93326215443944152681699238856266700490715968264381621468592963895217"
+                        "599993229915608941463976156518286253697920827223758251185210916864"
+                        "000000000000000000000000") == 0);
+    count = fibonacci_big(300, limbs, 64);
+    assert(big_to_decimal(limbs, count, text, sizeof(text)) == 63);
+    assert(strcmp(text, "222232244629420445529739893461909967206666939096499764990979600") == 0);
+    assert(fibonacci_big(0, limbs, 64) == 0 && big_to_decimal(limbs, 0, text, 2) == 1 && strcmp(text, "0") == 0);
+    assert(factorial_big(0, limbs, 64) == 1 && limbs[0] == 1);
+    limbs[0] = 12345;
+    assert(factorial_big(100, limbs, 2) == factorial_big(100, NULL, 0) && limbs[0] == 12345);
+
+    // Sizes large enough for Karatsuba, checked modulo a prime
+    unsigned int n_values[] = {1, 2, 93, 94, 1000, 5000, 20000};
+    for (size_t i = 0; i < sizeof(n_values) / sizeof(n_values[0]); i++) {
+        unsigned int n = n_values[i];
+        size_t capacity = factorial_big_limbs(n);
+        uint32_t* result = (uint32_t*)safe_malloc(capacity * sizeof(uint32_t));
+        count = factorial_big(n, result, capacity);
+        assert(count <= capacity && count > 0 && result[count - 1] != 0);
+        assert(limbs_mod(result, count, big) == factorial_mod(n, big));
+        free(result);
+
+        unsigned int fib_n = n * 5;
+        capacity = fibonacci_big_limbs(fib_n);
+        result = (uint32_t*)safe_malloc(capacity * sizeof(uint32_t));
+        count = fibonacci_big(fib_n, result, capacity);
+        assert(count <= capacity && count > 0 && result[count - 1] != 0);
+        assert(limbs_mod(result, count, big) == fibonacci_mod(fib_n, big));
+        assert(limbs_mod(result, count, p) == fibonacci_mod(fib_n, p));
+        free(result);
+    }
+    printf("20000! has %zu limbs; F(100000) has %zu\n",
+           factorial_big(20000, NULL, 0), fibonacci_big(100000, NULL, 0));
+    printf("✓ All big number tests passed!\n");
+}
+
+// Distance in units in the last place between two finite doubles
+static double ulps_apart(double x, double y) {
+    if (x == y) return 0.0;
+    return fabs(x - y) / fmax(nextafter(fabs(y), INFINITY) - fabs(y), 4.9e-324);
+}
+
+void test_power_functions() {
+    printf("\n=== Testing Power Functions ===\n");
+
+    assert(power(2.0, 10) == 1024.0 && power(2.0, -2) == 0.25 && power(-3.0, 3) == -27.0);
+    assert(power(5.0, 0) == 1.0 && isinf(power(0.0, -1)) && power(2.0, INT_MIN) == 0.0);
+    assert(power(2.0, 1023) == ldexp(1.0, 1023) && isinf(power(2.0, 1024)));
+    assert(power(2.0, -1074) == ldexp(1.0, -1074));          // subnormal, via the overflow path
+
+    // Accuracy against the C library: error grows with log n, not n
+    unsigned int seed = 5;
+    double worst = 0.0;
+    for (int trial = 0; trial < 20000; trial++) {
+        seed = seed * 1103515245u + 12345u;
+        double base = 0.5 + (seed >> 8) / 16777216.0 * 1.5;  // [0.5, 2)
+        seed = seed * 1103515245u + 12345u;
+        int exponent = (int)(seed % 2001) - 1000;
+        double expected = pow(base, exponent);
+        if (expected == 0.0 || isinf(expected) || fabs(expected) < 2.3e-308) continue;
+        double ulps = ulps_apart(power(base, exponent), expected);
+        if (ulps > worst) worst = ulps;
+    }
+    printf("power vs pow: worst error %.1f ulp for |exponent| <= 1000\n", worst);
+    assert(worst <= 1.0);
+
+    // power_array matches power bit for bit at every SIMD level, in place too
+    size_t count = 1003;
+    double* bases = (double*)safe_malloc(count * sizeof(double));
+    double* out = (double*)safe_malloc(count * sizeof(double));
+    int exponents[] = {0, 1, 2, 7, 64, 333, -1, -5, -1074, INT_MAX, INT_MIN};
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        bases[i] = ((int)(seed >> 8) - (1 << 23)) / 4194304.0;  // [-2, 2)
+    }
+    bases[0] = 0.0;
+    bases[1] = 2.0;
+    array_simd_level best = array_simd_detect();
+    for (int level = ARRAY_SIMD_SCALAR; level <= (int)best; level++) {
+        array_simd_select((array_simd_level)level);
+        for (size_t e = 0; e < sizeof(exponents) / sizeof(exponents[0]); e++) {
+            for (size_t size = 0; size <= count; size += size < 40 ? 1 : 321) {
+                power_array(bases, out, size, exponents[e]);
+                for (size_t i = 0; i < size; i++) {
+                    double expected = power(bases[i], exponents[e]);
+                    assert(memcmp(&out[i], &expected, sizeof(double)) == 0);
+                }
+            }
+            memcpy(out, bases, count * sizeof(double));
+            power_array(out, out, count, exponents[e]);
+            for (size_t i = 0; i < count; i++) {
+                double expected = power(bases[i], exponents[e]);
+                assert(memcmp(&out[i], &expected, sizeof(double)) == 0);
+            }
+        }
+    }
+    array_simd_select(best);
+    free(bases);
+    free(out);
+
+    // Modular exponentiation
+    assert(pow_mod(2, 10, 1000) == 24 && pow_mod(3, 0, 7) == 1 && pow_mod(5, 3, 1) == 0);
+    assert(pow_mod(2, 1000000006ULL, 1000000007ULL) == 1);   // Fermat
+    assert(pow_mod(18446744073709551556ULL, 2, 18446744073709551557ULL) == 1);
+    printf("✓ All power tests passed!\n");
+}
+
 void test_string_functions() {
     printf("\n=== Testing String Functions ===\n");
     
@@ -87,6 +335,85 @@ void test_string_functions() {
     printf("✓ All string tests passed!\n");
 }
 
+void test_string_kernels() {
+    printf("\n=== Testing String Kernels ===\n");
+
+    // Mixed text: letters, ASCII whitespace, punctuation and UTF-8
+    const char* pieces[] = {"a", "E", "z", "Q", "@", "[", "`", "{", " ", "\t", "\n", "\r", "\v", "\f",
+                            "\xc3\xa9", "\xc3\x89", "\xe6\x97\xa5", "\xf0\x9f\x98\x80", "\x7f", "0"};
+    size_t max_len = 700;
+    char* text = (char*)safe_malloc(max_len + 8);
+    char* actual = (char*)safe_malloc(max_len + 8);
+    char* expected = (char*)safe_malloc(max_len + 8);
+    unsigned int seed = 9;
+    size_t len = 0;
+    while (len < max_len) {
+        seed = seed * 1103515245u + 12345u;
+        const char* piece = pieces[(seed >> 16) % (sizeof(pieces) / sizeof(pieces[0]))];
+        size_t piece_len = strlen(piece);
+        if (len + piece_len > max_len) break;
+        memcpy(text + len, piece, piece_len);
+        len += piece_len;
+    }
+
+    array_simd_level best = array_simd_detect();
+    for (int level = ARRAY_SIMD_SCALAR; level <= (int)best; level++) {
+        array_simd_select((array_simd_level)level);
+        for (size_t offset = 0; offset < 3; offset++) {
+            for (size_t n = 0; n + offset <= len; n += n < 80 ? 1 : 53) {
+                const char* input = text + offset;
+                size_t vowels = 0, words = 0;
+                bool in_word = false;
+                for (size_t i = 0; i < n; i++) {
+                    unsigned char c = (unsigned char)input[i];
+                    int lower = c < 0x80 ? tolower(c) : c;
+                    vowels += lower == 'a' || lower == 'e' || lower == 'i' || lower == 'o' || lower == 'u';
+                    bool space = c < 0x80 && isspace(c);
+                    words += !space && !in_word;
+                    in_word = !space;
+                }
+                assert(count_vowels_n(input, n) == vowels);
+                assert(count_words_n(input, n) == words);
+
+                memcpy(actual, input, n);
+                string_to_upper_n(actual, n);
+                for (size_t i = 0; i < n; i++) {
+                    unsigned char c = (unsigned char)input[i];
+                    expected[i] = (char)(c < 0x80 ? toupper(c) : c);
+                }
+                assert(memcmp(actual, expected, n) == 0);
+                memcpy(actual, input, n);
+                string_to_lower_n(actual, n);
+                for (size_t i = 0; i < n; i++) {
+                    unsigned char c = (unsigned char)input[i];
+                    expected[i] = (char)(c < 0x80 ? tolower(c) : c);
+                }
+                assert(memcmp(actual, expected, n) == 0);
+            }
+        }
+    }
+    array_simd_select(best);
+
+    // Reversal keeps UTF-8 sequences intact; twice is the identity
+    char utf8[] = "h\xc3\xa9llo \xe6\x97\xa5\xe6\x9c\xac \xf0\x9f\x98\x80!";
+    reverse_string(utf8);
+    assert(strcmp(utf8, "!\xf0\x9f\x98\x80 \xe6\x9c\xac\xe6\x97\xa5 oll\xc3\xa9h") == 0);
+    for (size_t n = 0; n <= len; n += n < 80 ? 1 : 41) {
+        // Cut at a character boundary so the input is valid UTF-8
+        size_t cut = n;
+        while (cut > 0 && cut < len && ((unsigned char)text[cut] & 0xC0) == 0x80) cut--;
+        memcpy(actual, text, cut);
+        reverse_string_n(actual, cut);
+        if (cut > 0) assert(((unsigned char)actual[0] & 0xC0) != 0x80);
+        reverse_string_n(actual, cut);
+        assert(memcmp(actual, text, cut) == 0);
+    }
+    free(text);
+    free(actual);
+    free(expected);
+    printf("✓ All string kernel tests passed!\n");
+}
+
 void test_array_functions() {
     printf("\n=== Testing Array Functions ===\n");
     
@@ -140,6 +467,123 @@ void test_array_functions() {
     printf("✓ All array tests passed!\n");
 }
 
+static int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts a copy with sort_array (or the parallel variant) and with qsort
+static void check_sort(const int* input, size_t size, int threads) {
+    int* actual = (int*)safe_malloc(size * sizeof(int) + 1);
+    int* expected = (int*)safe_malloc(size * sizeof(int) + 1);
+    memcpy(actual, input, size * sizeof(int));
+    memcpy(expected, input, size * sizeof(int));
+    if (threads > 0) sort_array_parallel(actual, size, threads);
+    else sort_array(actual, size);
+    qsort(expected, size, sizeof(int), compare_ints);
+    assert(memcmp(actual, expected, size * sizeof(int)) == 0);
+    free(actual);
+    free(expected);
+}
+
+void test_sort_engine() {
+    printf("\n=== Testing Sort Engine ===\n");
+
+    // Sizes straddle the insertion, introsort, radix and parallel cut-offs
+    size_t sizes[] = {0, 1, 2, 3, 24, 25, 100, 129, 1000, 1023, 1024, 5000, 300000};
+    size_t max_size = 300000;
+    int* input = (int*)safe_malloc(max_size * sizeof(int));
+    unsigned int seed = 7;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t size = sizes[s];
+        for (int shape = 0; shape < 6; shape++) {
+            for (size_t i = 0; i < size; i++) {
+                seed = seed * 1103515245u + 12345u;
+                switch (shape) {
+                    case 0: input[i] = (int)seed; break;                         // random
+                    case 1: input[i] = (int)(seed >> 28);  break;                // many duplicates
+                    case 2: input[i] = (int)i; break;                            // sorted
+                    case 3: input[i] = (int)(size - i); break;                   // reversed
+                    case 4: input[i] = i % 2 ? INT_MIN + (int)i : INT_MAX - (int)i; break;  // extremes
+                    case 5: input[i] = i < size / 2 ? (int)i : (int)(seed % 100); break;    // sorted prefix
+                }
+            }
+            check_sort(input, size, 0);
+            check_sort(input, size, 4);
+        }
+    }
+
+    // Organ pipe and all-equal inputs through the introsort range
+    for (size_t i = 0; i < 1000; i++) input[i] = i < 500 ? (int)i : (int)(1000 - i);
+    check_sort(input, 1000, 0);
+    for (size_t i = 0; i < 1000; i++) input[i] = 42;
+    check_sort(input, 1000, 0);
+    check_sort(input, 1000, 3);
+
+    sort_array(NULL, 10);
+    sort_array_parallel(NULL, 10, 2);
+    free(input);
+    printf("✓ All sort engine tests passed!\n");
+}
+
+void test_simd_reductions() {
+    printf("\n=== Testing SIMD Reductions ===\n");
+
+    size_t max_size = 1000;
+    int* buffer = (int*)safe_malloc((max_size + 16) * sizeof(int));
+    unsigned int seed = 11;
+    array_simd_level best = array_simd_detect();
+    printf("Detected SIMD level: %s\n", array_simd_name(best));
+
+    for (int level = ARRAY_SIMD_SCALAR; level <= (int)best; level++) {
+        assert((int)array_simd_select((array_simd_level)level) == level);
+        for (int shape = 0; shape < 3; shape++) {
+            for (size_t i = 0; i < max_size + 16; i++) {
+                seed = seed * 1103515245u + 12345u;
+                switch (shape) {
+                    case 0: buffer[i] = (int)seed; break;                        // full range
+                    case 1: buffer[i] = (int)(seed % 2001) - 1000; break;         // small values
+                    case 2: buffer[i] = i % 3 ? INT_MAX : INT_MIN; break;        // overflow
+                }
+            }
+            // Every length through several vector widths, at odd alignments
+            for (size_t offset = 0; offset < 4; offset++) {
+                for (size_t size = 1; size <= max_size; size += size < 70 ? 1 : 37) {
+                    const int* arr = buffer + offset;
+                    long long sum = 0;
+                    int lo = arr[0], hi = arr[0];
+                    for (size_t i = 0; i < size; i++) {
+                        sum += arr[i];
+                        if (arr[i] < lo) lo = arr[i];
+                        if (arr[i] > hi) hi = arr[i];
+                    }
+                    assert(sum_array_long(arr, size) == sum);
+                    assert(sum_array(arr, size) == (int)(unsigned int)sum);
+                    assert(find_min(arr, size) == lo);
+                    assert(find_max(arr, size) == hi);
+                    assert(average_array(arr, size) == (double)sum / size);
+
+                    array_stats_t stats = array_stats(arr, size);
+                    assert(stats.sum == sum && stats.min == lo && stats.max == hi);
+                    assert(stats.mean == (double)sum / size);
+                }
+            }
+        }
+        printf("%s: sums, min/max and stats match the scalar reference\n",
+               array_simd_name((array_simd_level)level));
+    }
+    assert(array_simd_select(ARRAY_SIMD_AVX512) == best);
+
+    array_stats_t empty = array_stats(NULL, 5);
+    assert(empty.sum == 0 && empty.min == 0 && empty.max == 0 && empty.mean == 0.0);
+    assert(sum_array_long(buffer, 0) == 0);
+    assert(find_max(NULL, 3) == 0 && find_min(buffer, 0) == 0);
+    free(buffer);
+    printf("✓ All SIMD reduction tests passed!\n");
+}
+
 void test_memory_functions() {
     printf("\n=== Testing Memory Functions ===\n");
     
@@ -164,15 +608,113 @@ void test_memory_functions() {
     printf("✓ All memory tests passed!\n");
 }
 
+void test_arena_allocators() {
+    printf("\n=== Testing Arena and Pool Allocators ===\n");
+    
+    // Bump allocation: aligned, non-overlapping, counted
+    arena_t arena;
+    arena_init(&arena, 1024);
+    char* a = (char*)arena_alloc(&arena, 3);
+    char* b = (char*)arena_alloc(&arena, 40);
+    double* c = (double*)arena_alloc_aligned(&arena, 4 * sizeof(double), 64);
+    assert(((uintptr_t)a & 15) == 0 && ((uintptr_t)b & 15) == 0);
+    assert(((uintptr_t)c & 63) == 0);
+    assert(b >= a + 3 && (char*)c >= b + 40);
+    memset(a, 'a', 3);
+    memset(b, 'b', 40);
+    c[3] = 1.5;
+    assert(a[2] == 'a' && b[39] == 'b' && c[3] == 1.5);
+    assert(arena_bytes_used(&arena) >= 3 + 40 + 32);
+    
+    int* zeros = (int*)arena_calloc(&arena, 50, sizeof(int));
+    for (int i = 0; i < 50; i++) assert(zeros[i] == 0);
+    
+    char* joined = arena_concat(&arena, "Hello, ", "World!");
+    assert(strcmp(joined, "Hello, World!") == 0);
+    assert(strcmp(arena_concat(&arena, NULL, "only"), "only") == 0);
+    assert(arena_concat(&arena, NULL, NULL) == NULL);
+    assert(strcmp(arena_strdup(&arena, "copy"), "copy") == 0);
+    printf("arena: %zu bytes carved from 1 KiB blocks\n", arena_bytes_used(&arena));
+    
+    // Many small allocations span blocks; an oversized one gets its own
+    char* first = NULL;
+    for (int i = 0; i < 1000; i++) {
+        char* p = (char*)arena_alloc(&arena, 24);
+        p[0] = (char)i;
+        p[23] = (char)i;
+        if (i == 0) first = p;
+    }
+    assert(first[0] == 0 && first[23] == 0);
+    char* big = (char*)arena_alloc(&arena, 100000);
+    memset(big, 7, 100000);
+    assert(big[99999] == 7);
+    
+    // Reset recycles the regular blocks: the same sequence lands at the
+    // same addresses
+    struct arena_block* blocks = arena.first;
+    arena_reset(&arena);
+    assert(arena_bytes_used(&arena) == 0);
+    assert(arena.first == blocks && arena.large == NULL);
+    assert(arena_alloc(&arena, 3) == a);
+    arena_destroy(&arena);
+    assert(arena.first == NULL && arena_bytes_used(&arena) == 0);
+    
+    // A zero-initialised arena works without arena_init
+    arena_t lazy = {0};
+    assert(strcmp(arena_strdup(&lazy, "lazy"), "lazy") == 0);
+    arena_destroy(&lazy);
+    
+    // Pool: freed objects are handed out again, last in first out
+    pool_t pool;
+    pool_init(&pool, 12, 8);
+    void* objects[40];
+    for (int i = 0; i < 40; i++) {
+        objects[i] = pool_alloc(&pool);
+        assert(((uintptr_t)objects[i] & (sizeof(void*) - 1)) == 0);
+        memset(objects[i], i, 12);
+    }
+    for (int i = 0; i < 40; i++) {
+        for (int j = 0; j < 12; j++) assert(((unsigned char*)objects[i])[j] == i);
+    }
+    assert(pool_live(&pool) == 40);
+    pool_free(&pool, objects[5]);
+    pool_free(&pool, objects[9]);
+    pool_free(&pool, NULL);
+    assert(pool_live(&pool) == 38);
+    assert(pool_alloc(&pool) == objects[9]);
+    assert(pool_alloc(&pool) == objects[5]);
+    pool_reset(&pool);
+    assert(pool_live(&pool) == 0);
+    assert(pool_alloc(&pool) == objects[0]);
+    pool_destroy(&pool);
+    
+    pool_t wide;
+    pool_init(&wide, 32, 0);
+    void* w1 = pool_alloc(&wide);
+    void* w2 = pool_alloc(&wide);
+    assert(((uintptr_t)w1 & 15) == 0 && ((uintptr_t)w2 & 15) == 0);
+    pool_destroy(&wide);
+    printf("pool: 40 objects of 12 bytes, reuse and reset verified\n");
+    
+    printf("✓ All allocator tests passed!\n");
+}
+
 int main() {
     printf("\n╔════════════════════════════════════╗\n");
     printf("║   C Utilities Test Suite v2.0      ║\n");
     printf("╚════════════════════════════════════╝\n");
     
     test_math_functions();
+    test_primality();
+    test_big_numbers();
+    test_power_functions();
     test_string_functions();
+    test_string_kernels();
     test_array_functions();
+    test_sort_engine();
+    test_simd_reductions();
     test_memory_functions();
+    test_arena_allocators();
     
     printf("\n╔════════════════════════════════════╗\n");
     printf("║   ✓ ALL TESTS PASSED!              ║\n");
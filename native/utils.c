@@ -3,63 +3,338 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define UTILS_X86 1
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 // ============ Mathematical Utilities ============
 
+// Overflowing results wrap (unsigned arithmetic, so no undefined behaviour)
+
 int factorial(int n) {
     if (n < 0) return -1;
-    if (n <= 1) return 1;
-    return n * factorial(n - 1);
+    return (int)(unsigned int)factorial_long(n);
 }
 
 long long factorial_long(int n) {
     if (n < 0) return -1;
-    if (n <= 1) return 1;
-    long long result = 1;
+    unsigned long long result = 1;
     for (int i = 2; i <= n; i++) {
-        result *= i;
+        result *= (unsigned long long)i;
     }
-    return result;
+    return (long long)result;
+}
+
+// F(n) mod 2^64 by fast doubling:
+//   F(2k) = F(k) * (2F(k+1) - F(k)),  F(2k+1) = F(k)^2 + F(k+1)^2
+// The identities hold modulo 2^64, so this wraps exactly like the
+// iterative sum did.
+static unsigned long long fibonacci_u64(unsigned int n) {
+    unsigned long long a = 0, b = 1;          // F(k), F(k+1) with k = 0
+    for (int bit = 31; bit >= 0; bit--) {
+        unsigned long long even = a * (2 * b - a);
+        unsigned long long odd = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = odd;
+            b = even + odd;
+        } else {
+            a = even;
+            b = odd;
+        }
+    }
+    return a;
 }
 
 int fibonacci(int n) {
     if (n < 0) return -1;
-    if (n <= 1) return n;
-    
-    int a = 0, b = 1, temp;
-    for (int i = 2; i <= n; i++) {
-        temp = a + b;
-        a = b;
-        b = temp;
-    }
-    return b;
+    return (int)(unsigned int)fibonacci_u64((unsigned int)n);
 }
 
 long long fibonacci_long(int n) {
     if (n < 0) return -1;
-    if (n <= 1) return n;
-    
-    long long a = 0, b = 1, temp;
-    for (int i = 2; i <= n; i++) {
-        temp = a + b;
-        a = b;
-        b = temp;
-    }
-    return b;
+    return (long long)fibonacci_u64((unsigned int)n);
 }
 
 bool is_prime(int n) {
     if (n <= 1) return false;
-    if (n <= 3) return true;
-    if (n % 2 == 0 || n % 3 == 0) return false;
-    
-    for (int i = 5; i * i <= n; i += 6) {
-        if (n % i == 0 || n % (i + 2) == 0)
-            return false;
+    return is_prime_u64((unsigned long long)n);
+}
+
+// ============ Primality ============
+
+// Primes up to 37: trial divisors, and together the Miller-Rabin bases that
+// are deterministic for every 64-bit n
+static const unsigned int small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+#define SMALL_PRIME_COUNT (sizeof(small_primes) / sizeof(small_primes[0]))
+
+// Numbers per sieve segment: 32 KiB of bitmap, so a segment stays in L1
+#define SIEVE_SEGMENT_BITS (32 * 1024 * 8)
+// Above this the base primes (up to sqrt(high)) no longer fit a small
+// table, and ranges are tested number by number
+#define SIEVE_MAX_HIGH (1ULL << 52)
+// Widest value range is_prime_batch sieves instead of testing each value
+#define BATCH_SIEVE_LIMIT (1ULL << 25)
+
+static unsigned long long mulmod_u64(unsigned long long a, unsigned long long b,
+                                     unsigned long long m) {
+#if defined(__SIZEOF_INT128__)
+    return (unsigned long long)((unsigned __int128)a * b % m);
+#else
+    // Double and add; every step stays below m, so nothing overflows
+    unsigned long long result = 0;
+    a %= m;
+    while (b) {
+        if (b & 1) result = result >= m - a ? result - (m - a) : result + a;
+        a = a >= m - a ? a - (m - a) : a + a;
+        b >>= 1;
+    }
+    return result;
+#endif
+}
+
+static unsigned long long powmod_u64(unsigned long long base, unsigned long long exp,
+                                     unsigned long long m) {
+    unsigned long long result = 1;
+    base %= m;
+    while (exp) {
+        if (exp & 1) result = mulmod_u64(result, base, m);
+        base = mulmod_u64(base, base, m);
+        exp >>= 1;
+    }
+    return result;
+}
+
+// One Miller-Rabin round: n - 1 = d * 2^s with d odd
+static bool passes_round(unsigned long long n, unsigned long long d, int s, unsigned long long a) {
+    unsigned long long x = powmod_u64(a, d, n);
+    if (x == 1 || x == n - 1) return true;
+    for (int r = 1; r < s; r++) {
+        x = mulmod_u64(x, x, n);
+        if (x == n - 1) return true;
+    }
+    return false;
+}
+
+bool is_prime_u64(unsigned long long n) {
+    for (size_t i = 0; i < SMALL_PRIME_COUNT; i++) {
+        if (n == small_primes[i]) return true;
+        if (n % small_primes[i] == 0) return false;
+    }
+    // No factor up to 37, so below 41^2 it is prime (or 0/1)
+    if (n < 41 * 41) return n > 1;
+
+    unsigned long long d = n - 1;
+    int s = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        s++;
+    }
+    // Bases {2, 7, 61} suffice below 2^32; the first twelve primes for
+    // everything else
+    if (n < (1ULL << 32)) {
+        return passes_round(n, d, s, 2) && passes_round(n, d, s, 7) && passes_round(n, d, s, 61);
+    }
+    for (size_t i = 0; i < SMALL_PRIME_COUNT; i++) {
+        if (!passes_round(n, d, s, small_primes[i])) return false;
     }
     return true;
 }
 
+static unsigned long long isqrt_u64(unsigned long long n) {
+    unsigned long long root = 0;
+    for (unsigned long long bit = 1ULL << 62; bit; bit >>= 2) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+// Odd primes up to `limit` (simple sieve over odd numbers). Returns NULL
+// with *count 0 when there are none or allocation fails.
+static unsigned int* odd_primes_upto(unsigned int limit, size_t* count) {
+    *count = 0;
+    if (limit < 3) return NULL;
+    size_t slots = (size_t)(limit - 1) / 2;          // slot k is 2k + 3
+    unsigned char* composite = (unsigned char*)calloc(slots, 1);
+    unsigned int* primes = (unsigned int*)malloc(slots * sizeof(unsigned int));
+    if (!composite || !primes) {
+        free(composite);
+        free(primes);
+        return NULL;
+    }
+    for (size_t k = 0; k < slots; k++) {
+        if (composite[k]) continue;
+        unsigned long long p = 2 * k + 3;
+        primes[(*count)++] = (unsigned int)p;
+        for (unsigned long long m = p * p; m <= limit; m += 2 * p) {
+            composite[(m - 3) / 2] = 1;
+        }
+    }
+    free(composite);
+    return primes;
+}
+
+static size_t popcount_bytes(const unsigned char* bytes, size_t length) {
+    size_t total = 0;
+    for (size_t i = 0; i < length; i++) {
+#if defined(__GNUC__)
+        total += (size_t)__builtin_popcount(bytes[i]);
+#else
+        for (unsigned char b = bytes[i]; b; b &= (unsigned char)(b - 1)) total++;
+#endif
+    }
+    return total;
+}
+
+size_t prime_sieve_range(unsigned long long low, unsigned long long high, unsigned char* bitmap) {
+    if (!bitmap || high <= low) return 0;
+    unsigned long long width = high - low;
+    size_t bytes = (size_t)((width + 7) / 8);
+    unsigned long long root = high > SIEVE_MAX_HIGH ? 0 : isqrt_u64(high - 1);
+
+    // Huge numbers, or a window narrow next to sqrt(high): testing each odd
+    // number beats generating the base primes
+    if (high > SIEVE_MAX_HIGH || width * 16 < root) {
+        memset(bitmap, 0, bytes);
+        for (unsigned long long i = 0; i < width; i++) {
+            if (is_prime_u64(low + i)) bitmap[i / 8] |= (unsigned char)(1u << (i % 8));
+        }
+        return popcount_bytes(bitmap, bytes);
+    }
+
+    size_t prime_count;
+    unsigned int* primes = odd_primes_upto((unsigned int)root, &prime_count);
+    unsigned long long* next = (unsigned long long*)malloc((prime_count + 1) * sizeof(unsigned long long));
+    if (!next || (root >= 3 && !primes)) {
+        free(primes);
+        free(next);
+        return 0;
+    }
+    // First odd multiple of each base prime that is >= max(p^2, low)
+    for (size_t j = 0; j < prime_count; j++) {
+        unsigned long long p = primes[j];
+        unsigned long long start = p * p;
+        if (start < low) start = (low + p - 1) / p * p;
+        if ((start & 1) == 0) start += p;
+        next[j] = start;
+    }
+
+    // Bit i is number low + i: keep only odd numbers to begin with
+    unsigned char odd_mask = (low & 1) ? 0x55 : 0xAA;
+    for (unsigned long long seg = 0; seg < width; seg += SIEVE_SEGMENT_BITS) {
+        unsigned long long seg_end = seg + SIEVE_SEGMENT_BITS < width ? seg + SIEVE_SEGMENT_BITS : width;
+        unsigned char* block = bitmap + seg / 8;
+        memset(block, odd_mask, (size_t)((seg_end - seg + 7) / 8));
+        unsigned long long end_value = low + seg_end;
+        for (size_t j = 0; j < prime_count; j++) {
+            unsigned long long step = 2ULL * primes[j];
+            unsigned long long m = next[j];
+            for (; m < end_value; m += step) {
+                unsigned long long i = m - low;
+                bitmap[i / 8] &= (unsigned char)~(1u << (i % 8));
+            }
+            next[j] = m;
+        }
+    }
+    free(primes);
+    free(next);
+
+    // The odd mask got 1 and 2 wrong, and bits past the end are padding
+    if (low <= 1 && 1 < high) bitmap[(1 - low) / 8] &= (unsigned char)~(1u << ((1 - low) % 8));
+    if (low <= 2 && 2 < high) bitmap[(2 - low) / 8] |= (unsigned char)(1u << ((2 - low) % 8));
+    if (width % 8) bitmap[bytes - 1] &= (unsigned char)((1u << (width % 8)) - 1);
+    return popcount_bytes(bitmap, bytes);
+}
+
+static unsigned long long addmod_u64(unsigned long long a, unsigned long long b,
+                                     unsigned long long m) {
+    return a >= m - b ? a - (m - b) : a + b;
+}
+
+static unsigned long long submod_u64(unsigned long long a, unsigned long long b,
+                                     unsigned long long m) {
+    return a >= b ? a - b : a + (m - b);
+}
+
+unsigned long long factorial_mod(unsigned long long n, unsigned long long modulus) {
+    if (modulus <= 1 || n >= modulus) return 0;
+    unsigned long long result = 1;
+    for (unsigned long long k = 2; k <= n; k++) {
+        result = mulmod_u64(result, k, modulus);
+    }
+    return result;
+}
+
+unsigned long long fibonacci_mod(unsigned long long n, unsigned long long modulus) {
+    if (modulus <= 1) return 0;
+    unsigned long long a = 0, b = 1;          // F(k), F(k+1) mod modulus
+    for (int bit = 63; bit >= 0; bit--) {
+        unsigned long long twice_b = addmod_u64(b, b, modulus);
+        unsigned long long even = mulmod_u64(a, submod_u64(twice_b, a, modulus), modulus);
+        unsigned long long odd = addmod_u64(mulmod_u64(a, a, modulus), mulmod_u64(b, b, modulus), modulus);
+        if ((n >> bit) & 1) {
+            a = odd;
+            b = addmod_u64(even, odd, modulus);
+        } else {
+            a = even;
+            b = odd;
+        }
+    }
+    return a;
+}
+
+void is_prime_batch(const long long* values, size_t count, unsigned char* bitmap) {
+    if (!values || !bitmap || count == 0) return;
+    size_t bytes = (count + 7) / 8;
+    memset(bitmap, 0, bytes);
+
+    // Range of the candidates (values below 2 are never prime)
+    unsigned long long lo = ~0ULL, hi = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (values[i] < 2) continue;
+        unsigned long long v = (unsigned long long)values[i];
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+
+    // Sieving the range costs about (hi - lo) / 8 bytes of work; worth it
+    // once the batch is dense enough in that range to amortise it
+    unsigned char* table = NULL;
+    if (lo <= hi) {
+        unsigned long long span = hi - lo + 1;
+        if (span < BATCH_SIEVE_LIMIT && span <= (unsigned long long)count * 256 && hi < SIEVE_MAX_HIGH) {
+            table = (unsigned char*)malloc((size_t)((span + 7) / 8));
+            if (table) prime_sieve_range(lo, hi + 1, table);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        long long v = values[i];
+        bool prime;
+        if (v < 2) prime = false;
+        else if (table) {
+            unsigned long long k = (unsigned long long)v - lo;
+            prime = (table[k / 8] >> (k % 8)) & 1;
+        } else prime = is_prime_u64((unsigned long long)v);
+        if (prime) bitmap[i / 8] |= (unsigned char)(1u << (i % 8));
+    }
+    free(table);
+}
+
 int gcd(int a, int b) {
     a = abs(a);
     b = abs(b);
@@ -76,35 +351,625 @@ int lcm(int a, int b) {
     return abs(a * b) / gcd(a, b);
 }
 
-double power(double base, int exponent) {
-    if (exponent == 0) return 1.0;
-    if (exponent < 0) {
-        base = 1.0 / base;
-        exponent = -exponent;
-    }
-    
+// Veltkamp splitting constant, 2^27 + 1
+#define DD_SPLITTER 134217729.0
+
+// (rh, rl) *= (xh, xl) in double-double arithmetic. The product of the
+// high parts is made exact with Dekker's TwoProduct rather than an FMA, so
+// every target (and every SIMD lane) rounds identically.
+static inline void dd_mul(double* rh, double* rl, double xh, double xl) {
+    double a = *rh, b = xh;
+    double p = a * b;
+    double ca = DD_SPLITTER * a, ah = ca - (ca - a), al = a - ah;
+    double cb = DD_SPLITTER * b, bh = cb - (cb - b), bl = b - bh;
+    double e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    e += a * xl + *rl * b;
+    *rh = p + e;
+    *rl = e - (*rh - p);
+}
+
+static double power_plain(double base, unsigned int n) {
     double result = 1.0;
-    for (int i = 0; i < exponent; i++) {
-        result *= base;
+    while (n) {
+        if (n & 1) result *= base;
+        n >>= 1;
+        if (n) base *= base;
     }
     return result;
 }
 
+// base^n by squaring, carried in double-double: O(log n) steps, and the
+// error from each squaring (which the following squarings would double)
+// stays below 2^-100, so the result is within about half an ulp. Near
+// overflow the splitting produces inf - inf; those fall back to plain
+// squaring, which gives the right inf or large value.
+static double power_unsigned(double base, unsigned int n) {
+    double rh = 1.0, rl = 0.0, xh = base, xl = 0.0;
+    for (unsigned int e = n; e;) {
+        if (e & 1) dd_mul(&rh, &rl, xh, xl);
+        e >>= 1;
+        if (e) dd_mul(&xh, &xl, xh, xl);
+    }
+    return rh == rh ? rh : power_plain(base, n);
+}
+
+static unsigned int exponent_magnitude(int exponent) {
+    return exponent < 0 ? 0u - (unsigned int)exponent : (unsigned int)exponent;
+}
+
+// base^-n from r = base^n: 1/r rounds once, unlike squaring 1/base. When
+// r overflowed, the true result may still be a nonzero subnormal.
+static double power_reciprocal(double base, double r, unsigned int n) {
+    return isinf(r) ? power_unsigned(1.0 / base, n) : 1.0 / r;
+}
+
+double power(double base, int exponent) {
+    unsigned int n = exponent_magnitude(exponent);
+    double result = power_unsigned(base, n);
+    return exponent < 0 ? power_reciprocal(base, result, n) : result;
+}
+
+unsigned long long pow_mod(unsigned long long base, unsigned long long exponent,
+                           unsigned long long modulus) {
+    if (modulus <= 1) return 0;
+    return powmod_u64(base, exponent, modulus);
+}
+
+// ============ Big Numbers ============
+// Little-endian 32-bit limbs. Functions return normalised lengths (no high
+// zero limbs; zero has length 0) unless noted.
+
+// Below this many limbs schoolbook multiplication beats Karatsuba
+#define KARATSUBA_THRESHOLD 32
+
+static size_t big_trim(const uint32_t* a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) n--;
+    return n;
+}
+
+// out = a + b; out has room for max(na, nb) + 1 limbs and may alias a or b
+static size_t big_add(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    if (na < nb) {
+        const uint32_t* t = a; a = b; b = t;
+        size_t tn = na; na = nb; nb = tn;
+    }
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < nb; i++) {
+        carry += (uint64_t)a[i] + b[i];
+        out[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    for (; i < na; i++) {
+        carry += a[i];
+        out[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    out[na] = (uint32_t)carry;
+    return big_trim(out, na + 1);
+}
+
+// a -= b in place, for a >= b
+static size_t big_sub_in(uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < na && (i < nb || borrow); i++) {
+        uint64_t d = (uint64_t)a[i] - (i < nb ? b[i] : 0) - borrow;
+        a[i] = (uint32_t)d;
+        borrow = d >> 63;
+    }
+    return big_trim(a, na);
+}
+
+// a += b in place, where a has na limbs and the sum fits in them
+static void big_add_in(uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < na && (i < nb || carry); i++) {
+        carry += (uint64_t)a[i] + (i < nb ? b[i] : 0);
+        a[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+}
+
+// a *= k in place; a has room for n + 1 limbs
+static size_t big_mul_small(uint32_t* a, size_t n, uint32_t k) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry += (uint64_t)a[i] * k;
+        a[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    a[n] = (uint32_t)carry;
+    return big_trim(a, n + 1);
+}
+
+static void big_mul_basic(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    memset(out, 0, (na + nb) * sizeof(uint32_t));
+    for (size_t i = 0; i < na; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < nb; j++) {
+            carry += (uint64_t)a[i] * b[j] + out[i + j];
+            out[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        out[i + nb] = (uint32_t)carry;
+    }
+}
+
+// out = a * b, all na + nb limbs written (not trimmed); out must not alias
+static void big_mul(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    if (na < nb) {
+        const uint32_t* t = a; a = b; b = t;
+        size_t tn = na; na = nb; nb = tn;
+    }
+    if (nb < KARATSUBA_THRESHOLD) {
+        big_mul_basic(a, na, b, nb, out);
+        return;
+    }
+    if (2 * nb <= na) {
+        // Lopsided: multiply b by nb-limb slices of a so each product is
+        // balanced
+        memset(out, 0, (na + nb) * sizeof(uint32_t));
+        uint32_t* part = (uint32_t*)safe_malloc(2 * nb * sizeof(uint32_t));
+        for (size_t i = 0; i < na; i += nb) {
+            size_t len = na - i < nb ? na - i : nb;
+            big_mul(a + i, len, b, nb, part);
+            big_add_in(out + i, na + nb - i, part, len + nb);
+        }
+        free(part);
+        return;
+    }
+
+    // Karatsuba with a = a1 * B^m + a0, b = b1 * B^m + b0 (nb > m):
+    // a * b = z2 * B^2m + (z1 - z2 - z0) * B^m + z0, z1 = (a0 + a1)(b0 + b1)
+    size_t m = na / 2;
+    size_t na1 = na - m, nb1 = nb - m;
+    big_mul(a, m, b, m, out);                           // z0 -> out[0, 2m)
+    big_mul(a + m, na1, b + m, nb1, out + 2 * m);       // z2 -> out[2m, na + nb)
+
+    size_t room_a = na1 + 1;
+    size_t room_b = (nb1 > m ? nb1 : m) + 1;
+    uint32_t* sums = (uint32_t*)safe_malloc((room_a + room_b) * sizeof(uint32_t));
+    uint32_t* sum_a = sums;
+    uint32_t* sum_b = sums + room_a;
+    size_t len_a = big_add(a, big_trim(a, m), a + m, big_trim(a + m, na1), sum_a);
+    size_t len_b = big_add(b, big_trim(b, m), b + m, big_trim(b + m, nb1), sum_b);
+
+    uint32_t* z1 = (uint32_t*)safe_malloc((len_a + len_b + 1) * sizeof(uint32_t));
+    big_mul(sum_a, len_a, sum_b, len_b, z1);
+    size_t len_z1 = big_trim(z1, len_a + len_b);
+    len_z1 = big_sub_in(z1, len_z1, out, big_trim(out, 2 * m));
+    len_z1 = big_sub_in(z1, len_z1, out + 2 * m, big_trim(out + 2 * m, na1 + nb1));
+    big_add_in(out + m, na + nb - m, z1, len_z1);
+    free(z1);
+    free(sums);
+}
+
+static unsigned int bit_length(uint32_t v) {
+    unsigned int bits = 0;
+    while (v) {
+        bits++;
+        v >>= 1;
+    }
+    return bits;
+}
+
+// lo * (lo + 1) * ... * hi as a new allocation, splitting the range in
+// halves so the big multiplications are between similar sizes
+static uint32_t* product_range(uint32_t lo, uint32_t hi, size_t* length) {
+    if (hi - lo < 32) {
+        uint32_t* out = (uint32_t*)safe_malloc((hi - lo + 2) * sizeof(uint32_t));
+        size_t n = 1;
+        out[0] = 1;
+        for (uint32_t k = lo;; k++) {
+            n = big_mul_small(out, n, k);
+            if (k == hi) break;
+        }
+        *length = n;
+        return out;
+    }
+    uint32_t mid = lo + (hi - lo) / 2;
+    size_t left_length, right_length;
+    uint32_t* left = product_range(lo, mid, &left_length);
+    uint32_t* right = product_range(mid + 1, hi, &right_length);
+    uint32_t* out = (uint32_t*)safe_malloc((left_length + right_length) * sizeof(uint32_t));
+    big_mul(left, left_length, right, right_length, out);
+    free(left);
+    free(right);
+    *length = big_trim(out, left_length + right_length);
+    return out;
+}
+
+size_t factorial_big_limbs(unsigned int n) {
+    // log2(n!) <= sum of the bit lengths of 2..n, counted per bit length
+    unsigned long long bits = 1;
+    for (unsigned int length = 2; length <= 32; length++) {
+        unsigned long long first = 1ULL << (length - 1);
+        unsigned long long last = (1ULL << length) - 1;
+        if (first > n) break;
+        if (last > n) last = n;
+        bits += (last - first + 1) * length;
+    }
+    return (size_t)(bits / 32 + 1);
+}
+
+size_t factorial_big(unsigned int n, uint32_t* limbs, size_t capacity) {
+    if (n <= 1) {
+        if (limbs && capacity >= 1) limbs[0] = 1;
+        return 1;
+    }
+    size_t length;
+    uint32_t* product = product_range(2, n, &length);
+    if (limbs && length <= capacity) {
+        memcpy(limbs, product, length * sizeof(uint32_t));
+    }
+    free(product);
+    return length;
+}
+
+size_t fibonacci_big_limbs(unsigned int n) {
+    // F(n) < phi^n and log2(phi) < 0.7
+    unsigned long long bits = (unsigned long long)n * 7 / 10 + 1;
+    return (size_t)(bits / 32 + 1);
+}
+
+size_t fibonacci_big(unsigned int n, uint32_t* limbs, size_t capacity) {
+    // Same doubling as fibonacci_u64. Every intermediate is at most
+    // F(n + 1) <= 2F(n), and products get twice that before trimming.
+    size_t room = 2 * (fibonacci_big_limbs(n) + 1) + 2;
+    uint32_t* buffers = (uint32_t*)safe_malloc(6 * room * sizeof(uint32_t));
+    uint32_t* a = buffers;                  // F(k)
+    uint32_t* b = buffers + room;           // F(k + 1)
+    uint32_t* t = buffers + 2 * room;
+    uint32_t* even = buffers + 3 * room;
+    uint32_t* odd = buffers + 4 * room;
+    uint32_t* square = buffers + 5 * room;
+    size_t na = 0, nb = 1;
+    b[0] = 1;
+
+    int top = (int)bit_length(n) - 1;
+    for (int bit = top; bit >= 0; bit--) {
+        // even = F(k) * (2F(k+1) - F(k)), odd = F(k)^2 + F(k+1)^2
+        size_t nt = big_add(b, nb, b, nb, t);
+        nt = big_sub_in(t, nt, a, na);
+        big_mul(a, na, t, nt, even);
+        size_t n_even = big_trim(even, na + nt);
+        big_mul(a, na, a, na, odd);
+        big_mul(b, nb, b, nb, square);
+        size_t n_odd = big_add(odd, big_trim(odd, 2 * na), square, big_trim(square, 2 * nb), odd);
+
+        uint32_t* spare = a;
+        if ((n >> bit) & 1) {
+            a = odd;
+            na = n_odd;
+            nb = big_add(even, n_even, odd, n_odd, b);
+            odd = spare;
+        } else {
+            uint32_t* old_b = b;
+            a = even;
+            na = n_even;
+            b = odd;
+            nb = n_odd;
+            even = spare;
+            odd = old_b;
+        }
+    }
+
+    if (limbs && na <= capacity) {
+        memcpy(limbs, a, na * sizeof(uint32_t));
+    }
+    free(buffers);
+    return na;
+}
+
+size_t big_to_decimal(const uint32_t* limbs, size_t count, char* buffer, size_t capacity) {
+    count = limbs ? big_trim(limbs, count) : 0;
+    if (count == 0) {
+        if (buffer && capacity > 1) {
+            buffer[0] = '0';
+            buffer[1] = '\0';
+        }
+        return 1;
+    }
+
+    // Peel off base 10^9 chunks, least significant first
+    uint32_t* work = (uint32_t*)safe_malloc(count * sizeof(uint32_t));
+    uint32_t* chunks = (uint32_t*)safe_malloc((count * 32 / 29 + 2) * sizeof(uint32_t));
+    memcpy(work, limbs, count * sizeof(uint32_t));
+    size_t n_chunks = 0;
+    while (count > 0) {
+        uint64_t remainder = 0;
+        for (size_t i = count; i-- > 0;) {
+            uint64_t current = (remainder << 32) | work[i];
+            work[i] = (uint32_t)(current / 1000000000u);
+            remainder = current % 1000000000u;
+        }
+        chunks[n_chunks++] = (uint32_t)remainder;
+        count = big_trim(work, count);
+    }
+
+    char top[16];
+    int top_digits = snprintf(top, sizeof(top), "%u", (unsigned int)chunks[n_chunks - 1]);
+    size_t digits = (size_t)top_digits + (n_chunks - 1) * 9;
+    if (buffer && capacity > digits) {
+        memcpy(buffer, top, (size_t)top_digits);
+        char* out = buffer + top_digits;
+        for (size_t c = n_chunks - 1; c-- > 0;) {
+            uint32_t chunk = chunks[c];
+            for (int d = 8; d >= 0; d--) {
+                out[d] = (char)('0' + chunk % 10);
+                chunk /= 10;
+            }
+            out += 9;
+        }
+        *out = '\0';
+    }
+    free(work);
+    free(chunks);
+    return digits;
+}
+
 // ============ String Utilities ============
 
-void reverse_string(char* str) {
-    if (str == NULL) return;
-    
-    int len = strlen(str);
-    for (int i = 0; i < len / 2; i++) {
+// The *_n variants take an explicit length and only ever change or count
+// ASCII bytes, so UTF-8 text passes through intact. On x86 they work 16
+// (SSE2) or 32 (AVX2) bytes per step; the tails, and other targets, use
+// the scalar loops. The level follows array_simd_select.
+
+typedef struct {
+    void (*change_case)(char* str, size_t len, char first, char flip);
+    size_t (*vowels)(const char* str, size_t len);
+    size_t (*word_starts)(const char* str, size_t len, bool after_space);
+} string_kernels;
+
+static int simd_level(void);
+
+static bool ascii_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Flips bit 0x20 of every byte in [first, first + 26)
+static void scalar_change_case(char* str, size_t len, char first, char flip) {
+    for (size_t i = 0; i < len; i++) {
+        if ((unsigned char)(str[i] - first) < 26) str[i] ^= flip;
+    }
+}
+
+static size_t scalar_vowels(const char* str, size_t len) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        char c = (char)(str[i] | 0x20);
+        count += c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u';
+    }
+    return count;
+}
+
+// Non-space bytes preceded by a space (or, for the first byte, by
+// `after_space`)
+static size_t scalar_word_starts(const char* str, size_t len, bool after_space) {
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        bool space = ascii_space((unsigned char)str[i]);
+        count += !space && after_space;
+        after_space = space;
+    }
+    return count;
+}
+
+#ifdef UTILS_X86
+
+// Byte lanes in [first, first + 26), using signed compares: shifting
+// `first` to -128 leaves the range as the 26 smallest values
+__attribute__((target("sse2")))
+static inline __m128i sse2_in_range(__m128i v, char first, char width) {
+    __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(-128 - first)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(-128 + width)));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i sse2_vowel_mask(__m128i v) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i mask = _mm_cmpeq_epi8(lower, _mm_set1_epi8('a'));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(lower, _mm_set1_epi8('e')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(lower, _mm_set1_epi8('i')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(lower, _mm_set1_epi8('o')));
+    return _mm_or_si128(mask, _mm_cmpeq_epi8(lower, _mm_set1_epi8('u')));
+}
+
+__attribute__((target("sse2")))
+static inline unsigned int sse2_space_bits(__m128i v) {
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), sse2_in_range(v, '\t', 5));
+    return (unsigned int)_mm_movemask_epi8(space);
+}
+
+__attribute__((target("sse2")))
+static void sse2_change_case(char* str, size_t len, char first, char flip) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i hit = sse2_in_range(v, first, 26);
+        v = _mm_xor_si128(v, _mm_and_si128(hit, _mm_set1_epi8(flip)));
+        _mm_storeu_si128((__m128i*)(str + i), v);
+    }
+    scalar_change_case(str + i, len - i, first, flip);
+}
+
+// Byte counters take -1 per hit and are widened with psadbw before they
+// can wrap (255 steps)
+__attribute__((target("sse2")))
+static size_t sse2_vowels(const char* str, size_t len) {
+    size_t i = 0, count = 0;
+    while (i + 16 <= len) {
+        __m128i counters = _mm_setzero_si128();
+        for (int step = 0; step < 255 && i + 16 <= len; step++, i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(str + i));
+            counters = _mm_sub_epi8(counters, sse2_vowel_mask(v));
+        }
+        __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        count += (size_t)_mm_cvtsi128_si32(sums) + (size_t)_mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+    }
+    return count + scalar_vowels(str + i, len - i);
+}
+
+__attribute__((target("sse2")))
+static size_t sse2_word_starts(const char* str, size_t len, bool after_space) {
+    size_t i = 0, count = 0;
+    unsigned int carry = after_space;
+    for (; i + 16 <= len; i += 16) {
+        unsigned int space = sse2_space_bits(_mm_loadu_si128((const __m128i*)(str + i)));
+        unsigned int starts = ~space & ((space << 1) | carry) & 0xFFFFu;
+        count += (size_t)__builtin_popcount(starts);
+        carry = space >> 15;
+    }
+    return count + scalar_word_starts(str + i, len - i, carry);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_in_range(__m256i v, char first, char width) {
+    __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8((char)(-128 - first)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + width)), shifted);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_vowel_mask(__m256i v) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i mask = _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('a'));
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('e')));
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('i')));
+    mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('o')));
+    return _mm256_or_si256(mask, _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('u')));
+}
+
+__attribute__((target("avx2")))
+static void avx2_change_case(char* str, size_t len, char first, char flip) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(str + i));
+        __m256i hit = avx2_in_range(v, first, 26);
+        v = _mm256_xor_si256(v, _mm256_and_si256(hit, _mm256_set1_epi8(flip)));
+        _mm256_storeu_si256((__m256i*)(str + i), v);
+    }
+    sse2_change_case(str + i, len - i, first, flip);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_vowels(const char* str, size_t len) {
+    size_t i = 0, count = 0;
+    while (i + 32 <= len) {
+        __m256i counters = _mm256_setzero_si256();
+        for (int step = 0; step < 255 && i + 32 <= len; step++, i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(str + i));
+            counters = _mm256_sub_epi8(counters, avx2_vowel_mask(v));
+        }
+        long long lanes[4];
+        _mm256_storeu_si256((__m256i*)lanes, _mm256_sad_epu8(counters, _mm256_setzero_si256()));
+        count += (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+    return count + sse2_vowels(str + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_word_starts(const char* str, size_t len, bool after_space) {
+    size_t i = 0, count = 0;
+    unsigned long long carry = after_space;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(str + i));
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                        avx2_in_range(v, '\t', 5));
+        unsigned long long bits = (unsigned int)_mm256_movemask_epi8(space);
+        unsigned long long starts = ~bits & ((bits << 1) | carry) & 0xFFFFFFFFull;
+        count += (size_t)__builtin_popcountll(starts);
+        carry = bits >> 31;
+    }
+    return count + sse2_word_starts(str + i, len - i, carry != 0);
+}
+
+#endif // UTILS_X86
+
+// Indexed by array_simd_level; AVX-512 reuses the AVX2 kernels
+static const string_kernels string_kernel_table[] = {
+    {scalar_change_case, scalar_vowels, scalar_word_starts},
+#ifdef UTILS_X86
+    {sse2_change_case, sse2_vowels, sse2_word_starts},
+    {avx2_change_case, avx2_vowels, avx2_word_starts},
+    {avx2_change_case, avx2_vowels, avx2_word_starts},
+#endif
+};
+
+static const string_kernels* string_kernels_for_level(void) {
+    return &string_kernel_table[simd_level()];
+}
+
+static uint64_t swap_bytes64(uint64_t v) {
+#if defined(__GNUC__)
+    return __builtin_bswap64(v);
+#else
+    v = ((v & 0x00FF00FF00FF00FFull) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFull);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+    return (v << 32) | (v >> 32);
+#endif
+}
+
+// Reverses bytes, then puts each multi-byte UTF-8 sequence (now a run of
+// continuation bytes followed by its lead byte) back in order. Malformed
+// sequences are left byte-reversed.
+void reverse_string_n(char* str, size_t len) {
+    if (!str || len < 2) return;
+    size_t i = 0, j = len;
+    bool ascii = true;
+    while (j - i >= 16) {
+        uint64_t front, back;
+        memcpy(&front, str + i, 8);
+        memcpy(&back, str + j - 8, 8);
+        ascii = ascii && ((front | back) & 0x8080808080808080ull) == 0;
+        front = swap_bytes64(front);
+        back = swap_bytes64(back);
+        memcpy(str + i, &back, 8);
+        memcpy(str + j - 8, &front, 8);
+        i += 8;
+        j -= 8;
+    }
+    for (size_t k = i; k < j; k++) ascii = ascii && (unsigned char)str[k] < 0x80;
+    while (j - i >= 2) {
         char temp = str[i];
-        str[i] = str[len - i - 1];
-        str[len - i - 1] = temp;
+        str[i++] = str[--j];
+        str[j] = temp;
     }
+    if (ascii) return;
+
+    for (size_t k = 0; k < len; k++) {
+        // Skip eight bytes at a time while none is a continuation byte
+        // (10xxxxxx: bit 7 set, bit 6 clear)
+        while (k + 8 <= len) {
+            uint64_t w;
+            memcpy(&w, str + k, 8);
+            if ((w & ~(w << 1) & 0x8080808080808080ull) != 0) break;
+            k += 8;
+        }
+        if (k >= len) break;
+        if (((unsigned char)str[k] & 0xC0) != 0x80) continue;
+        size_t run = k;
+        while (run < len && ((unsigned char)str[run] & 0xC0) == 0x80) run++;
+        if (run == len) break;
+        unsigned char lead = (unsigned char)str[run];
+        size_t expected = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+        if (expected != 0 && run - k == expected) {
+            for (size_t a = k, b = run; a < b; a++, b--) {
+                char temp = str[a];
+                str[a] = str[b];
+                str[b] = temp;
+            }
+        }
+        k = run;
+    }
+}
+
+void reverse_string(char* str) {
+    if (str == NULL) return;
+    reverse_string_n(str, strlen(str));
 }
 
 int string_length(const char* str) {
-    return str ? strlen(str) : 0;
+    return str ? (int)strlen(str) : 0;
 }
 
 char* string_concat(const char* str1, const char* str2) {
@@ -116,8 +981,8 @@ char* string_concat(const char* str1, const char* str2) {
     size_t len2 = strlen(str2);
     char* result = (char*)safe_malloc(len1 + len2 + 1);
     
-    strcpy(result, str1);
-    strcat(result, str2);
+    memcpy(result, str1, len1);
+    memcpy(result + len1, str2, len2 + 1);
     return result;
 }
 
@@ -127,96 +992,816 @@ bool string_equals(const char* str1, const char* str2) {
     return strcmp(str1, str2) == 0;
 }
 
+void string_to_upper_n(char* str, size_t len) {
+    if (str) string_kernels_for_level()->change_case(str, len, 'a', 0x20);
+}
+
+void string_to_lower_n(char* str, size_t len) {
+    if (str) string_kernels_for_level()->change_case(str, len, 'A', 0x20);
+}
+
 char* string_to_upper(char* str) {
     if (!str) return NULL;
-    for (int i = 0; str[i]; i++) {
-        str[i] = toupper((unsigned char)str[i]);
-    }
+    string_to_upper_n(str, strlen(str));
     return str;
 }
 
 char* string_to_lower(char* str) {
     if (!str) return NULL;
-    for (int i = 0; str[i]; i++) {
-        str[i] = tolower((unsigned char)str[i]);
-    }
+    string_to_lower_n(str, strlen(str));
     return str;
 }
 
+size_t count_vowels_n(const char* str, size_t len) {
+    return str ? string_kernels_for_level()->vowels(str, len) : 0;
+}
+
 int count_vowels(const char* str) {
-    if (!str) return 0;
-    int count = 0;
-    for (int i = 0; str[i]; i++) {
-        char c = tolower((unsigned char)str[i]);
-        if (c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u') {
-            count++;
-        }
-    }
-    return count;
+    return str ? (int)count_vowels_n(str, strlen(str)) : 0;
+}
+
+size_t count_words_n(const char* str, size_t len) {
+    return str ? string_kernels_for_level()->word_starts(str, len, true) : 0;
 }
 
 int count_words(const char* str) {
-    if (!str) return 0;
-    int count = 0;
-    bool in_word = false;
-    
-    for (int i = 0; str[i]; i++) {
-        if (isspace((unsigned char)str[i])) {
-            in_word = false;
-        } else if (!in_word) {
-            in_word = true;
-            count++;
-        }
-    }
-    return count;
+    return str ? (int)count_words_n(str, strlen(str)) : 0;
 }
 
 // ============ Array Utilities ============
 
-int sum_array(const int* arr, size_t size) {
-    if (!arr) return 0;
-    int sum = 0;
+// Reduction kernels. Each exists in a scalar, SSE2, AVX2 and AVX-512
+// flavour; the vector ones handle whole vectors and leave the tail to the
+// scalar one. Sums widen every lane to 64 bits, so they cannot overflow
+// for any array smaller than 2^32 elements. Callers pass size > 0.
+
+typedef struct {
+    long long (*sum)(const int* arr, size_t size);
+    void (*min_max)(const int* arr, size_t size, int* min, int* max);
+    void (*stats)(const int* arr, size_t size, array_stats_t* out);
+    void (*power)(const double* bases, double* out, size_t count, unsigned int n);
+} array_kernels;
+
+static long long scalar_sum(const int* arr, size_t size) {
+    long long sum = 0;
     for (size_t i = 0; i < size; i++) {
         sum += arr[i];
     }
     return sum;
 }
 
+static void scalar_min_max(const int* arr, size_t size, int* min, int* max) {
+    int lo = *min, hi = *max;
+    for (size_t i = 0; i < size; i++) {
+        if (arr[i] < lo) lo = arr[i];
+        if (arr[i] > hi) hi = arr[i];
+    }
+    *min = lo;
+    *max = hi;
+}
+
+// Folds arr into out, which already holds a running sum/min/max
+static void scalar_stats(const int* arr, size_t size, array_stats_t* out) {
+    out->sum += scalar_sum(arr, size);
+    scalar_min_max(arr, size, &out->min, &out->max);
+}
+
+static void scalar_stats_entry(const int* arr, size_t size, array_stats_t* out) {
+    out->sum = 0;
+    out->min = out->max = arr[0];
+    scalar_stats(arr, size, out);
+}
+
+static void scalar_min_max_entry(const int* arr, size_t size, int* min, int* max) {
+    *min = *max = arr[0];
+    scalar_min_max(arr, size, min, max);
+}
+
+static void scalar_power(const double* bases, double* out, size_t count, unsigned int n) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = power_unsigned(bases[i], n);
+    }
+}
+
+#ifdef UTILS_X86
+
+// ---- SSE2 (no pminsd or pmovsxdq before SSE4.1: emulate both) ----
+
+__attribute__((target("sse2")))
+static inline __m128i sse2_min(__m128i a, __m128i b) {
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i sse2_max(__m128i a, __m128i b) {
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+}
+
+// Adds the four lanes of v, sign-extended to 64 bits, into two accumulators
+__attribute__((target("sse2")))
+static inline __m128i sse2_widen_add(__m128i acc, __m128i v) {
+    __m128i sign = _mm_srai_epi32(v, 31);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+}
+
+__attribute__((target("sse2")))
+static long long sse2_sum(const int* arr, size_t size) {
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        acc0 = sse2_widen_add(acc0, _mm_loadu_si128((const __m128i*)(arr + i)));
+        acc1 = sse2_widen_add(acc1, _mm_loadu_si128((const __m128i*)(arr + i + 4)));
+    }
+    long long lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, _mm_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + scalar_sum(arr + i, size - i);
+}
+
+__attribute__((target("sse2")))
+static void sse2_fold_min_max(__m128i lo, __m128i hi, int* min, int* max) {
+    int lows[4], highs[4];
+    _mm_storeu_si128((__m128i*)lows, lo);
+    _mm_storeu_si128((__m128i*)highs, hi);
+    for (int k = 0; k < 4; k++) {
+        if (lows[k] < *min) *min = lows[k];
+        if (highs[k] > *max) *max = highs[k];
+    }
+}
+
+__attribute__((target("sse2")))
+static void sse2_min_max(const int* arr, size_t size, int* min, int* max) {
+    *min = *max = arr[0];
+    __m128i lo = _mm_set1_epi32(arr[0]), hi = lo;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(arr + i));
+        lo = sse2_min(lo, v);
+        hi = sse2_max(hi, v);
+    }
+    sse2_fold_min_max(lo, hi, min, max);
+    scalar_min_max(arr + i, size - i, min, max);
+}
+
+__attribute__((target("sse2")))
+static void sse2_stats(const int* arr, size_t size, array_stats_t* out) {
+    __m128i lo = _mm_set1_epi32(arr[0]), hi = lo, acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(arr + i));
+        lo = sse2_min(lo, v);
+        hi = sse2_max(hi, v);
+        acc = sse2_widen_add(acc, v);
+    }
+    long long lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    out->sum = lanes[0] + lanes[1];
+    out->min = out->max = arr[0];
+    sse2_fold_min_max(lo, hi, &out->min, &out->max);
+    scalar_stats(arr + i, size - i, out);
+}
+
+// power_unsigned over a whole vector: the same double-double steps lane
+// by lane, so results match the scalar code bit for bit. Lanes that hit
+// the overflow fallback are redone by the scalar code before storing.
+#define DEFINE_POWER_KERNEL(NAME, TARGET, VEC, WIDTH, SET1, LOADU, STOREU, ADD, SUB, MUL, HAS_NAN) \
+__attribute__((target(TARGET))) \
+static void NAME(const double* bases, double* out, size_t count, unsigned int n) { \
+    const VEC splitter = SET1(DD_SPLITTER); \
+    size_t i = 0; \
+    for (; i + WIDTH <= count; i += WIDTH) { \
+        VEC xh = LOADU(bases + i), xl = SET1(0.0), rh = SET1(1.0), rl = SET1(0.0); \
+        for (unsigned int e = n; e;) { \
+            if (e & 1) POWER_DD_MUL(VEC, ADD, SUB, MUL, splitter, rh, rl, xh, xl); \
+            e >>= 1; \
+            if (e) POWER_DD_MUL(VEC, ADD, SUB, MUL, splitter, xh, xl, xh, xl); \
+        } \
+        if (HAS_NAN(rh)) { \
+            double lanes[WIDTH]; \
+            STOREU(lanes, rh); \
+            for (size_t k = 0; k < WIDTH; k++) { \
+                if (lanes[k] != lanes[k]) lanes[k] = power_unsigned(bases[i + k], n); \
+            } \
+            memcpy(out + i, lanes, sizeof(lanes)); \
+        } else { \
+            STOREU(out + i, rh); \
+        } \
+    } \
+    scalar_power(bases + i, out + i, count - i, n); \
+}
+
+// dd_mul on vectors; reads every input before writing rh and rl
+#define POWER_DD_MUL(VEC, ADD, SUB, MUL, splitter, rh, rl, xh, xl) do { \
+    VEC a_ = (rh), b_ = (xh), al_ = (rl), bl_ = (xl); \
+    VEC p_ = MUL(a_, b_); \
+    VEC ca_ = MUL(splitter, a_), ah_ = SUB(ca_, SUB(ca_, a_)), at_ = SUB(a_, ah_); \
+    VEC cb_ = MUL(splitter, b_), bh_ = SUB(cb_, SUB(cb_, b_)), bt_ = SUB(b_, bh_); \
+    VEC e_ = ADD(ADD(ADD(SUB(MUL(ah_, bh_), p_), MUL(ah_, bt_)), MUL(at_, bh_)), MUL(at_, bt_)); \
+    e_ = ADD(e_, ADD(MUL(a_, bl_), MUL(al_, b_))); \
+    (rh) = ADD(p_, e_); \
+    (rl) = SUB(e_, SUB((rh), p_)); \
+} while (0)
+
+#define SSE2_HAS_NAN(v) (_mm_movemask_pd(_mm_cmpunord_pd(v, v)) != 0)
+DEFINE_POWER_KERNEL(sse2_power, "sse2", __m128d, 2, _mm_set1_pd, _mm_loadu_pd, _mm_storeu_pd,
+                    _mm_add_pd, _mm_sub_pd, _mm_mul_pd, SSE2_HAS_NAN)
+
+// ---- AVX2 ----
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_widen_add(__m256i acc, __m256i v) {
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+
+__attribute__((target("avx2")))
+static long long avx2_horizontal_sum(__m256i acc) {
+    long long lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("avx2")))
+static void avx2_fold_min_max(__m256i lo, __m256i hi, int* min, int* max) {
+    int lows[8], highs[8];
+    _mm256_storeu_si256((__m256i*)lows, lo);
+    _mm256_storeu_si256((__m256i*)highs, hi);
+    for (int k = 0; k < 8; k++) {
+        if (lows[k] < *min) *min = lows[k];
+        if (highs[k] > *max) *max = highs[k];
+    }
+}
+
+__attribute__((target("avx2")))
+static long long avx2_sum(const int* arr, size_t size) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        acc0 = avx2_widen_add(acc0, _mm256_loadu_si256((const __m256i*)(arr + i)));
+        acc1 = avx2_widen_add(acc1, _mm256_loadu_si256((const __m256i*)(arr + i + 8)));
+    }
+    return avx2_horizontal_sum(_mm256_add_epi64(acc0, acc1)) + scalar_sum(arr + i, size - i);
+}
+
+__attribute__((target("avx2")))
+static void avx2_min_max(const int* arr, size_t size, int* min, int* max) {
+    *min = *max = arr[0];
+    __m256i lo = _mm256_set1_epi32(arr[0]), hi = lo;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(arr + i));
+        lo = _mm256_min_epi32(lo, v);
+        hi = _mm256_max_epi32(hi, v);
+    }
+    avx2_fold_min_max(lo, hi, min, max);
+    scalar_min_max(arr + i, size - i, min, max);
+}
+
+__attribute__((target("avx2")))
+static void avx2_stats(const int* arr, size_t size, array_stats_t* out) {
+    __m256i lo = _mm256_set1_epi32(arr[0]), hi = lo, acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(arr + i));
+        lo = _mm256_min_epi32(lo, v);
+        hi = _mm256_max_epi32(hi, v);
+        acc = avx2_widen_add(acc, v);
+    }
+    out->sum = avx2_horizontal_sum(acc);
+    out->min = out->max = arr[0];
+    avx2_fold_min_max(lo, hi, &out->min, &out->max);
+    scalar_stats(arr + i, size - i, out);
+}
+
+#define AVX2_HAS_NAN(v) (_mm256_movemask_pd(_mm256_cmp_pd(v, v, _CMP_UNORD_Q)) != 0)
+DEFINE_POWER_KERNEL(avx2_power, "avx2", __m256d, 4, _mm256_set1_pd, _mm256_loadu_pd, _mm256_storeu_pd,
+                    _mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, AVX2_HAS_NAN)
+
+// ---- AVX-512 (F only) ----
+// GCC 12's AVX-512 intrinsics pass _mm512_undefined_*() as the merge
+// operand, which -Wmaybe-uninitialized reports when built as C++.
+
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f")))
+static inline __m512i avx512_widen_add(__m512i acc, const int* arr) {
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*)arr)));
+    return _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*)(arr + 8))));
+}
+
+__attribute__((target("avx512f")))
+static long long avx512_horizontal_sum(__m512i acc) {
+    long long lanes[8];
+    _mm512_storeu_si512(lanes, acc);
+    long long sum = 0;
+    for (int k = 0; k < 8; k++) sum += lanes[k];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static void avx512_fold_min_max(__m512i lo, __m512i hi, int* min, int* max) {
+    int lows[16], highs[16];
+    _mm512_storeu_si512(lows, lo);
+    _mm512_storeu_si512(highs, hi);
+    for (int k = 0; k < 16; k++) {
+        if (lows[k] < *min) *min = lows[k];
+        if (highs[k] > *max) *max = highs[k];
+    }
+}
+
+__attribute__((target("avx512f")))
+static long long avx512_sum(const int* arr, size_t size) {
+    __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        acc0 = avx512_widen_add(acc0, arr + i);
+        acc1 = avx512_widen_add(acc1, arr + i + 16);
+    }
+    return avx512_horizontal_sum(_mm512_add_epi64(acc0, acc1)) + scalar_sum(arr + i, size - i);
+}
+
+__attribute__((target("avx512f")))
+static void avx512_min_max(const int* arr, size_t size, int* min, int* max) {
+    __m512i lo = _mm512_set1_epi32(arr[0]), hi = lo;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m512i v = _mm512_loadu_si512(arr + i);
+        lo = _mm512_min_epi32(lo, v);
+        hi = _mm512_max_epi32(hi, v);
+    }
+    *min = *max = arr[0];
+    avx512_fold_min_max(lo, hi, min, max);
+    scalar_min_max(arr + i, size - i, min, max);
+}
+
+__attribute__((target("avx512f")))
+static void avx512_stats(const int* arr, size_t size, array_stats_t* out) {
+    __m512i lo = _mm512_set1_epi32(arr[0]), hi = lo, acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m512i v = _mm512_loadu_si512(arr + i);
+        lo = _mm512_min_epi32(lo, v);
+        hi = _mm512_max_epi32(hi, v);
+        acc = avx512_widen_add(acc, arr + i);
+    }
+    out->sum = avx512_horizontal_sum(acc);
+    out->min = out->max = arr[0];
+    avx512_fold_min_max(lo, hi, &out->min, &out->max);
+    scalar_stats(arr + i, size - i, out);
+}
+
+#define AVX512_HAS_NAN(v) (_mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q) != 0)
+DEFINE_POWER_KERNEL(avx512_power, "avx512f", __m512d, 8, _mm512_set1_pd, _mm512_loadu_pd, _mm512_storeu_pd,
+                    _mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd, AVX512_HAS_NAN)
+
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // UTILS_X86
+
+static const array_kernels kernel_table[] = {
+    {scalar_sum, scalar_min_max_entry, scalar_stats_entry, scalar_power},
+#ifdef UTILS_X86
+    {sse2_sum, sse2_min_max, sse2_stats, sse2_power},
+    {avx2_sum, avx2_min_max, avx2_stats, avx2_power},
+    {avx512_sum, avx512_min_max, avx512_stats, avx512_power},
+#endif
+};
+
+static pthread_once_t simd_once = PTHREAD_ONCE_INIT;
+static array_simd_level detected_level = ARRAY_SIMD_SCALAR;
+// utils.c is also built as C++, so no <stdatomic.h>: plain int with
+// GCC atomics where available
+static int selected_level = ARRAY_SIMD_SCALAR;
+
+#if defined(__GNUC__)
+#define LEVEL_STORE(v) __atomic_store_n(&selected_level, (v), __ATOMIC_RELAXED)
+#define LEVEL_LOAD() __atomic_load_n(&selected_level, __ATOMIC_RELAXED)
+#else
+#define LEVEL_STORE(v) (selected_level = (v))
+#define LEVEL_LOAD() (selected_level)
+#endif
+
+static void detect_simd(void) {
+#ifdef UTILS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) detected_level = ARRAY_SIMD_AVX512;
+    else if (__builtin_cpu_supports("avx2")) detected_level = ARRAY_SIMD_AVX2;
+    else if (__builtin_cpu_supports("sse2")) detected_level = ARRAY_SIMD_SSE2;
+#endif
+    LEVEL_STORE((int)detected_level);
+}
+
+array_simd_level array_simd_detect(void) {
+    pthread_once(&simd_once, detect_simd);
+    return detected_level;
+}
+
+const char* array_simd_name(array_simd_level level) {
+    switch (level) {
+        case ARRAY_SIMD_AVX512: return "avx512";
+        case ARRAY_SIMD_AVX2: return "avx2";
+        case ARRAY_SIMD_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+array_simd_level array_simd_select(array_simd_level level) {
+    array_simd_level best = array_simd_detect();
+    if (level > best) level = best;
+    if (level < ARRAY_SIMD_SCALAR) level = ARRAY_SIMD_SCALAR;
+    LEVEL_STORE((int)level);
+    return level;
+}
+
+static int simd_level(void) {
+    pthread_once(&simd_once, detect_simd);
+    return LEVEL_LOAD();
+}
+
+static const array_kernels* kernels(void) {
+    return &kernel_table[simd_level()];
+}
+
+int sum_array(const int* arr, size_t size) {
+    if (!arr || size == 0) return 0;
+    // Truncating the 64-bit sum gives the same wrap-around as 32-bit adds
+    return (int)(unsigned int)kernels()->sum(arr, size);
+}
+
+long long sum_array_long(const int* arr, size_t size) {
+    if (!arr || size == 0) return 0;
+    return kernels()->sum(arr, size);
+}
+
 double average_array(const int* arr, size_t size) {
     if (!arr || size == 0) return 0.0;
-    return (double)sum_array(arr, size) / size;
+    return (double)kernels()->sum(arr, size) / size;
 }
 
 int find_max(const int* arr, size_t size) {
     if (!arr || size == 0) return 0;
-    int max = arr[0];
-    for (size_t i = 1; i < size; i++) {
-        if (arr[i] > max) max = arr[i];
-    }
+    int min, max;
+    kernels()->min_max(arr, size, &min, &max);
     return max;
 }
 
 int find_min(const int* arr, size_t size) {
     if (!arr || size == 0) return 0;
-    int min = arr[0];
+    int min, max;
+    kernels()->min_max(arr, size, &min, &max);
+    return min;
+}
+
+void power_array(const double* bases, double* out, size_t count, int exponent) {
+    if (!bases || !out || count == 0) return;
+    unsigned int n = exponent_magnitude(exponent);
+    const array_kernels* k = kernels();
+    if (exponent >= 0) {
+        k->power(bases, out, count, n);
+        return;
+    }
+    // The reciprocal step may need the original bases, which an in-place
+    // call has overwritten by then: keep a copy of each chunk
+    double saved[256];
+    for (size_t start = 0; start < count; start += 256) {
+        size_t chunk = count - start < 256 ? count - start : 256;
+        memcpy(saved, bases + start, chunk * sizeof(double));
+        k->power(saved, out + start, chunk, n);
+        for (size_t i = 0; i < chunk; i++) {
+            out[start + i] = power_reciprocal(saved[i], out[start + i], n);
+        }
+    }
+}
+
+array_stats_t array_stats(const int* arr, size_t size) {
+    array_stats_t stats = {0, 0, 0, 0.0};
+    if (!arr || size == 0) return stats;
+    kernels()->stats(arr, size, &stats);
+    stats.mean = (double)stats.sum / size;
+    return stats;
+}
+
+// Size cut-offs for sort_array, tuned with bench_sort
+#define SORT_INSERTION_LIMIT 24
+#define SORT_NINTHER_LIMIT 128
+#define SORT_RADIX_THRESHOLD 1024
+#define SORT_PARALLEL_THRESHOLD (1 << 17)
+#define SORT_MAX_THREADS 64
+
+static void swap_int(int* a, int* b) {
+    int temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+static void insertion_sort(int* arr, size_t size) {
     for (size_t i = 1; i < size; i++) {
-        if (arr[i] < min) min = arr[i];
+        int value = arr[i];
+        size_t j = i;
+        while (j > 0 && arr[j - 1] > value) {
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        arr[j] = value;
     }
-    return min;
+}
+
+static void sift_down(int* arr, size_t root, size_t size) {
+    int value = arr[root];
+    size_t child;
+    while ((child = 2 * root + 1) < size) {
+        if (child + 1 < size && arr[child + 1] > arr[child]) child++;
+        if (arr[child] <= value) break;
+        arr[root] = arr[child];
+        root = child;
+    }
+    arr[root] = value;
+}
+
+static void heap_sort(int* arr, size_t size) {
+    for (size_t i = size / 2; i-- > 0;) {
+        sift_down(arr, i, size);
+    }
+    for (size_t end = size - 1; end > 0; end--) {
+        swap_int(&arr[0], &arr[end]);
+        sift_down(arr, 0, end);
+    }
+}
+
+// Orders arr[a] <= arr[b] <= arr[c]
+static void sort3(int* arr, size_t a, size_t b, size_t c) {
+    if (arr[b] < arr[a]) swap_int(&arr[a], &arr[b]);
+    if (arr[c] < arr[b]) swap_int(&arr[b], &arr[c]);
+    if (arr[b] < arr[a]) swap_int(&arr[a], &arr[b]);
+}
+
+// Partitions around the pivot in arr[0]: smaller elements end up left of
+// it and equal ones right. Returns the pivot's final index.
+static size_t partition_right(int* arr, size_t size) {
+    int pivot = arr[0];
+    size_t i = 1, j = size - 1;
+    for (;;) {
+        while (i <= j && arr[i] < pivot) i++;
+        while (i <= j && arr[j] >= pivot) j--;
+        if (i > j) break;
+        swap_int(&arr[i++], &arr[j--]);
+    }
+    swap_int(&arr[0], &arr[i - 1]);
+    return i - 1;
+}
+
+// Same, but equal elements go left. Used when the pivot equals the element
+// before this range: everything up to the returned index then equals the
+// pivot and needs no further sorting, so runs of duplicates cost O(n).
+static size_t partition_left(int* arr, size_t size) {
+    int pivot = arr[0];
+    size_t i = 1, j = size - 1;
+    for (;;) {
+        while (i <= j && arr[i] <= pivot) i++;
+        while (i <= j && arr[j] > pivot) j--;
+        if (i > j) break;
+        swap_int(&arr[i++], &arr[j--]);
+    }
+    swap_int(&arr[0], &arr[i - 1]);
+    return i - 1;
+}
+
+// Introsort with pattern-defeating touches: median-of-3 (ninther on larger
+// ranges) pivots, the equal-elements partition above, and heapsort once
+// the recursion depth says the pivots have been bad
+static void introsort(int* arr, size_t size, int depth, bool leftmost) {
+    while (size > SORT_INSERTION_LIMIT) {
+        if (depth-- == 0) {
+            heap_sort(arr, size);
+            return;
+        }
+
+        size_t mid = size / 2;
+        if (size > SORT_NINTHER_LIMIT) {
+            sort3(arr, 0, mid, size - 1);
+            sort3(arr, 1, mid - 1, size - 2);
+            sort3(arr, 2, mid + 1, size - 3);
+            sort3(arr, mid - 1, mid, mid + 1);
+        } else {
+            sort3(arr, 0, mid, size - 1);
+        }
+        swap_int(&arr[0], &arr[mid]);
+
+        if (!leftmost && arr[-1] >= arr[0]) {
+            size_t equal = partition_left(arr, size) + 1;
+            arr += equal;
+            size -= equal;
+            continue;
+        }
+
+        // Recurse into the smaller side and loop on the larger one
+        size_t pivot = partition_right(arr, size);
+        size_t right = size - pivot - 1;
+        if (pivot < right) {
+            introsort(arr, pivot, depth, leftmost);
+            arr += pivot + 1;
+            size = right;
+            leftmost = false;
+        } else {
+            introsort(arr + pivot + 1, right, depth, false);
+            size = pivot;
+        }
+    }
+    insertion_sort(arr, size);
+}
+
+// LSD radix sort, one byte per pass, with the sign bit flipped so negative
+// numbers order first. Passes where every key shares the byte are skipped.
+// Returns false if the scratch buffer cannot be allocated.
+static bool radix_sort(int* arr, size_t size) {
+    unsigned int* scratch = (unsigned int*)malloc(size * sizeof(unsigned int));
+    if (!scratch) return false;
+
+    size_t counts[4][256];
+    memset(counts, 0, sizeof(counts));
+    unsigned int* keys = (unsigned int*)arr;
+    for (size_t i = 0; i < size; i++) {
+        unsigned int key = keys[i] ^ 0x80000000u;
+        counts[0][key & 0xFF]++;
+        counts[1][(key >> 8) & 0xFF]++;
+        counts[2][(key >> 16) & 0xFF]++;
+        counts[3][key >> 24]++;
+    }
+
+    unsigned int* src = keys;
+    unsigned int* dst = scratch;
+    for (int pass = 0; pass < 4; pass++) {
+        int shift = pass * 8;
+        size_t* count = counts[pass];
+        if (count[((src[0] ^ 0x80000000u) >> shift) & 0xFF] == size) continue;
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            size_t n = count[digit];
+            count[digit] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < size; i++) {
+            unsigned int value = src[i];
+            dst[count[((value ^ 0x80000000u) >> shift) & 0xFF]++] = value;
+        }
+        unsigned int* temp = src;
+        src = dst;
+        dst = temp;
+    }
+    if (src != keys) {
+        memcpy(keys, src, size * sizeof(unsigned int));
+    }
+    free(scratch);
+    return true;
+}
+
+// Handles sorted and reversed input in a single pass; returns true if done
+static bool sort_monotonic(int* arr, size_t size) {
+    size_t i = 1;
+    while (i < size && arr[i - 1] <= arr[i]) i++;
+    if (i == size) return true;
+    if (i > 1) return false;
+    while (i < size && arr[i - 1] > arr[i]) i++;
+    if (i < size) return false;
+    reverse_array(arr, size);
+    return true;
 }
 
 void sort_array(int* arr, size_t size) {
     if (!arr || size <= 1) return;
     
-    for (size_t i = 0; i < size - 1; i++) {
-        for (size_t j = 0; j < size - i - 1; j++) {
-            if (arr[j] > arr[j + 1]) {
-                int temp = arr[j];
-                arr[j] = arr[j + 1];
-                arr[j + 1] = temp;
-            }
+    if (size <= SORT_INSERTION_LIMIT) {
+        insertion_sort(arr, size);
+        return;
+    }
+    if (sort_monotonic(arr, size)) return;
+    if (size >= SORT_RADIX_THRESHOLD && radix_sort(arr, size)) return;
+
+    int depth = 0;
+    for (size_t n = size; n > 1; n >>= 1) depth += 2;
+    introsort(arr, size, depth, true);
+}
+
+typedef struct {
+    int* arr;
+    size_t size;
+} sort_job;
+
+typedef struct {
+    const int* left;
+    size_t left_size;
+    const int* right;
+    size_t right_size;
+    int* out;
+} merge_job;
+
+static void* sort_worker(void* arg) {
+    sort_job* job = (sort_job*)arg;
+    sort_array(job->arr, job->size);
+    return NULL;
+}
+
+static void* merge_worker(void* arg) {
+    merge_job* job = (merge_job*)arg;
+    const int* left = job->left;
+    const int* left_end = left + job->left_size;
+    const int* right = job->right;
+    const int* right_end = right + job->right_size;
+    int* out = job->out;
+    while (left < left_end && right < right_end) {
+        *out++ = *right < *left ? *right++ : *left++;
+    }
+    memcpy(out, left, (size_t)(left_end - left) * sizeof(int));
+    out += left_end - left;
+    memcpy(out, right, (size_t)(right_end - right) * sizeof(int));
+    return NULL;
+}
+
+static int cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// Runs fn over every job, one thread each except the last, which runs on
+// the caller (as do any whose thread cannot be started)
+static void run_jobs(void* (*fn)(void*), void* jobs, size_t job_size, int count) {
+    pthread_t threads[SORT_MAX_THREADS];
+    bool started[SORT_MAX_THREADS];
+    for (int i = 0; i < count; i++) {
+        void* job = (char*)jobs + (size_t)i * job_size;
+        started[i] = i < count - 1 && pthread_create(&threads[i], NULL, fn, job) == 0;
+        if (!started[i]) fn(job);
+    }
+    for (int i = 0; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+void sort_array_parallel(int* arr, size_t size, int threads) {
+    if (threads <= 0) threads = cpu_count();
+    if (threads > SORT_MAX_THREADS) threads = SORT_MAX_THREADS;
+    if (!arr || threads <= 1 || size < SORT_PARALLEL_THRESHOLD) {
+        sort_array(arr, size);
+        return;
+    }
+    if (sort_monotonic(arr, size)) return;
+    int* scratch = (int*)malloc(size * sizeof(int));
+    if (!scratch) {
+        sort_array(arr, size);
+        return;
+    }
+
+    size_t bounds[SORT_MAX_THREADS + 1];
+    sort_job sorts[SORT_MAX_THREADS];
+    for (int i = 0; i <= threads; i++) {
+        bounds[i] = size / (size_t)threads * (size_t)i + size % (size_t)threads * (size_t)i / (size_t)threads;
+    }
+    for (int i = 0; i < threads; i++) {
+        sorts[i].arr = arr + bounds[i];
+        sorts[i].size = bounds[i + 1] - bounds[i];
+    }
+    run_jobs(sort_worker, sorts, sizeof(sort_job), threads);
+
+    // Merge neighbouring runs pairwise, ping-ponging between the buffers
+    int* src = arr;
+    int* dst = scratch;
+    merge_job merges[SORT_MAX_THREADS];
+    for (int width = 1; width < threads; width *= 2) {
+        int count = 0;
+        for (int first = 0; first < threads; first += 2 * width) {
+            int middle = first + width < threads ? first + width : threads;
+            int last = first + 2 * width < threads ? first + 2 * width : threads;
+            merge_job* job = &merges[count++];
+            job->left = src + bounds[first];
+            job->left_size = bounds[middle] - bounds[first];
+            job->right = src + bounds[middle];
+            job->right_size = bounds[last] - bounds[middle];
+            job->out = dst + bounds[first];
         }
+        run_jobs(merge_worker, merges, sizeof(merge_job), count);
+        int* temp = src;
+        src = dst;
+        dst = temp;
+    }
+    if (src != arr) {
+        memcpy(arr, src, size * sizeof(int));
     }
+    free(scratch);
 }
 
 int binary_search(const int* arr, size_t size, int target) {
@@ -271,3 +1856,190 @@ void safe_free(void** ptr) {
         *ptr = NULL;
     }
 }
+
+// ============ Arena and Pool Allocators ============
+
+#define ARENA_DEFAULT_BLOCK (64 * 1024)
+#define ARENA_ALIGNMENT 16
+
+struct arena_block {
+    struct arena_block* next;
+    size_t size;
+};
+
+// Block payloads start 16-byte aligned, like malloc'd memory
+#define ARENA_HEADER \
+    ((sizeof(struct arena_block) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static char* arena_payload(struct arena_block* block) {
+    return (char*)block + ARENA_HEADER;
+}
+
+static void arena_overflow(size_t num, size_t size) {
+    fprintf(stderr, "Memory allocation failed for %zu elements of %zu bytes\n", num, size);
+    exit(EXIT_FAILURE);
+}
+
+static struct arena_block* arena_new_block(size_t size) {
+    if (size > SIZE_MAX - ARENA_HEADER) arena_overflow(1, size);
+    struct arena_block* block = (struct arena_block*)safe_malloc(ARENA_HEADER + size);
+    block->next = NULL;
+    block->size = size;
+    return block;
+}
+
+static void arena_free_chain(struct arena_block* block) {
+    while (block) {
+        struct arena_block* next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+void arena_init(arena_t* arena, size_t block_size) {
+    memset(arena, 0, sizeof(*arena));
+    arena->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK;
+}
+
+// Moves to the next regular block, reusing one kept by arena_reset if any
+static void arena_next_block(arena_t* arena) {
+    struct arena_block* next = arena->current ? arena->current->next : arena->first;
+    if (!next) {
+        next = arena_new_block(arena->block_size);
+        if (arena->current) {
+            arena->current->next = next;
+        } else {
+            arena->first = next;
+        }
+    }
+    arena->current = next;
+    arena->cursor = arena_payload(next);
+    arena->end = arena->cursor + next->size;
+}
+
+void* arena_alloc_aligned(arena_t* arena, size_t size, size_t alignment) {
+    if (alignment == 0) alignment = ARENA_ALIGNMENT;
+    if (arena->block_size == 0) arena->block_size = ARENA_DEFAULT_BLOCK;
+    
+    if (arena->cursor) {
+        size_t padding = (size_t)(-(uintptr_t)arena->cursor & (alignment - 1));
+        if (padding <= (size_t)(arena->end - arena->cursor) &&
+            size <= (size_t)(arena->end - arena->cursor) - padding) {
+            char* result = arena->cursor + padding;
+            arena->cursor = result + size;
+            arena->used += padding + size;
+            return result;
+        }
+    }
+    
+    if (size > SIZE_MAX - alignment) arena_overflow(1, size);
+    if (size + alignment > arena->block_size / 4) {
+        // Oversized requests get a block of their own so the current one
+        // keeps its free space
+        struct arena_block* block = arena_new_block(size + alignment);
+        block->next = arena->large;
+        arena->large = block;
+        char* payload = arena_payload(block);
+        arena->used += size;
+        return payload + (size_t)(-(uintptr_t)payload & (alignment - 1));
+    }
+    
+    arena_next_block(arena);
+    return arena_alloc_aligned(arena, size, alignment);
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+    return arena_alloc_aligned(arena, size, ARENA_ALIGNMENT);
+}
+
+void* arena_calloc(arena_t* arena, size_t num, size_t size) {
+    if (size && num > SIZE_MAX / size) arena_overflow(num, size);
+    void* ptr = arena_alloc(arena, num * size);
+    memset(ptr, 0, num * size);
+    return ptr;
+}
+
+char* arena_strdup(arena_t* arena, const char* str) {
+    if (!str) return NULL;
+    size_t len = strlen(str) + 1;
+    return (char*)memcpy(arena_alloc_aligned(arena, len, 1), str, len);
+}
+
+char* arena_concat(arena_t* arena, const char* str1, const char* str2) {
+    if (!str1 && !str2) return NULL;
+    size_t len1 = str1 ? strlen(str1) : 0;
+    size_t len2 = str2 ? strlen(str2) : 0;
+    char* result = (char*)arena_alloc_aligned(arena, len1 + len2 + 1, 1);
+    if (len1) memcpy(result, str1, len1);
+    if (len2) memcpy(result + len1, str2, len2);
+    result[len1 + len2] = '\0';
+    return result;
+}
+
+size_t arena_bytes_used(const arena_t* arena) {
+    return arena->used;
+}
+
+void arena_reset(arena_t* arena) {
+    arena_free_chain(arena->large);
+    arena->large = NULL;
+    arena->current = arena->first;
+    arena->cursor = arena->first ? arena_payload(arena->first) : NULL;
+    arena->end = arena->first ? arena->cursor + arena->first->size : NULL;
+    arena->used = 0;
+}
+
+void arena_destroy(arena_t* arena) {
+    arena_free_chain(arena->large);
+    arena_free_chain(arena->first);
+    arena_init(arena, arena->block_size);
+}
+
+void pool_init(pool_t* pool, size_t object_size, size_t objects_per_block) {
+    // Every free object holds the free-list link
+    size_t word = sizeof(void*);
+    if (object_size < word) object_size = word;
+    object_size = (object_size + word - 1) / word * word;
+    if (objects_per_block == 0) objects_per_block = 256;
+    if (object_size > SIZE_MAX / objects_per_block) arena_overflow(objects_per_block, object_size);
+    
+    arena_init(&pool->arena, object_size * objects_per_block);
+    pool->free_list = NULL;
+    pool->object_size = object_size;
+    pool->alignment = object_size % ARENA_ALIGNMENT == 0 ? ARENA_ALIGNMENT : word;
+    pool->live = 0;
+}
+
+void* pool_alloc(pool_t* pool) {
+    void* object = pool->free_list;
+    if (object) {
+        memcpy(&pool->free_list, object, sizeof(void*));
+    } else {
+        object = arena_alloc_aligned(&pool->arena, pool->object_size, pool->alignment);
+    }
+    pool->live++;
+    return object;
+}
+
+void pool_free(pool_t* pool, void* object) {
+    if (!object) return;
+    memcpy(object, &pool->free_list, sizeof(void*));
+    pool->free_list = object;
+    pool->live--;
+}
+
+size_t pool_live(const pool_t* pool) {
+    return pool->live;
+}
+
+void pool_reset(pool_t* pool) {
+    arena_reset(&pool->arena);
+    pool->free_list = NULL;
+    pool->live = 0;
+}
+
+void pool_destroy(pool_t* pool) {
+    arena_destroy(&pool->arena);
+    pool->free_list = NULL;
+    pool->live = 0;
+}
@@ -0,0 +1,141 @@
+#include "work_stealing.h"
+
+// ============ WorkStealingScheduler Implementation ============
+
+WorkStealingScheduler::WorkStealingScheduler(size_t workerCount, size_t starvationLimit)
+    : starvationLimit(starvationLimit), currentJob(nullptr), generation(0),
+      idleWorkers(workerCount), stopping(false) {
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(new Worker());
+        workers.back()->victimSeed = static_cast<uint32_t>(i * 2654435761u + 1);
+    }
+    threads.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++) {
+        threads.emplace_back(&WorkStealingScheduler::workerLoop, this, i);
+    }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(runMutex);
+        stopping = true;
+    }
+    runReady.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+size_t WorkStealingScheduler::getWorkerCount() const {
+    return workers.size();
+}
+
+void WorkStealingScheduler::run(const std::array<std::vector<Task*>, kPriorityLevels>& bands,
+                                const JobFunction& job) {
+    if (workers.empty()) {
+        for (size_t band = kPriorityLevels; band-- > 0;) {
+            for (Task* task : bands[band]) job(task, 0);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(runMutex);
+
+    // Workers are parked on runMutex, so dealing into their deques from here
+    // is ordered before their next pop or steal
+    size_t next = 0;
+    size_t total = 0;
+    for (size_t band = kPriorityLevels; band-- > 0;) {
+        for (Task* task : bands[band]) {
+            workers[next]->bands[band].push(task);
+            next = (next + 1) % workers.size();
+            total++;
+        }
+    }
+    if (total == 0) {
+        return;
+    }
+
+    currentJob = &job;
+    idleWorkers = 0;
+    generation++;
+    runReady.notify_all();
+    runDone.wait(lock, [this] { return idleWorkers == workers.size(); });
+    currentJob = nullptr;
+}
+
+bool WorkStealingScheduler::stealFrom(size_t self, size_t band, Task*& task) {
+    Worker& me = *workers[self];
+    size_t count = workers.size();
+
+    // xorshift32 picks where to start so thieves spread over victims
+    me.victimSeed ^= me.victimSeed << 13;
+    me.victimSeed ^= me.victimSeed >> 17;
+    me.victimSeed ^= me.victimSeed << 5;
+    size_t start = me.victimSeed % count;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t victim = (start + i) % count;
+        if (victim == self) continue;
+
+        auto& deque = workers[victim]->bands[band];
+        while (true) {
+            auto result = deque.steal(task);
+            if (result == ChaseLevDeque<Task*>::StealResult::SUCCESS) return true;
+            if (result == ChaseLevDeque<Task*>::StealResult::EMPTY) break;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingScheduler::findJob(size_t self, Task*& task) {
+    Worker& me = *workers[self];
+
+    if (starvationLimit > 0 && me.sinceLowerBand >= starvationLimit) {
+        for (size_t band = 0; band < kPriorityLevels; band++) {
+            if (me.bands[band].pop(task)) {
+                me.sinceLowerBand = 0;
+                return true;
+            }
+        }
+    }
+
+    for (size_t band = kPriorityLevels; band-- > 0;) {
+        if (me.bands[band].pop(task) || stealFrom(self, band, task)) {
+            bool lowerQueued = false;
+            for (size_t lower = 0; lower < band; lower++) {
+                lowerQueued = lowerQueued || !me.bands[lower].empty();
+            }
+            me.sinceLowerBand = lowerQueued ? me.sinceLowerBand + 1 : 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every job of a run is dealt out before the workers wake, so a worker that
+// finds all deques empty is done: its own deque can only lose items.
+void WorkStealingScheduler::workerLoop(size_t self) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(runMutex);
+    while (true) {
+        runReady.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        const JobFunction& job = *currentJob;
+        lock.unlock();
+
+        Task* task;
+        while (findJob(self, task)) {
+            job(task, self);
+        }
+
+        lock.lock();
+        if (++idleWorkers == workers.size()) {
+            runDone.notify_all();
+        }
+    }
+}
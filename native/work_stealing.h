@@ -0,0 +1,176 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include "task_processor.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). The owning worker pushes and pops
+// at the bottom; any other thread may steal from the top. T must be
+// trivially copyable (task pointers in practice).
+template <typename T>
+class ChaseLevDeque {
+public:
+    enum class StealResult { SUCCESS, EMPTY, ABORT };
+
+    explicit ChaseLevDeque(size_t capacity = 64)
+        : top(0), bottom(0) {
+        size_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+        retired.emplace_back(new Ring(rounded));
+        ring.store(retired.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // Owner only
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(r->mask)) {
+            r = grow(r, t, b);
+        }
+        r->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only
+    bool pop(T& out) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = r->get(b);
+        if (t == b) {
+            // Last element: race any thief for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread
+    StealResult steal(T& out) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return StealResult::EMPTY;
+        }
+        Ring* r = ring.load(std::memory_order_acquire);
+        T item = r->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return StealResult::ABORT;
+        }
+        out = item;
+        return StealResult::SUCCESS;
+    }
+
+    // Approximate when other threads are active
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Ring {
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+
+        explicit Ring(size_t capacity)
+            : mask(capacity - 1), items(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t i) const {
+            return items[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t i, T item) {
+            items[static_cast<size_t>(i) & mask].store(item, std::memory_order_relaxed);
+        }
+    };
+
+    // Thieves may still be reading the old ring, so it is retired rather
+    // than freed; retired rings live as long as the deque.
+    Ring* grow(Ring* old, int64_t t, int64_t b) {
+        retired.emplace_back(new Ring((old->mask + 1) * 2));
+        Ring* bigger = retired.back().get();
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, old->get(i));
+        }
+        ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Ring*> ring;
+    std::vector<std::unique_ptr<Ring>> retired;
+};
+
+// Runs batches of tasks on a fixed set of workers, each owning one
+// Chase-Lev deque per priority band. A worker serves the highest band it can
+// find, first from its own deque and then by stealing from peers, so lower
+// bands only run once every higher band looked empty. To bound starvation,
+// after `starvationLimit` consecutive higher-band jobs while its own lower
+// bands hold work, a worker runs one job from its lowest non-empty band
+// (0 disables this and keeps ordering as strict as stealing allows).
+class WorkStealingScheduler {
+public:
+    using JobFunction = std::function<void(Task* task, size_t worker)>;
+
+    WorkStealingScheduler(size_t workerCount, size_t starvationLimit = 64);
+    ~WorkStealingScheduler();
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    // Deals each band round-robin across the workers and blocks until every
+    // job has run. `job` receives the index of the worker running it.
+    void run(const std::array<std::vector<Task*>, kPriorityLevels>& bands,
+             const JobFunction& job);
+
+    size_t getWorkerCount() const;
+
+private:
+    struct alignas(64) Worker {
+        std::array<ChaseLevDeque<Task*>, kPriorityLevels> bands;
+        size_t sinceLowerBand = 0;
+        uint32_t victimSeed = 0;
+    };
+
+    bool findJob(size_t self, Task*& task);
+    bool stealFrom(size_t self, size_t band, Task*& task);
+    void workerLoop(size_t self);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    size_t starvationLimit;
+
+    std::mutex runMutex;
+    std::condition_variable runReady;
+    std::condition_variable runDone;
+    const JobFunction* currentJob;
+    uint64_t generation;
+    size_t idleWorkers;
+    bool stopping;
+};
+
+#endif // WORK_STEALING_H